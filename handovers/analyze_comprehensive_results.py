@@ -10,6 +10,7 @@ import matplotlib.pyplot as plt
 import seaborn as sns
 from pathlib import Path
 import argparse
+import json
 import warnings
 
 warnings.filterwarnings('ignore')
@@ -434,6 +435,65 @@ class HandoverAnalyzer:
         plt.savefig('throughput_analysis.png', dpi=300, bbox_inches='tight')
         plt.show()
     
+    def analyze_ue_state(self):
+        """Serving-cell class and RRC state over time from the UE state matrix"""
+        schema_path = self.data_dir / 'comprehensive_ue_state.schema.json'
+        if not schema_path.exists():
+            print("UE state snapshot not available")
+            return
+        
+        with open(schema_path) as f:
+            schema = json.load(f)
+        dtype = np.dtype([(field['name'], field['dtype'], tuple(field.get('shape', ())))
+                          for field in schema['fields']])
+        rows = np.memmap(self.data_dir / schema['file'], dtype=dtype, mode='r')
+        if len(rows) == 0:
+            print("UE state snapshot is empty")
+            return
+        
+        print("\n" + "="*50)
+        print("UE STATE ANALYSIS")
+        print("="*50)
+        
+        # Map cell IDs to their class once; every query is then array slicing
+        cell_types = schema['cellTypes']
+        classes = ['LEGITIMATE', 'FAULTY', 'FAKE']
+        lookup = np.full(max([int(c) for c in cell_types] + [0]) + 1, -1)
+        for cell, cell_type in cell_types.items():
+            lookup[int(cell)] = classes.index(cell_type)
+        served_class = lookup[rows['servingCellId']]     # time x UE
+        time = rows['time']
+        
+        print(f"\n{len(rows)} snapshots of {schema['numUes']} UEs every {schema['intervalSeconds']} s")
+        for i, name in enumerate(classes):
+            fraction = (served_class == i).mean(axis=1)
+            print(f"  Served by {name}: mean {fraction.mean() * 100:.1f}%, peak {fraction.max() * 100:.1f}%")
+        in_handover = (rows['rrcState'] == 2).mean(axis=1)
+        print(f"  In handover: mean {in_handover.mean() * 100:.2f}% of UEs")
+        
+        plt.figure(figsize=(12, 6))
+        
+        plt.subplot(1, 2, 1)
+        for i, name in enumerate(classes):
+            plt.plot(time, (served_class == i).mean(axis=1) * 100, label=name)
+        plt.xlabel('Time (s)')
+        plt.ylabel('UEs served (%)')
+        plt.title('Serving Cell Class over Time')
+        plt.legend()
+        plt.grid(True, alpha=0.3)
+        
+        plt.subplot(1, 2, 2)
+        rate = rows['intervalBytes'].sum(axis=1) * 8 / schema['intervalSeconds'] / 1e6
+        plt.plot(time, rate)
+        plt.xlabel('Time (s)')
+        plt.ylabel('Downlink (Mbps)')
+        plt.title('Aggregate UE Downlink')
+        plt.grid(True, alpha=0.3)
+        
+        plt.tight_layout()
+        plt.savefig('ue_state_analysis.png', dpi=300, bbox_inches='tight')
+        plt.show()
+    
     def generate_summary_report(self):
         """Generate a comprehensive summary report"""
         print("\n" + "="*70)
@@ -452,6 +512,7 @@ class HandoverAnalyzer:
         self.analyze_signal_quality()
         self.analyze_security_events()
         self.analyze_throughput()
+        self.analyze_ue_state()
         
         print(f"\n" + "="*70)
         print("ANALYSIS COMPLETE - Check generated PNG files for visualizations")
@@ -462,7 +523,7 @@ def main():
     parser.add_argument('--data-dir', default='.', 
                        help='Directory containing CSV files (default: current directory)')
     parser.add_argument('--analysis', choices=['all', 'base_stations', 'mobility', 'handover', 
-                                              'signal', 'security', 'throughput'], 
+                                              'signal', 'security', 'throughput', 'ue_state'], 
                        default='all', help='Type of analysis to perform')
     
     args = parser.parse_args()
@@ -483,6 +544,8 @@ def main():
         analyzer.analyze_security_events()
     elif args.analysis == 'throughput':
         analyzer.analyze_throughput()
+    elif args.analysis == 'ue_state':
+        analyzer.analyze_ue_state()
 
 if __name__ == "__main__":
     main()
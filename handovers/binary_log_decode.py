@@ -0,0 +1,128 @@
+#!/usr/bin/env python3
+"""
+Binary log decoder
+Renders the records written with --enableLogs=1 --logFormat=binary
+(handover_log.bin / comprehensive_log.bin) back into text log lines:
+
+    +<time>s [<LEVEL>] <Component>:<Function>(): <message>
+
+Records can be filtered by component, level and time window, or summarized
+per format (log call site) to see which calls dominate the volume.
+"""
+
+import argparse
+import sys
+from collections import Counter
+
+MAGIC = b'NS3BLOG1'
+ARGUMENT = '\x01'
+LEVELS = ['', 'ERROR', 'WARN', 'DEBUG', 'INFO', 'FUNCT', 'LOGIC']
+
+
+class Reader:
+    def __init__(self, data):
+        self.data = data
+        self.pos = 0
+
+    def byte(self):
+        value = self.data[self.pos]
+        self.pos += 1
+        return value
+
+    def varint(self):
+        value, shift = 0, 0
+        while True:
+            b = self.byte()
+            value |= (b & 0x7f) << shift
+            if b < 0x80:
+                return value
+            shift += 7
+
+    def text(self):
+        length = self.varint()
+        value = self.data[self.pos:self.pos + length].decode('utf-8', errors='replace')
+        self.pos += length
+        return value
+
+
+def records(path):
+    """Yields (time ns, component, level, format, args) per log record."""
+    with open(path, 'rb') as f:
+        data = f.read()
+    if not data.startswith(MAGIC):
+        sys.exit(f"{path}: not a binary log (bad magic)")
+    reader = Reader(data)
+    reader.pos = len(MAGIC)
+    components = {0: ''}
+    formats = {}
+    time_ns = 0
+    try:
+        while reader.pos < len(data):
+            kind = chr(reader.byte())
+            if kind == 'C':
+                ident = reader.varint()
+                components[ident] = reader.text()
+            elif kind == 'F':
+                ident = reader.varint()
+                formats[ident] = reader.text()
+            elif kind == 'R':
+                component = components[reader.varint()]
+                level = reader.byte()
+                delta = reader.varint()
+                time_ns += (delta >> 1) ^ -(delta & 1)
+                fmt = formats[reader.varint()]
+                args = [reader.varint() for _ in range(fmt.count(ARGUMENT))]
+                yield time_ns, component, level, fmt, args
+            else:
+                sys.exit(f"{path}: unknown record type {kind!r} at offset {reader.pos - 1}")
+    except IndexError:
+        print(f"{path}: truncated final record ignored", file=sys.stderr)
+
+
+def render(component, fmt, args):
+    parts = fmt.split(ARGUMENT)
+    text = parts[0] + ''.join(str(arg) + part for arg, part in zip(args, parts[1:]))
+    return f"{component}:{text}" if component else text
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Decode binary NS_LOG records to text')
+    parser.add_argument('log', help='Binary log file (handover_log.bin / comprehensive_log.bin)')
+    parser.add_argument('--component', default='', help='Only these components (comma-separated)')
+    parser.add_argument('--level', default='', help='Only these levels, e.g. INFO,WARN')
+    parser.add_argument('--start', type=float, default=0.0, help='Window start (s)')
+    parser.add_argument('--end', type=float, default=float('inf'), help='Window end (s)')
+    parser.add_argument('--summary', action='store_true', help='Record counts per component and format instead of text')
+    args = parser.parse_args()
+
+    components = set(c for c in args.component.split(',') if c)
+    levels = set(l.strip().upper() for l in args.level.split(',') if l)
+    counts = Counter()
+    try:
+        for time_ns, component, level, fmt, values in records(args.log):
+            seconds = time_ns * 1e-9
+            if seconds < args.start or seconds > args.end:
+                continue
+            if components and component not in components:
+                continue
+            level_name = LEVELS[level] if level < len(LEVELS) else str(level)
+            if levels and level_name not in levels:
+                continue
+            if args.summary:
+                counts[(component, fmt)] += 1
+                continue
+            label = f"[{level_name:<5}] " if level_name else ''
+            print(f"+{seconds:.9f}s {label}{render(component, fmt, values)}")
+    except BrokenPipeError:
+        return
+
+    if args.summary:
+        total = sum(counts.values())
+        print(f"{total} records, {len(counts)} formats")
+        for (component, fmt), count in counts.most_common():
+            site = render(component, fmt, ['{}'] * fmt.count(ARGUMENT))
+            print(f"{count:>10} {100.0 * count / total:5.1f}%  {site}")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,183 @@
+// Batched UDP source: one event per aggregation boundary for a whole UE group.
+#ifndef HANDOVERS_COMMON_BATCHED_UDP_SOURCE_H
+#define HANDOVERS_COMMON_BATCHED_UDP_SOURCE_H
+
+#include "ns3/applications-module.h"
+#include "ns3/core-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/network-module.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace ns3
+{
+
+// ---------------------------------------------------------------------------
+// Batched UDP traffic source
+//
+// A UdpClient schedules one event per packet and UE. BatchedUdpSource carries
+// the constant-rate flows of a whole UE group (the UEs sharded to one remote
+// host, or one UE's uplink) and wakes up once per aggregation boundary, sending
+// every packet that falls due before the next boundary in one go. Boundaries
+// without due packets are skipped. Packets keep the UdpClient format, a
+// SeqTsHeader with a per-flow sequence number stamped at the actual send time,
+// so UdpServer loss and delay statistics stay valid.
+// ---------------------------------------------------------------------------
+inline uint64_t g_trafficBatches = 0;  // Send events of all batched sources
+inline uint64_t g_trafficPackets = 0;  // Packets sent by them
+
+class BatchedUdpSource : public Application
+{
+public:
+  BatchedUdpSource();
+  ~BatchedUdpSource() override;
+
+  static TypeId GetTypeId();
+
+  // Send maxPackets packets of packetSize bytes (including the 12-byte
+  // SeqTsHeader) to peer:port, one every interval from the application start
+  void AddFlow(Ipv4Address peer, uint16_t port, Time interval, uint32_t packetSize, uint32_t maxPackets);
+
+protected:
+  void DoDispose() override;
+
+private:
+  void StartApplication() override;
+  void StopApplication() override;
+  void SendBatch();
+
+  struct Flow
+  {
+    Ipv4Address peer;
+    uint16_t port;
+    Time interval;
+    uint32_t packetSize;
+    uint32_t maxPackets;
+    uint32_t sent;
+    Time nextDue;
+  };
+
+  Time m_batchInterval;
+  std::vector<Flow> m_flows;
+  Ptr<Socket> m_socket;
+  EventId m_sendEvent;
+};
+
+NS_OBJECT_ENSURE_REGISTERED(BatchedUdpSource);
+
+inline BatchedUdpSource::BatchedUdpSource()
+{
+}
+
+inline BatchedUdpSource::~BatchedUdpSource()
+{
+}
+
+inline TypeId
+BatchedUdpSource::GetTypeId()
+{
+  static TypeId tid =
+    TypeId("ns3::BatchedUdpSource")
+      .SetParent<Application>()
+      .SetGroupName("Applications")
+      .AddConstructor<BatchedUdpSource>()
+      .AddAttribute("BatchInterval",
+                    "Aggregation boundary spacing; all packets due before the next boundary "
+                    "are sent together (1 ms = one TTI)",
+                    TimeValue(MilliSeconds(1)),
+                    MakeTimeAccessor(&BatchedUdpSource::m_batchInterval),
+                    MakeTimeChecker(NanoSeconds(1)));
+  return tid;
+}
+
+inline void
+BatchedUdpSource::AddFlow(Ipv4Address peer, uint16_t port, Time interval, uint32_t packetSize, uint32_t maxPackets)
+{
+  Flow flow;
+  flow.peer = peer;
+  flow.port = port;
+  flow.interval = interval;
+  flow.packetSize = std::max<uint32_t>(packetSize, 12);
+  flow.maxPackets = maxPackets;
+  flow.sent = 0;
+  m_flows.push_back(flow);
+}
+
+inline void
+BatchedUdpSource::DoDispose()
+{
+  m_socket = nullptr;
+  m_flows.clear();
+  Application::DoDispose();
+}
+
+inline void
+BatchedUdpSource::StartApplication()
+{
+  if (m_flows.empty())
+  {
+    return;  // Nothing to send; no socket and no send events
+  }
+  if (!m_socket)
+  {
+    m_socket = Socket::CreateSocket(GetNode(), UdpSocketFactory::GetTypeId());
+    m_socket->Bind();
+  }
+  for (auto& flow : m_flows)
+  {
+    flow.nextDue = Simulator::Now();
+  }
+  m_sendEvent = Simulator::ScheduleNow(&BatchedUdpSource::SendBatch, this);
+}
+
+inline void
+BatchedUdpSource::StopApplication()
+{
+  Simulator::Cancel(m_sendEvent);
+  if (m_socket)
+  {
+    m_socket->Close();
+  }
+}
+
+inline void
+BatchedUdpSource::SendBatch()
+{
+  ++g_trafficBatches;
+  Time now = Simulator::Now();
+  Time horizon = now + m_batchInterval;
+  Time earliestDue;
+  bool pending = false;
+  for (auto& flow : m_flows)
+  {
+    while (flow.sent < flow.maxPackets && flow.nextDue < horizon)
+    {
+      SeqTsHeader seqTs;
+      seqTs.SetSeq(flow.sent);
+      Ptr<Packet> p = Create<Packet>(flow.packetSize - seqTs.GetSerializedSize());
+      p->AddHeader(seqTs);
+      m_socket->SendTo(p, 0, InetSocketAddress(flow.peer, flow.port));
+      ++flow.sent;
+      ++g_trafficPackets;
+      flow.nextDue += flow.interval;
+    }
+    if (flow.sent < flow.maxPackets && (!pending || flow.nextDue < earliestDue))
+    {
+      earliestDue = flow.nextDue;
+      pending = true;
+    }
+  }
+
+  if (pending)
+  {
+    // Wake at the last boundary at or before the earliest due packet
+    int64_t boundaries = (earliestDue - now).GetNanoSeconds() / m_batchInterval.GetNanoSeconds();
+    m_sendEvent = Simulator::Schedule(NanoSeconds(boundaries * m_batchInterval.GetNanoSeconds()),
+                                      &BatchedUdpSource::SendBatch, this);
+  }
+}
+
+} // namespace ns3
+
+#endif // HANDOVERS_COMMON_BATCHED_UDP_SOURCE_H
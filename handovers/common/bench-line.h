@@ -0,0 +1,30 @@
+// The BENCH summary line printed at the end of every run.
+#ifndef HANDOVERS_COMMON_BENCH_LINE_H
+#define HANDOVERS_COMMON_BENCH_LINE_H
+
+#include <sys/resource.h>
+
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+namespace ns3
+{
+
+// One machine-readable summary line per run, parsed by scaling_study.py and
+// sweep_runner.py. budgetExceeded names the run budget that stopped the
+// simulation early, empty for a complete run.
+inline void PrintBenchLine(const char* program, double setupS, double runS, uint64_t events, double simS,
+                           const std::string& budgetExceeded)
+{
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+  std::cout << std::defaultfloat << std::setprecision(6) << "BENCH program=" << program << " setupS=" << setupS
+            << " runS=" << runS << " wallS=" << setupS + runS << " events=" << events
+            << " peakRssMb=" << usage.ru_maxrss / 1024.0 << " simS=" << simS
+            << " truncated=" << (budgetExceeded.empty() ? "0" : budgetExceeded) << std::endl;
+}
+
+} // namespace ns3
+
+#endif // HANDOVERS_COMMON_BENCH_LINE_H
@@ -0,0 +1,247 @@
+// Binary NS_LOG backend: interned, compact log records instead of formatted text.
+#ifndef HANDOVERS_COMMON_BINARY_LOG_H
+#define HANDOVERS_COMMON_BINARY_LOG_H
+
+#include "ns3/core-module.h"
+
+#include <fstream>
+#include <map>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+namespace ns3
+{
+
+// ===== Binary log backend =====
+// With --logFormat=binary the NS_LOG output of the enabled LTE components is
+// captured from std::clog instead of being formatted to stderr. Each log line
+// becomes a compact record: interned component id, level, simulation time (ns
+// delta), interned format id and the integer arguments as varints. Components
+// and formats are defined inline on first use, so the file can be decoded in
+// one pass; binary_log_decode.py renders it back to text.
+//
+// File layout: "NS3BLOG1", then a sequence of
+//   'C' varint id, varint length, name           component definition
+//   'F' varint id, varint length, format         format definition (0x01 = argument)
+//   'R' varint component, u8 level, zigzag varint time delta (ns), varint format,
+//       one varint per argument                  log record
+
+static const char kBinaryLogMagic[8] = {'N', 'S', '3', 'B', 'L', 'O', 'G', '1'};
+static const char kBinaryLogComponent = 'C';
+static const char kBinaryLogFormat = 'F';
+static const char kBinaryLogRecord = 'R';
+static const char kBinaryLogArgument = '\x01';
+static const size_t kBinaryLogFlushBytes = 1 << 20;
+static const size_t kBinaryLogMaxDigits = 18;  // Larger numbers stay in the format text
+static const char* const kBinaryLogLevels[] = {"", "ERROR", "WARN", "DEBUG", "INFO", "FUNCT", "LOGIC"};
+
+class BinaryLogBuf : public std::streambuf
+{
+public:
+  explicit BinaryLogBuf(const std::string& fileName);
+  ~BinaryLogBuf() override;
+
+  // Records after this keep the last timestamp (the simulator is being destroyed)
+  void FreezeClock() { m_clockFrozen = true; }
+  uint64_t GetRecords() const { return m_records; }
+  uint64_t GetBytes() const { return m_bytes + m_buffer.size(); }
+
+protected:
+  int_type overflow(int_type c) override;
+  std::streamsize xsputn(const char* s, std::streamsize n) override;
+
+private:
+  void EncodeLine();
+  void PutVarint(uint64_t value);
+  uint32_t Intern(std::map<std::string, uint32_t>& table, char kind, const std::string& text);
+  void Flush();
+
+  std::ofstream m_file;
+  std::string m_line;                            // Text of the log line being written
+  std::vector<char> m_buffer;                    // Encoded records not yet written
+  std::map<std::string, uint32_t> m_components;  // Name -> id, id 0 = no component prefix
+  std::map<std::string, uint32_t> m_formats;
+  int64_t m_lastTimeNs;
+  bool m_clockFrozen;
+  uint64_t m_records;
+  uint64_t m_bytes;
+};
+
+inline BinaryLogBuf* g_binaryLog = nullptr;
+inline std::streambuf* g_textLog = nullptr;  // std::clog buffer replaced by the backend
+
+inline BinaryLogBuf::BinaryLogBuf(const std::string& fileName)
+  : m_file(fileName, std::ios::binary),
+    m_lastTimeNs(0),
+    m_clockFrozen(false),
+    m_records(0),
+    m_bytes(0)
+{
+  m_buffer.reserve(kBinaryLogFlushBytes + 4096);
+  m_buffer.insert(m_buffer.end(), kBinaryLogMagic, kBinaryLogMagic + sizeof(kBinaryLogMagic));
+  m_components[""] = 0;
+}
+
+inline BinaryLogBuf::~BinaryLogBuf()
+{
+  if (!m_line.empty())
+  {
+    EncodeLine();
+  }
+  Flush();
+}
+
+inline BinaryLogBuf::int_type
+BinaryLogBuf::overflow(int_type c)
+{
+  if (c != traits_type::eof())
+  {
+    if (c == '\n')
+    {
+      EncodeLine();
+    }
+    else
+    {
+      m_line.push_back(static_cast<char>(c));
+    }
+  }
+  return traits_type::not_eof(c);
+}
+
+inline std::streamsize
+BinaryLogBuf::xsputn(const char* s, std::streamsize n)
+{
+  for (std::streamsize i = 0; i < n; ++i)
+  {
+    overflow(traits_type::to_int_type(s[i]));
+  }
+  return n;
+}
+
+inline void
+BinaryLogBuf::PutVarint(uint64_t value)
+{
+  while (value >= 0x80)
+  {
+    m_buffer.push_back(static_cast<char>(value | 0x80));
+    value >>= 7;
+  }
+  m_buffer.push_back(static_cast<char>(value));
+}
+
+inline uint32_t
+BinaryLogBuf::Intern(std::map<std::string, uint32_t>& table, char kind, const std::string& text)
+{
+  auto it = table.find(text);
+  if (it != table.end())
+  {
+    return it->second;
+  }
+  uint32_t id = table.size();
+  table[text] = id;
+  m_buffer.push_back(kind);
+  PutVarint(id);
+  PutVarint(text.size());
+  m_buffer.insert(m_buffer.end(), text.begin(), text.end());
+  return id;
+}
+
+// Splits "<Component>:<Function>(): [<LEVEL>] <message>" (LOG_PREFIX_FUNC |
+// LOG_PREFIX_LEVEL) into component, level and a format where every canonical
+// unsigned integer is replaced by an argument; other text is kept verbatim.
+inline void
+BinaryLogBuf::EncodeLine()
+{
+  std::string component;
+  size_t start = 0;
+  size_t func = m_line.find("(): ");
+  size_t colon = m_line.find(':');
+  if (func != std::string::npos && colon < func && m_line.find(' ') > colon)
+  {
+    component = m_line.substr(0, colon);
+    start = colon + 1;
+  }
+
+  uint8_t level = 0;
+  size_t label = (func != std::string::npos) ? func + 4 : 0;
+  if (label < m_line.size() && m_line[label] == '[')
+  {
+    size_t close = m_line.find("] ", label);
+    if (close != std::string::npos)
+    {
+      std::string name = m_line.substr(label + 1, close - label - 1);
+      name.erase(name.find_last_not_of(' ') + 1);
+      for (uint8_t l = 1; l < sizeof(kBinaryLogLevels) / sizeof(kBinaryLogLevels[0]); ++l)
+      {
+        if (name == kBinaryLogLevels[l])
+        {
+          level = l;
+          m_line.erase(label, close + 2 - label);
+          break;
+        }
+      }
+    }
+  }
+
+  std::string format;
+  std::vector<uint64_t> args;
+  for (size_t i = start; i < m_line.size();)
+  {
+    if (m_line[i] < '0' || m_line[i] > '9')
+    {
+      format.push_back(m_line[i++]);
+      continue;
+    }
+    size_t end = i;
+    while (end < m_line.size() && m_line[end] >= '0' && m_line[end] <= '9')
+    {
+      ++end;
+    }
+    // Only numbers that print back identically become arguments
+    if ((m_line[i] != '0' || end - i == 1) && end - i <= kBinaryLogMaxDigits)
+    {
+      args.push_back(std::stoull(m_line.substr(i, end - i)));
+      format.push_back(kBinaryLogArgument);
+    }
+    else
+    {
+      format.append(m_line, i, end - i);
+    }
+    i = end;
+  }
+  m_line.clear();
+
+  uint32_t componentId = Intern(m_components, kBinaryLogComponent, component);
+  uint32_t formatId = Intern(m_formats, kBinaryLogFormat, format);
+  int64_t timeNs = m_clockFrozen ? m_lastTimeNs : Simulator::Now().GetNanoSeconds();
+  int64_t delta = timeNs - m_lastTimeNs;
+  m_lastTimeNs = timeNs;
+
+  m_buffer.push_back(kBinaryLogRecord);
+  PutVarint(componentId);
+  m_buffer.push_back(static_cast<char>(level));
+  PutVarint((static_cast<uint64_t>(delta) << 1) ^ static_cast<uint64_t>(delta >> 63));
+  PutVarint(formatId);
+  for (uint64_t arg : args)
+  {
+    PutVarint(arg);
+  }
+  ++m_records;
+  if (m_buffer.size() >= kBinaryLogFlushBytes)
+  {
+    Flush();
+  }
+}
+
+inline void
+BinaryLogBuf::Flush()
+{
+  m_file.write(m_buffer.data(), m_buffer.size());
+  m_bytes += m_buffer.size();
+  m_buffer.clear();
+}
+
+} // namespace ns3
+
+#endif // HANDOVERS_COMMON_BINARY_LOG_H
@@ -0,0 +1,424 @@
+// X2 topology, conditional handover emulation and handover timing.
+#ifndef HANDOVERS_COMMON_CONDITIONAL_HANDOVER_H
+#define HANDOVERS_COMMON_CONDITIONAL_HANDOVER_H
+
+#include "ns3/core-module.h"
+#include "ns3/lte-module.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <set>
+#include <utility>
+#include <vector>
+
+namespace ns3
+{
+
+// ---------------------------------------------------------------------------
+// X2 topology and handover guard
+// ---------------------------------------------------------------------------
+
+static const Time kHoGuardTime = MilliSeconds(500);  // No second decision for a UE while one is running
+
+inline std::set<std::pair<uint16_t, uint16_t>> g_x2Links;  // (lower cellId, higher cellId), filled with AddX2Interface
+
+inline bool HasX2Link(uint16_t a, uint16_t b)
+{
+  return g_x2Links.count(std::make_pair(std::min(a, b), std::max(a, b))) > 0;
+}
+
+// ---------------------------------------------------------------------------
+// Conditional handover (CHO) emulation
+//
+// ns-3 LTE has no CHO, so the serving eNB's handover algorithm emulates it.
+// An early A3 report (PrepareOffset dB before the execution condition, with
+// report-on-leave) maintains a prepared candidate set per UE, of at most
+// MaxCandidates X2 neighbours. Candidates that leave the condition or exceed
+// PreparationTimeout are released. The execution condition is the A3 event
+// with the execution Hysteresis and TimeToTrigger, evaluated by the UE. When
+// it fires for a prepared candidate, the handover runs and the other
+// candidates are released. If the target was not prepared, the handover falls
+// back to a plain reactive one. Preparation, release and execution are counted
+// so the X2/RRC overhead can be modelled against the A3 baseline.
+// ---------------------------------------------------------------------------
+
+// Modelled messages per procedure
+static const uint32_t kX2PerHandover = 4;     // HO Request, Ack, SN Status Transfer, UE Context Release
+static const uint32_t kRrcPerHandover = 3;    // Measurement Report, Reconfiguration, Reconfiguration Complete
+static const uint32_t kX2PerPreparation = 2;  // HO Request, Ack
+static const uint32_t kRrcPerPreparation = 2; // Conditional Reconfiguration, Complete
+static const uint32_t kX2PerRelease = 1;      // HO Cancel
+static const uint32_t kRrcPerRelease = 1;     // Reconfiguration removing the candidate
+static const uint32_t kX2PerExecution = 2;    // SN Status Transfer, UE Context Release
+static const uint32_t kRrcPerExecution = 1;   // Reconfiguration Complete to the target
+
+inline bool g_choHo = false;
+inline uint64_t g_choPreparations = 0;
+inline uint64_t g_choReleases = 0;
+inline uint64_t g_choExecutions = 0;        // Executions to a prepared candidate
+inline uint64_t g_choUnprepared = 0;        // Reactive fallbacks to a target that was not prepared
+inline uint64_t g_choPrepareReports = 0;    // Measurement reports of the preparation condition
+inline uint64_t g_choCandidatesAtExecution = 0;
+
+// Handover timing of every algorithm. The command latency runs from the
+// handover decision to the UE receiving the command, so it includes the X2
+// preparation. The algorithms of these programs record their decision right
+// before TriggerHandover. A3 decides inside ns-3 on the measurement report it
+// receives, so with g_hoTimingFromReports the last report with neighbour
+// results stands in for its decision. For a prepared CHO candidate the
+// preparation was spent ahead of time, so it is not on the critical path.
+struct HoDecision
+{
+  Time time;
+  bool prepared;  // Executes a prepared CHO candidate
+};
+
+inline bool g_hoTimingFromReports = false;             // The algorithm does not record its decisions
+inline std::map<uint32_t, HoDecision> g_hoDecisions;  // (cellId << 16 | rnti) -> last decision of the serving algorithm
+inline std::map<uint64_t, HoDecision> g_hoRunning;    // IMSI -> decision of the running handover
+inline std::map<uint64_t, Time> g_hoPendingLatency;   // IMSI -> command latency on the critical path
+inline Time g_hoCommandLatencyTotal = Seconds(0);
+inline uint64_t g_hoCommandLatencyCount = 0;
+inline Time g_hoCriticalPathTotal = Seconds(0);       // Critical-path latency plus interruption, summed
+inline uint64_t g_hoCriticalPathCount = 0;
+
+// Called by a handover algorithm right before TriggerHandover
+inline void HoTimingDecision(uint16_t cellId, uint16_t rnti, bool prepared)
+{
+  g_hoDecisions[uint32_t(cellId) << 16 | rnti] = {Simulator::Now(), prepared};
+}
+
+// eNB RecvMeasurementReport
+inline void HoTimingReport(uint16_t cellId, uint16_t rnti, const LteRrcSap::MeasResults& measResults)
+{
+  if (g_hoTimingFromReports && measResults.haveMeasResultNeighCells && !measResults.measResultListEutra.empty())
+  {
+    HoTimingDecision(cellId, rnti, false);
+  }
+}
+
+// eNB HandoverStart: the target acknowledged the X2 preparation
+inline void HoTimingPrepared(uint64_t imsi, uint16_t cellId, uint16_t rnti)
+{
+  auto it = g_hoDecisions.find(uint32_t(cellId) << 16 | rnti);
+  if (it != g_hoDecisions.end())
+  {
+    g_hoRunning[imsi] = it->second;
+    g_hoDecisions.erase(it);
+  }
+  else
+  {
+    g_hoRunning[imsi] = {Simulator::Now(), false};
+  }
+}
+
+inline void HoTimingCommand(uint64_t imsi)
+{
+  auto it = g_hoRunning.find(imsi);
+  if (it == g_hoRunning.end())
+  {
+    return;
+  }
+  Time latency = Simulator::Now() - it->second.time;
+  g_hoCommandLatencyTotal += latency;
+  g_hoCommandLatencyCount++;
+  g_hoPendingLatency[imsi] = it->second.prepared ? Seconds(0) : latency;
+  g_hoRunning.erase(it);
+}
+
+inline void HoTimingComplete(uint64_t imsi, Time interruption)
+{
+  auto it = g_hoPendingLatency.find(imsi);
+  if (it != g_hoPendingLatency.end())
+  {
+    g_hoCriticalPathTotal += it->second + interruption;
+    g_hoCriticalPathCount++;
+    g_hoPendingLatency.erase(it);
+  }
+}
+
+class ChoHandoverAlgorithm : public LteHandoverAlgorithm
+{
+public:
+  ChoHandoverAlgorithm();
+  ~ChoHandoverAlgorithm() override;
+
+  static TypeId GetTypeId();
+
+  void SetCellId(uint16_t cellId);
+
+  void SetLteHandoverManagementSapUser(LteHandoverManagementSapUser* s) override;
+  LteHandoverManagementSapProvider* GetLteHandoverManagementSapProvider() override;
+
+  friend class MemberLteHandoverManagementSapProvider<ChoHandoverAlgorithm>;
+
+protected:
+  void DoInitialize() override;
+  void DoDispose() override;
+  void DoReportUeMeas(uint16_t rnti, LteRrcSap::MeasResults measResults) override;
+
+private:
+  void UpdateCandidates(uint16_t rnti, const LteRrcSap::MeasResults& measResults);
+  void Execute(uint16_t rnti, const LteRrcSap::MeasResults& measResults);
+
+  double m_hysteresisDb;
+  Time m_timeToTrigger;
+  double m_prepareOffsetDb;
+  Time m_preparationTimeout;
+  uint32_t m_maxCandidates;
+  uint16_t m_cellId;
+  std::vector<uint8_t> m_executeMeasIds;
+  std::vector<uint8_t> m_prepareMeasIds;
+  std::map<uint16_t, std::map<uint16_t, Time>> m_prepared;  // rnti -> candidate cellId -> preparation time
+  std::map<uint16_t, Time> m_lastExecution;                 // rnti -> time of the last TriggerHandover
+
+  LteHandoverManagementSapUser* m_handoverManagementSapUser;
+  LteHandoverManagementSapProvider* m_handoverManagementSapProvider;
+};
+
+NS_OBJECT_ENSURE_REGISTERED(ChoHandoverAlgorithm);
+
+inline ChoHandoverAlgorithm::ChoHandoverAlgorithm()
+  : m_cellId(0),
+    m_handoverManagementSapUser(nullptr)
+{
+  m_handoverManagementSapProvider = new MemberLteHandoverManagementSapProvider<ChoHandoverAlgorithm>(this);
+}
+
+inline ChoHandoverAlgorithm::~ChoHandoverAlgorithm()
+{
+}
+
+inline TypeId
+ChoHandoverAlgorithm::GetTypeId()
+{
+  static TypeId tid =
+    TypeId("ns3::ChoHandoverAlgorithm")
+      .SetParent<LteHandoverAlgorithm>()
+      .SetGroupName("Lte")
+      .AddConstructor<ChoHandoverAlgorithm>()
+      .AddAttribute("Hysteresis",
+                    "Execution condition: A3 hysteresis in dB (rounded to the nearest multiple of 0.5 dB)",
+                    DoubleValue(3.0),
+                    MakeDoubleAccessor(&ChoHandoverAlgorithm::m_hysteresisDb),
+                    MakeDoubleChecker<uint8_t>(0.0, 15.0))
+      .AddAttribute("TimeToTrigger",
+                    "Execution condition: time the A3 condition must hold before the UE executes",
+                    TimeValue(MilliSeconds(256)),
+                    MakeTimeAccessor(&ChoHandoverAlgorithm::m_timeToTrigger),
+                    MakeTimeChecker())
+      .AddAttribute("PrepareOffset",
+                    "A neighbour is prepared once it is within this many dB of the execution condition",
+                    DoubleValue(3.0),
+                    MakeDoubleAccessor(&ChoHandoverAlgorithm::m_prepareOffsetDb),
+                    MakeDoubleChecker<double>(0.0, 15.0))
+      .AddAttribute("PreparationTimeout",
+                    "Prepared candidates not executed within this time are released",
+                    TimeValue(Seconds(5.0)),
+                    MakeTimeAccessor(&ChoHandoverAlgorithm::m_preparationTimeout),
+                    MakeTimeChecker())
+      .AddAttribute("MaxCandidates",
+                    "Maximum number of prepared targets per UE",
+                    UintegerValue(3),
+                    MakeUintegerAccessor(&ChoHandoverAlgorithm::m_maxCandidates),
+                    MakeUintegerChecker<uint32_t>(1, 8));
+  return tid;
+}
+
+inline void
+ChoHandoverAlgorithm::SetCellId(uint16_t cellId)
+{
+  m_cellId = cellId;
+}
+
+inline void
+ChoHandoverAlgorithm::SetLteHandoverManagementSapUser(LteHandoverManagementSapUser* s)
+{
+  m_handoverManagementSapUser = s;
+}
+
+inline LteHandoverManagementSapProvider*
+ChoHandoverAlgorithm::GetLteHandoverManagementSapProvider()
+{
+  return m_handoverManagementSapProvider;
+}
+
+inline void
+ChoHandoverAlgorithm::DoInitialize()
+{
+  uint8_t hysteresisIeValue = EutranMeasurementMapping::ActualHysteresis2IeValue(m_hysteresisDb);
+
+  LteRrcSap::ReportConfigEutra executeConfig;
+  executeConfig.eventId = LteRrcSap::ReportConfigEutra::EVENT_A3;
+  executeConfig.a3Offset = 0;
+  executeConfig.hysteresis = hysteresisIeValue;
+  executeConfig.timeToTrigger = m_timeToTrigger.GetMilliSeconds();
+  executeConfig.reportOnLeave = false;
+  executeConfig.triggerQuantity = LteRrcSap::ReportConfigEutra::RSRP;
+  executeConfig.reportInterval = LteRrcSap::ReportConfigEutra::MS1024;
+  m_executeMeasIds = m_handoverManagementSapUser->AddUeMeasReportConfigForHandover(executeConfig);
+
+  // Same event shifted by PrepareOffset (a3Offset is in 0.5 dB steps); leaving it releases
+  LteRrcSap::ReportConfigEutra prepareConfig = executeConfig;
+  prepareConfig.a3Offset = -static_cast<int8_t>(std::lround(m_prepareOffsetDb * 2.0));
+  prepareConfig.timeToTrigger = 0;
+  prepareConfig.reportOnLeave = true;
+  prepareConfig.reportInterval = LteRrcSap::ReportConfigEutra::MS480;
+  m_prepareMeasIds = m_handoverManagementSapUser->AddUeMeasReportConfigForHandover(prepareConfig);
+
+  LteHandoverAlgorithm::DoInitialize();
+}
+
+inline void
+ChoHandoverAlgorithm::DoDispose()
+{
+  delete m_handoverManagementSapProvider;
+}
+
+// The report lists the neighbours currently meeting the preparation condition
+inline void
+ChoHandoverAlgorithm::UpdateCandidates(uint16_t rnti, const LteRrcSap::MeasResults& measResults)
+{
+  std::vector<std::pair<uint8_t, uint16_t>> reported;  // (rsrp, cellId), X2 neighbours only
+  if (measResults.haveMeasResultNeighCells)
+  {
+    for (const auto& neigh : measResults.measResultListEutra)
+    {
+      if (neigh.haveRsrpResult && HasX2Link(m_cellId, neigh.physCellId))
+      {
+        reported.push_back(std::make_pair(neigh.rsrpResult, neigh.physCellId));
+      }
+    }
+  }
+  std::sort(reported.rbegin(), reported.rend());
+  if (reported.size() > m_maxCandidates)
+  {
+    reported.resize(m_maxCandidates);
+  }
+
+  Time now = Simulator::Now();
+  std::map<uint16_t, Time>& prepared = m_prepared[rnti];
+  for (auto it = prepared.begin(); it != prepared.end();)
+  {
+    bool stillReported = std::any_of(reported.begin(), reported.end(),
+                                     [&it](const std::pair<uint8_t, uint16_t>& r) { return r.second == it->first; });
+    if (!stillReported || now - it->second > m_preparationTimeout)
+    {
+      g_choReleases++;
+      it = prepared.erase(it);
+    }
+    else
+    {
+      ++it;
+    }
+  }
+  for (const auto& r : reported)
+  {
+    if (prepared.find(r.second) == prepared.end())
+    {
+      g_choPreparations++;
+      prepared[r.second] = now;
+    }
+  }
+}
+
+// The UE-side execution condition fired: run the handover and release the rest
+inline void
+ChoHandoverAlgorithm::Execute(uint16_t rnti, const LteRrcSap::MeasResults& measResults)
+{
+  uint16_t target = 0;
+  uint8_t targetRsrp = 0;
+  for (const auto& neigh : measResults.measResultListEutra)
+  {
+    if (neigh.haveRsrpResult && (target == 0 || neigh.rsrpResult > targetRsrp))
+    {
+      target = neigh.physCellId;
+      targetRsrp = neigh.rsrpResult;
+    }
+  }
+  if (target == 0)
+  {
+    return;
+  }
+
+  std::map<uint16_t, Time>& prepared = m_prepared[rnti];
+  bool isPrepared = prepared.count(target) > 0
+                    && Simulator::Now() - prepared[target] <= m_preparationTimeout;
+  g_choCandidatesAtExecution += prepared.size();
+  g_choReleases += prepared.size() - (isPrepared ? 1 : 0);
+  if (isPrepared)
+  {
+    g_choExecutions++;
+  }
+  else
+  {
+    g_choUnprepared++;
+  }
+  m_prepared.erase(rnti);
+  m_lastExecution[rnti] = Simulator::Now();
+
+  HoTimingDecision(m_cellId, rnti, isPrepared);
+  m_handoverManagementSapUser->TriggerHandover(rnti, target);
+}
+
+inline void
+ChoHandoverAlgorithm::DoReportUeMeas(uint16_t rnti, LteRrcSap::MeasResults measResults)
+{
+  auto last = m_lastExecution.find(rnti);
+  if (last != m_lastExecution.end() && Simulator::Now() - last->second < kHoGuardTime)
+  {
+    return;
+  }
+  if (std::find(m_prepareMeasIds.begin(), m_prepareMeasIds.end(), measResults.measId) != m_prepareMeasIds.end())
+  {
+    g_choPrepareReports++;
+    UpdateCandidates(rnti, measResults);
+  }
+  else if (std::find(m_executeMeasIds.begin(), m_executeMeasIds.end(), measResults.measId) != m_executeMeasIds.end()
+           && measResults.haveMeasResultNeighCells && !measResults.measResultListEutra.empty())
+  {
+    Execute(rnti, measResults);
+  }
+}
+
+// Command latency, critical path and the modelled X2/RRC message counts, for
+// CHO and the single-step handover of the other algorithms alike
+inline void PrintChoStatistics(uint64_t handovers)
+{
+  std::cout << std::fixed << std::setprecision(1);
+  std::cout << "Mean command latency (decision to UE command): "
+            << (g_hoCommandLatencyCount > 0 ? g_hoCommandLatencyTotal.GetSeconds() / g_hoCommandLatencyCount * 1000.0
+                                            : 0.0)
+            << " ms over " << g_hoCommandLatencyCount << " handovers\n";
+  std::cout << "Mean critical path (latency not prepared ahead + interruption): "
+            << (g_hoCriticalPathCount > 0 ? g_hoCriticalPathTotal.GetSeconds() / g_hoCriticalPathCount * 1000.0 : 0.0)
+            << " ms over " << g_hoCriticalPathCount << " handovers\n";
+
+  uint64_t x2 = kX2PerHandover * handovers;
+  uint64_t rrc = kRrcPerHandover * handovers;
+  if (g_choHo)
+  {
+    std::cout << "CHO: " << g_choPreparations << " preparations, " << g_choReleases << " released unused, "
+              << g_choExecutions << " executions of a prepared candidate, " << g_choUnprepared
+              << " reactive fallbacks\n";
+    std::cout << "Mean prepared candidates at execution: "
+              << (g_choExecutions + g_choUnprepared > 0
+                    ? (double)g_choCandidatesAtExecution / (g_choExecutions + g_choUnprepared)
+                    : 0.0)
+              << ", preparation reports: " << g_choPrepareReports << "\n";
+    x2 = kX2PerPreparation * g_choPreparations + kX2PerRelease * g_choReleases + kX2PerExecution * g_choExecutions
+         + kX2PerHandover * g_choUnprepared;
+    rrc = g_choPrepareReports + kRrcPerPreparation * g_choPreparations + kRrcPerRelease * g_choReleases
+          + kRrcPerExecution * g_choExecutions + kRrcPerHandover * g_choUnprepared;
+  }
+  std::cout << "Modelled signalling: " << x2 << " X2 + " << rrc << " RRC messages ("
+            << (handovers > 0 ? (double)(x2 + rrc) / handovers : 0.0) << " per handover, A3 baseline "
+            << kX2PerHandover + kRrcPerHandover << ")\n";
+}
+
+} // namespace ns3
+
+#endif // HANDOVERS_COMMON_CONDITIONAL_HANDOVER_H
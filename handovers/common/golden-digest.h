@@ -0,0 +1,144 @@
+// Golden-output digest: a streaming hash over behaviour-relevant output.
+#ifndef HANDOVERS_COMMON_GOLDEN_DIGEST_H
+#define HANDOVERS_COMMON_GOLDEN_DIGEST_H
+
+#include "ns3/core-module.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace ns3
+{
+
+// ---------------------------------------------------------------------------
+// Golden-output digest
+//
+// A streaming FNV-1a hash over the behaviour-relevant output the program feeds
+// through DigestEvent (its RRC stream records, measurement reports with their
+// quantized serving and neighbour RSRP/RSRQ, and the final KPI summary). Each
+// item is hashed as a canonical text line with integer nanosecond times, so the
+// digest only changes when behaviour does. --goldenMode=record stores it in
+// --goldenFile under the scenario key (command line plus RNG seed and run);
+// --goldenMode=verify compares against the stored digest and fails the run on
+// a mismatch. --digestTrace=1 writes the canonical lines, and trace_diff.py
+// reports the first event where two differ.
+// ---------------------------------------------------------------------------
+static const uint64_t kFnvOffsetBasis = 14695981039346656037ULL;
+static const uint64_t kFnvPrime = 1099511628211ULL;
+
+inline uint64_t g_digest = kFnvOffsetBasis;
+inline uint64_t g_digestEvents = 0;
+inline std::ofstream g_digestTraceFile;
+
+inline void DigestEvent(const std::string& line)
+{
+  for (unsigned char c : line)
+  {
+    g_digest = (g_digest ^ c) * kFnvPrime;
+  }
+  g_digest = (g_digest ^ '\n') * kFnvPrime;
+  g_digestEvents++;
+  if (g_digestTraceFile.is_open())
+  {
+    g_digestTraceFile << line << '\n';
+  }
+}
+
+// Program name, sorted scenario arguments (digest and budget options excluded) and RNG seed/run
+inline std::string DigestScenarioKey(const std::string& program, int argc, char* argv[])
+{
+  std::vector<std::string> args;
+  for (int i = 1; i < argc; ++i)
+  {
+    std::string arg = argv[i];
+    if (arg.find("--golden") != 0 && arg.find("--digestTrace") != 0 && arg.find("--max") != 0)
+    {
+      args.push_back(arg);
+    }
+  }
+  std::sort(args.begin(), args.end());
+  std::ostringstream key;
+  key << program;
+  for (const auto& arg : args)
+  {
+    key << " " << arg;
+  }
+  key << " seed=" << RngSeedManager::GetSeed() << " run=" << RngSeedManager::GetRun();
+  return key.str();
+}
+
+// Golden file lines are "<16 hex digits> <scenario key>". Records the digest or
+// verifies it; returns false only for a failed verification.
+inline bool FinishDigest(const std::string& mode, const std::string& goldenFile, const std::string& key)
+{
+  std::ostringstream hex;
+  hex << std::hex << std::setw(16) << std::setfill('0') << g_digest;
+  const std::string digest = hex.str();
+  std::cout << "\nGolden digest: " << digest << " over " << g_digestEvents << " events\n";
+  if (mode != "record" && mode != "verify")
+  {
+    return true;
+  }
+
+  std::vector<std::pair<std::string, std::string>> entries;
+  std::string stored;
+  std::ifstream in(goldenFile);
+  std::string line;
+  while (std::getline(in, line))
+  {
+    std::string::size_type space = line.find(' ');
+    if (space == std::string::npos)
+    {
+      continue;
+    }
+    entries.push_back({line.substr(0, space), line.substr(space + 1)});
+    if (entries.back().second == key)
+    {
+      stored = entries.back().first;
+    }
+  }
+  in.close();
+
+  if (mode == "record")
+  {
+    std::ofstream out(goldenFile);
+    bool replaced = false;
+    for (auto& entry : entries)
+    {
+      if (entry.second == key)
+      {
+        entry.first = digest;
+        replaced = true;
+      }
+      out << entry.first << " " << entry.second << "\n";
+    }
+    if (!replaced)
+    {
+      out << digest << " " << key << "\n";
+    }
+    std::cout << "Recorded golden digest in " << goldenFile << " for: " << key << "\n";
+    return true;
+  }
+
+  if (stored.empty())
+  {
+    std::cout << "GOLDEN VERIFY FAILED: no digest in " << goldenFile << " for: " << key << "\n";
+    return false;
+  }
+  if (stored != digest)
+  {
+    std::cout << "GOLDEN VERIFY FAILED: expected " << stored << ", got " << digest << "\n"
+              << "Rerun both versions with --digestTrace=1 and compare the traces with trace_diff.py\n";
+    return false;
+  }
+  std::cout << "Golden digest verified for: " << key << "\n";
+  return true;
+}
+
+} // namespace ns3
+
+#endif // HANDOVERS_COMMON_GOLDEN_DIGEST_H
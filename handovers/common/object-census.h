@@ -0,0 +1,142 @@
+// Census of live ns-3 objects by TypeId.
+#ifndef HANDOVERS_COMMON_OBJECT_CENSUS_H
+#define HANDOVERS_COMMON_OBJECT_CENSUS_H
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace ns3
+{
+
+// ---------------------------------------------------------------------------
+// Object census by TypeId
+//
+// Walks every object reachable from the node and channel lists, the way the
+// config store does: aggregated objects, Pointer attributes and ObjectVector /
+// ObjectMap attributes (devices, applications, LTE UE contexts, bearers,
+// sockets, ...). Instances are counted per TypeId together with their shallow
+// size (sizeof of the registered class), once after setup and once at the end
+// of the run. Rows are appended with the scenario's UE and eNB counts, so
+// censuses of different scales can be lined up per type.
+// ---------------------------------------------------------------------------
+struct CensusEntry
+{
+  uint64_t instances = 0;
+  uint64_t approxBytes = 0;
+};
+
+inline std::map<std::string, CensusEntry> TakeObjectCensus()
+{
+  std::map<std::string, CensusEntry> census;
+  std::set<const Object*> seen;
+  std::vector<Ptr<Object>> pending;
+  for (uint32_t n = 0; n < NodeList::GetNNodes(); ++n)
+  {
+    pending.push_back(NodeList::GetNode(n));
+  }
+  for (std::size_t c = 0; c < ChannelList::GetNChannels(); ++c)
+  {
+    pending.push_back(ChannelList::GetChannel(c));
+  }
+
+  while (!pending.empty())
+  {
+    Ptr<Object> object = pending.back();
+    pending.pop_back();
+    if (!object || !seen.insert(PeekPointer(object)).second)
+    {
+      continue;
+    }
+    TypeId tid = object->GetInstanceTypeId();
+    CensusEntry& entry = census[tid.GetName()];
+    entry.instances++;
+    if (tid.GetSize() != static_cast<std::size_t>(-1))
+    {
+      entry.approxBytes += tid.GetSize();
+    }
+
+    Object::AggregateIterator aggregates = object->GetAggregateIterator();
+    while (aggregates.HasNext())
+    {
+      pending.push_back(ConstCast<Object>(aggregates.Next()));
+    }
+
+    for (; tid.HasParent(); tid = tid.GetParent())
+    {
+      for (std::size_t i = 0; i < tid.GetAttributeN(); ++i)
+      {
+        TypeId::AttributeInformation info = tid.GetAttribute(i);
+        if (!(info.flags & TypeId::ATTR_GET) || !info.accessor->HasGetter())
+        {
+          continue;
+        }
+        if (dynamic_cast<const PointerChecker*>(PeekPointer(info.checker)))
+        {
+          PointerValue value;
+          object->GetAttribute(info.name, value);
+          pending.push_back(value.Get<Object>());
+        }
+        else if (dynamic_cast<const ObjectPtrContainerChecker*>(PeekPointer(info.checker)))
+        {
+          ObjectPtrContainerValue value;
+          object->GetAttribute(info.name, value);
+          for (auto it = value.Begin(); it != value.End(); ++it)
+          {
+            pending.push_back(it->second);
+          }
+        }
+      }
+    }
+  }
+  return census;
+}
+
+// Append the census to fileName and print the most numerous types
+inline void WriteObjectCensus(const std::string& fileName, const std::string& stage, uint32_t numUes, uint32_t numEnbs)
+{
+  std::map<std::string, CensusEntry> census = TakeObjectCensus();
+
+  std::ifstream existing(fileName);
+  bool writeHeader = !existing.good() || existing.peek() == std::ifstream::traits_type::eof();
+  existing.close();
+  std::ofstream out(fileName, std::ios::app);
+  if (writeHeader)
+  {
+    out << "numUes,numEnbs,stage,typeId,instances,approxBytes\n";
+  }
+
+  CensusEntry total;
+  std::vector<std::pair<uint64_t, std::string>> ranked;
+  for (const auto& type : census)
+  {
+    out << numUes << "," << numEnbs << "," << stage << "," << type.first << "," << type.second.instances << ","
+        << type.second.approxBytes << "\n";
+    total.instances += type.second.instances;
+    total.approxBytes += type.second.approxBytes;
+    ranked.push_back({type.second.instances, type.first});
+  }
+  out << numUes << "," << numEnbs << "," << stage << ",TOTAL," << total.instances << "," << total.approxBytes << "\n";
+
+  std::sort(ranked.rbegin(), ranked.rend());
+  std::cout << "\nObject census (" << stage << "): " << total.instances << " objects of " << census.size()
+            << " types, ~" << total.approxBytes / 1024 << " KiB shallow\n";
+  for (std::size_t i = 0; i < ranked.size() && i < 12; ++i)
+  {
+    const CensusEntry& entry = census[ranked[i].second];
+    std::cout << "  " << std::left << std::setw(40) << ranked[i].second << std::right << std::setw(10)
+              << entry.instances << std::setw(12) << entry.approxBytes << " B\n";
+  }
+}
+
+} // namespace ns3
+
+#endif // HANDOVERS_COMMON_OBJECT_CENSUS_H
@@ -0,0 +1,72 @@
+// Sharded remote hosts behind the PGW.
+#ifndef HANDOVERS_COMMON_REMOTE_HOSTS_H
+#define HANDOVERS_COMMON_REMOTE_HOSTS_H
+
+#include "ns3/core-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/network-module.h"
+#include "ns3/point-to-point-helper.h"
+
+#include <sstream>
+#include <vector>
+
+namespace ns3
+{
+
+// ---------------------------------------------------------------------------
+// Sharded remote hosts
+//
+// Traffic sources live on several remote hosts behind the PGW instead of one,
+// so no single node's IP stack and socket demultiplexing carries every flow.
+// The UE with IMSI i is served by host (i - 1) % N. Host h has its own
+// point-to-point link to the PGW in 1.h.0.0/16; the PGW reaches every host
+// through its connected routes and each host routes 7.0.0.0/8 back via the PGW.
+// ---------------------------------------------------------------------------
+
+static const uint32_t kMaxRemoteHosts = 256;  // One 1.h.0.0/16 subnet per host
+
+inline NodeContainer g_remoteHosts;
+inline std::vector<Ipv4Address> g_remoteHostAddresses;
+
+inline uint32_t RemoteHostShard(uint64_t imsi)
+{
+  return static_cast<uint32_t>((imsi - 1) % g_remoteHosts.GetN());
+}
+
+// Create numHosts remote hosts linked to the PGW with p2ph; returns the link
+// devices in (PGW, host) pairs
+inline NetDeviceContainer SetupRemoteHosts(Ptr<Node> pgw, uint32_t numHosts,
+                                           InternetStackHelper& internet, PointToPointHelper& p2ph)
+{
+  if (numHosts == 0 || numHosts > kMaxRemoteHosts)
+  {
+    NS_FATAL_ERROR("numRemoteHosts must be between 1 and " << kMaxRemoteHosts << ", got " << numHosts
+                   << " (raise uesPerRemoteHost to need fewer hosts)");
+  }
+  g_remoteHosts.Create(numHosts);
+  internet.Install(g_remoteHosts);
+
+  NetDeviceContainer devices;
+  Ipv4AddressHelper ipv4h;
+  Ipv4StaticRoutingHelper ipv4RoutingHelper;
+  for (uint32_t h = 0; h < numHosts; ++h)
+  {
+    Ptr<Node> host = g_remoteHosts.Get(h);
+    NetDeviceContainer link = p2ph.Install(pgw, host);
+    devices.Add(link);
+
+    std::ostringstream base;
+    base << "1." << h << ".0.0";
+    ipv4h.SetBase(base.str().c_str(), "255.255.0.0");
+    Ipv4InterfaceContainer ifaces = ipv4h.Assign(link);
+    g_remoteHostAddresses.push_back(ifaces.GetAddress(1));
+
+    Ptr<Ipv4StaticRouting> hostRouting = ipv4RoutingHelper.GetStaticRouting(host->GetObject<Ipv4>());
+    hostRouting->AddNetworkRouteTo(Ipv4Address("7.0.0.0"), Ipv4Mask("255.0.0.0"), 1);
+  }
+  return devices;
+}
+
+} // namespace ns3
+
+#endif // HANDOVERS_COMMON_REMOTE_HOSTS_H
@@ -0,0 +1,159 @@
+// Unified RRC event stream: merged eNB/UE connection and handover records.
+#ifndef HANDOVERS_COMMON_RRC_EVENT_STREAM_H
+#define HANDOVERS_COMMON_RRC_EVENT_STREAM_H
+
+#include "ns3/core-module.h"
+
+#include "golden-digest.h"
+
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace ns3
+{
+
+// ---------------------------------------------------------------------------
+// Unified RRC event stream
+//
+// The eNB and UE RRC traces report the same connection and handover events,
+// usually in the same instant. Each event is kept once as a compact record with
+// a side mask; the mirrored report from the other side only sets its bit.
+// Records are buffered and written in chunks; rrc_stream_convert.py rebuilds the
+// legacy eNB/UE/handover-statistics views from the stream.
+// ---------------------------------------------------------------------------
+
+enum RrcEventType : uint8_t
+{
+  RRC_CONN_EST = 0,
+  RRC_HO_START = 1,
+  RRC_HO_END_OK = 2
+};
+
+inline const uint8_t kRrcSideEnb = 0x1;
+inline const uint8_t kRrcSideUe = 0x2;
+inline const char* const kRrcEventNames[] = {"CONN_EST", "HO_START", "HO_END_OK"};
+inline const char* const kRrcSideNames[] = {"", "ENB", "UE", "BOTH"};
+inline const size_t kRrcFlushRecords = 4096;
+
+struct RrcEventRecord
+{
+  int64_t timeNs;
+  uint64_t imsi;
+  uint16_t cellId;
+  uint16_t rnti;
+  uint16_t targetCellId;  // HO_START only, 0 otherwise
+  uint8_t type;
+  uint8_t sides;
+};
+
+// Class of a cell for the optional cellType/targetCellType columns
+using RrcCellTypeFn = std::string (*)(uint16_t cellId);
+
+inline std::ofstream g_rrcEventsFile;
+inline std::vector<RrcEventRecord> g_rrcEvents;
+inline RrcCellTypeFn g_rrcCellType = nullptr;
+inline uint64_t g_rrcEventsWritten = 0;
+inline uint64_t g_rrcEventsMerged = 0;
+
+// Open the stream and write its header; with cellType, every cell id column is
+// followed by the class of that cell
+inline void OpenRrcEventStream(const std::string& path, RrcCellTypeFn cellType = nullptr)
+{
+  g_rrcCellType = cellType;
+  g_rrcEventsFile.open(path);
+  if (g_rrcCellType)
+  {
+    g_rrcEventsFile << "time,side,event,imsi,cellId,cellType,rnti,targetCellId,targetCellType\n";
+  }
+  else
+  {
+    g_rrcEventsFile << "time,side,event,imsi,cellId,rnti,targetCellId\n";
+  }
+}
+
+// Write buffered records in one chunk. Records of the current instant are held
+// back unless this is the final flush, since their mirror may still arrive.
+inline void FlushRrcEvents(bool final)
+{
+  size_t end = g_rrcEvents.size();
+  if (!final)
+  {
+    int64_t nowNs = Simulator::Now().GetNanoSeconds();
+    while (end > 0 && g_rrcEvents[end - 1].timeNs == nowNs)
+    {
+      --end;
+    }
+  }
+  if (end == 0)
+  {
+    return;
+  }
+  std::ostringstream chunk;
+  chunk << std::fixed << std::setprecision(6);
+  for (size_t i = 0; i < end; ++i)
+  {
+    const RrcEventRecord& r = g_rrcEvents[i];
+    chunk << r.timeNs * 1e-9 << "," << kRrcSideNames[r.sides] << "," << kRrcEventNames[r.type] << "," << r.imsi
+          << "," << r.cellId << ",";
+    if (g_rrcCellType)
+    {
+      chunk << g_rrcCellType(r.cellId) << ",";
+    }
+    chunk << r.rnti << ",";
+    if (r.type == RRC_HO_START)
+    {
+      chunk << r.targetCellId;
+      if (g_rrcCellType)
+      {
+        chunk << "," << g_rrcCellType(r.targetCellId);
+      }
+    }
+    else if (g_rrcCellType)
+    {
+      chunk << ",";
+    }
+    chunk << "\n";
+    DigestEvent("RRC," + std::to_string(r.timeNs) + "," + kRrcSideNames[r.sides] + "," + kRrcEventNames[r.type] + ","
+                + std::to_string(r.imsi) + "," + std::to_string(r.cellId) + "," + std::to_string(r.rnti) + ","
+                + std::to_string(r.targetCellId));
+  }
+  const std::string out = chunk.str();
+  g_rrcEventsFile.write(out.data(), out.size());
+  g_rrcEventsWritten += end;
+  g_rrcEvents.erase(g_rrcEvents.begin(), g_rrcEvents.begin() + end);
+}
+
+inline void RecordRrcEvent(RrcEventType type, uint8_t side, uint64_t imsi, uint16_t cellId, uint16_t rnti,
+                           uint16_t targetCellId = 0)
+{
+  int64_t nowNs = Simulator::Now().GetNanoSeconds();
+  for (auto it = g_rrcEvents.rbegin(); it != g_rrcEvents.rend() && it->timeNs == nowNs; ++it)
+  {
+    if (it->type == type && it->imsi == imsi && it->cellId == cellId && it->rnti == rnti
+        && it->targetCellId == targetCellId && !(it->sides & side))
+    {
+      it->sides |= side;
+      g_rrcEventsMerged++;
+      return;
+    }
+  }
+  g_rrcEvents.push_back({nowNs, imsi, cellId, rnti, targetCellId, static_cast<uint8_t>(type), side});
+  if (g_rrcEvents.size() >= kRrcFlushRecords)
+  {
+    FlushRrcEvents(false);
+  }
+}
+
+// Final flush of everything still buffered, then close the file
+inline void CloseRrcEventStream()
+{
+  FlushRrcEvents(true);
+  g_rrcEventsFile.close();
+}
+
+} // namespace ns3
+
+#endif // HANDOVERS_COMMON_RRC_EVENT_STREAM_H
@@ -0,0 +1,169 @@
+// Wall-clock, memory and trace-size budgets that stop a runaway simulation.
+#ifndef HANDOVERS_COMMON_RUN_BUDGET_H
+#define HANDOVERS_COMMON_RUN_BUDGET_H
+
+#include "ns3/core-module.h"
+
+#include <sys/resource.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <filesystem>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace ns3
+{
+
+// ===== Run budget =====
+// A runaway configuration (e.g. a ping-pong storm with a small Hysteresis and
+// TimeToTrigger) can run for hours or exhaust memory. Once a budget is
+// exceeded the simulator stops; the normal teardown after Run() still flushes
+// all sinks and summaries, and the result is marked truncated.
+//
+// Peak RSS and trace size are checked every kBudgetCheckInterval of simulated
+// time. The wall-clock budget must also hold when simulated time barely
+// advances, so a watchdog thread wakes at the deadline and hands the stop to
+// the simulator thread with ScheduleWithContext, the one call ns-3 allows from
+// other threads.
+//
+// The trace size is measured on disk: every file in the working directory
+// whose name starts with one of the program's output prefixes (CSV, PCAP,
+// NetAnim XML, LTE stats, binary logs) counts with the bytes it grew by since
+// the run started, so files appended across runs and leftovers of earlier runs
+// are not charged.
+
+static const Time kBudgetCheckInterval = MilliSeconds(100);
+
+inline double g_maxRssMb = 0.0;  // 0 = unlimited
+inline uint64_t g_maxTraceBytes = 0;
+inline std::vector<std::string> g_budgetOutputPrefixes;
+inline std::map<std::string, uintmax_t> g_budgetBaseBytes;  // Output file -> size when the run started
+inline std::string g_budgetExceeded;  // Budget that stopped the run, empty if it completed
+inline Time g_budgetStopTime;
+
+inline std::thread g_budgetWatchdog;
+inline std::mutex g_budgetMutex;
+inline std::condition_variable g_budgetWake;
+inline bool g_budgetRunDone = false;
+
+// Current size of every output file of this program, by name
+inline std::map<std::string, uintmax_t> OutputFileSizes()
+{
+  std::map<std::string, uintmax_t> sizes;
+  std::error_code ec;
+  for (const auto& entry : std::filesystem::directory_iterator(".", ec))
+  {
+    std::string name = entry.path().filename().string();
+    for (const std::string& prefix : g_budgetOutputPrefixes)
+    {
+      if (name.compare(0, prefix.size(), prefix) == 0 && entry.is_regular_file(ec))
+      {
+        uintmax_t size = entry.file_size(ec);
+        sizes[name] = ec ? 0 : size;
+        break;
+      }
+    }
+  }
+  return sizes;
+}
+
+inline uint64_t TraceBytesWritten()
+{
+  uint64_t bytes = 0;
+  for (const auto& file : OutputFileSizes())
+  {
+    auto base = g_budgetBaseBytes.find(file.first);
+    uintmax_t baseBytes = base != g_budgetBaseBytes.end() ? base->second : 0;
+    bytes += file.second > baseBytes ? file.second - baseBytes : 0;
+  }
+  return bytes;
+}
+
+inline void StopForBudget(const std::string& budget)
+{
+  if (!g_budgetExceeded.empty())
+  {
+    return;
+  }
+  g_budgetExceeded = budget;
+  g_budgetStopTime = Simulator::Now();
+  std::cout << "Budget exceeded (" << g_budgetExceeded << ") at t=" << g_budgetStopTime.GetSeconds()
+            << "s, stopping the simulation" << std::endl;
+  Simulator::Stop();
+}
+
+inline void WallBudgetExpired()
+{
+  StopForBudget("wall");
+}
+
+inline void CheckRunBudget()
+{
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+  if (g_maxRssMb > 0 && usage.ru_maxrss / 1024.0 > g_maxRssMb)
+  {
+    StopForBudget("rss");
+  }
+  else if (g_maxTraceBytes > 0 && TraceBytesWritten() > g_maxTraceBytes)
+  {
+    StopForBudget("trace");
+  }
+  if (g_budgetExceeded.empty())
+  {
+    Simulator::Schedule(kBudgetCheckInterval, &CheckRunBudget);
+  }
+}
+
+// Call right before Simulator::Run(); outputPrefixes name the files that count
+// towards maxTraceBytes
+inline void StartRunBudget(std::chrono::steady_clock::time_point start, double maxWallSeconds, double maxRssMb,
+                           uint64_t maxTraceBytes, const std::vector<std::string>& outputPrefixes)
+{
+  g_maxRssMb = maxRssMb;
+  g_maxTraceBytes = maxTraceBytes;
+  g_budgetOutputPrefixes = outputPrefixes;
+  if (maxTraceBytes > 0)
+  {
+    g_budgetBaseBytes = OutputFileSizes();
+  }
+  if (maxRssMb > 0 || maxTraceBytes > 0)
+  {
+    Simulator::Schedule(kBudgetCheckInterval, &CheckRunBudget);
+  }
+  if (maxWallSeconds > 0)
+  {
+    auto deadline = start + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                                std::chrono::duration<double>(maxWallSeconds));
+    g_budgetWatchdog = std::thread([deadline]() {
+      std::unique_lock<std::mutex> lock(g_budgetMutex);
+      if (!g_budgetWake.wait_until(lock, deadline, [] { return g_budgetRunDone; }))
+      {
+        Simulator::ScheduleWithContext(Simulator::NO_CONTEXT, Seconds(0), &WallBudgetExpired);
+      }
+    });
+  }
+}
+
+// Call right after Simulator::Run() returns, before Simulator::Destroy()
+inline void StopRunBudget()
+{
+  {
+    std::lock_guard<std::mutex> lock(g_budgetMutex);
+    g_budgetRunDone = true;
+  }
+  g_budgetWake.notify_all();
+  if (g_budgetWatchdog.joinable())
+  {
+    g_budgetWatchdog.join();
+  }
+}
+
+} // namespace ns3
+
+#endif // HANDOVERS_COMMON_RUN_BUDGET_H
@@ -0,0 +1,57 @@
+// X2 link helpers: the X2-U port and a scan of the eNB-to-eNB point-to-point devices.
+#ifndef HANDOVERS_COMMON_X2_LINKS_H
+#define HANDOVERS_COMMON_X2_LINKS_H
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/point-to-point-module.h"
+
+#include <functional>
+
+namespace ns3
+{
+
+inline const uint16_t kX2uUdpPort = 2152;  // GTP-U; all other X2 traffic is X2-C
+
+// The node at the other end of a point-to-point link
+inline Ptr<Node> PeerNode(Ptr<PointToPointNetDevice> device)
+{
+  Ptr<Channel> channel = device->GetChannel();
+  for (std::size_t k = 0; k < channel->GetNDevices(); ++k)
+  {
+    Ptr<Node> node = channel->GetDevice(k)->GetNode();
+    if (node != device->GetNode())
+    {
+      return node;
+    }
+  }
+  return nullptr;
+}
+
+// Call back for every point-to-point device of an eNB whose peer is another
+// eNB, i.e. one end of an X2 link, with the indices of both eNBs in enbNodes
+inline void ForEachX2Device(NodeContainer enbNodes,
+                            std::function<void(Ptr<PointToPointNetDevice>, uint32_t, uint32_t)> callback)
+{
+  for (uint32_t i = 0; i < enbNodes.GetN(); ++i)
+  {
+    Ptr<Node> node = enbNodes.Get(i);
+    for (uint32_t d = 0; d < node->GetNDevices(); ++d)
+    {
+      Ptr<PointToPointNetDevice> p2p = DynamicCast<PointToPointNetDevice>(node->GetDevice(d));
+      Ptr<Node> peer = p2p ? PeerNode(p2p) : nullptr;
+      for (uint32_t j = 0; peer && j < enbNodes.GetN(); ++j)
+      {
+        if (j != i && enbNodes.Get(j) == peer)
+        {
+          callback(p2p, i, j);
+          break;
+        }
+      }
+    }
+  }
+}
+
+} // namespace ns3
+
+#endif // HANDOVERS_COMMON_X2_LINKS_H
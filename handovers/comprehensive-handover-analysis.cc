@@ -4,6 +4,7 @@
 #include "ns3/internet-module.h"
 #include "ns3/lte-module.h"
 #include "ns3/point-to-point-helper.h"
+#include "ns3/point-to-point-module.h"
 #include "ns3/applications-module.h"
 #include "ns3/config-store-module.h"
 #include "ns3/flow-monitor-module.h"
@@ -13,25 +14,285 @@
 #include <iomanip>
 #include <cmath>
 #include <cstdlib>
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <set>
+#include <new>
+#include <cstring>
+#include <mutex>
+#include <thread>
+
+#include "common/remote-hosts.h"
+#include "common/batched-udp-source.h"
+#include "common/golden-digest.h"
+#include "common/object-census.h"
+#include "common/bench-line.h"
+#include "common/run-budget.h"
+#include "common/binary-log.h"
+#include "common/conditional-handover.h"
+#include "common/rrc-event-stream.h"
+#include "common/x2-links.h"
 
 using namespace ns3;
 
 NS_LOG_COMPONENT_DEFINE("ComprehensiveHandoverAnalysis");
 
+// ---------------------------------------------------------------------------
+// Per-subsystem heap accounting
+//
+// Replaces the global operator new/delete. With HEAP_ACCOUNTING=1 in the
+// environment every block gets a 16-byte header recording its size, the
+// subsystem tag active when it was allocated (innermost HeapScope) and the
+// scenario phase, so frees are credited back to their origin. The mode is fixed
+// by the first allocation, before main runs, which is why it is an environment
+// variable rather than a command line option; without it the hooks only forward
+// to malloc/free. Header bytes are not counted. The simulator is
+// single-threaded but the --wallBudget watchdog is not: it schedules through
+// the simulator from its own thread and its std::thread state is freed there.
+// The counters are therefore updated under g_heapMutex, and blocks allocated
+// off the main thread go to the "other-threads" tag and phase instead of
+// reading the main thread's HeapScope and phase.
+// ---------------------------------------------------------------------------
+static const uint16_t kHeapMaxTags = 32;
+static const uint32_t kHeapMagic = 0x48454150;  // "HEAP"
+
+struct HeapHeader
+{
+  uint64_t size;
+  uint16_t tag;
+  uint16_t phase;
+  uint32_t magic;
+};
+
+struct HeapCounters
+{
+  uint64_t allocs;
+  uint64_t frees;
+  uint64_t allocatedBytes;
+  int64_t liveBytes;
+  int64_t peakLiveBytes;  // Subsystems: peak of own live bytes; phases: peak of the total during the phase
+};
+
+static int g_heapMode = -1;  // -1 = undecided, 0 = off, 1 = accounting
+static const char* g_heapTagNames[kHeapMaxTags] = {"startup"};  // Static initialization
+static uint16_t g_heapTagCount = 1;
+static uint16_t g_heapTag = 0;
+static uint16_t g_heapPhase = 0;
+static HeapCounters g_heapByTag[kHeapMaxTags];
+static HeapCounters g_heapByPhase[kHeapMaxTags];
+static int64_t g_heapLiveTotal = 0;
+static int64_t g_heapPeakTotal = 0;
+static std::mutex g_heapMutex;  // Guards the counters above while accounting
+static std::thread::id g_heapMainThread;  // Thread of the first allocation (static initialization)
+
+// Tag id of a subsystem or phase name (registered on first use, no allocation)
+static uint16_t HeapTag(const char* name)
+{
+  for (uint16_t t = 0; t < g_heapTagCount; ++t)
+  {
+    if (std::strcmp(g_heapTagNames[t], name) == 0)
+    {
+      return t;
+    }
+  }
+  if (g_heapTagCount == kHeapMaxTags)
+  {
+    return 0;
+  }
+  g_heapTagNames[g_heapTagCount] = name;
+  return g_heapTagCount++;
+}
+
+// Subsystem tags of our own trace sinks; everything else is credited to the phase
+static const uint16_t kHeapRrcStream = HeapTag("rrc-stream");
+static const uint16_t kHeapMeasReports = HeapTag("meas-reports");
+static const uint16_t kHeapMobilityTrace = HeapTag("mobility-trace");
+static const uint16_t kHeapSignalling = HeapTag("signalling");
+static const uint16_t kHeapFeatures = HeapTag("features");
+static const uint16_t kHeapCellLoad = HeapTag("cell-load");
+static const uint16_t kHeapPhyCapture = HeapTag("phy-capture");
+static const uint16_t kHeapThroughput = HeapTag("throughput");
+static const uint16_t kHeapOtherThreads = HeapTag("other-threads");
+
+// Attribute allocations in the enclosing block to a subsystem
+class HeapScope
+{
+public:
+  explicit HeapScope(uint16_t tag)
+    : m_previous(g_heapTag)
+  {
+    g_heapTag = tag;
+  }
+  ~HeapScope()
+  {
+    g_heapTag = m_previous;
+  }
+
+private:
+  uint16_t m_previous;
+};
+
+// Start a scenario phase; its name also becomes the default subsystem tag
+static void HeapPhase(const char* name)
+{
+  g_heapPhase = HeapTag(name);
+  g_heapTag = g_heapPhase;
+  std::lock_guard<std::mutex> lock(g_heapMutex);
+  g_heapByPhase[g_heapPhase].peakLiveBytes = std::max(g_heapByPhase[g_heapPhase].peakLiveBytes, g_heapLiveTotal);
+}
+
+static void* HeapAllocate(std::size_t size)
+{
+  if (g_heapMode < 0)
+  {
+    const char* env = std::getenv("HEAP_ACCOUNTING");
+    g_heapMode = (env && env[0] == '1') ? 1 : 0;
+    g_heapMainThread = std::this_thread::get_id();
+  }
+  if (g_heapMode == 0)
+  {
+    void* p = std::malloc(size ? size : 1);
+    if (!p)
+    {
+      throw std::bad_alloc();
+    }
+    return p;
+  }
+
+  HeapHeader* h = static_cast<HeapHeader*>(std::malloc(sizeof(HeapHeader) + size));
+  if (!h)
+  {
+    throw std::bad_alloc();
+  }
+  const bool mainThread = std::this_thread::get_id() == g_heapMainThread;
+  h->size = size;
+  h->tag = mainThread ? g_heapTag : kHeapOtherThreads;
+  h->phase = mainThread ? g_heapPhase : kHeapOtherThreads;
+  h->magic = kHeapMagic;
+
+  std::lock_guard<std::mutex> lock(g_heapMutex);
+  HeapCounters& byTag = g_heapByTag[h->tag];
+  byTag.allocs++;
+  byTag.allocatedBytes += size;
+  byTag.liveBytes += size;
+  byTag.peakLiveBytes = std::max(byTag.peakLiveBytes, byTag.liveBytes);
+  HeapCounters& byPhase = g_heapByPhase[h->phase];
+  byPhase.allocs++;
+  byPhase.allocatedBytes += size;
+  byPhase.liveBytes += size;
+  g_heapLiveTotal += size;
+  g_heapPeakTotal = std::max(g_heapPeakTotal, g_heapLiveTotal);
+  HeapCounters& current = g_heapByPhase[h->phase == kHeapOtherThreads ? h->phase : g_heapPhase];
+  current.peakLiveBytes = std::max(current.peakLiveBytes, g_heapLiveTotal);
+  return h + 1;
+}
+
+static void HeapFree(void* p)
+{
+  if (!p)
+  {
+    return;
+  }
+  if (g_heapMode != 1)
+  {
+    std::free(p);
+    return;
+  }
+  HeapHeader* h = static_cast<HeapHeader*>(p) - 1;
+  if (h->magic != kHeapMagic)
+  {
+    std::abort();  // Not allocated through HeapAllocate
+  }
+  {
+    std::lock_guard<std::mutex> lock(g_heapMutex);
+    g_heapByTag[h->tag].frees++;
+    g_heapByTag[h->tag].liveBytes -= h->size;
+    g_heapByPhase[h->phase].frees++;
+    g_heapByPhase[h->phase].liveBytes -= h->size;
+    g_heapLiveTotal -= h->size;
+  }
+  h->magic = 0;
+  std::free(h);
+}
+
+void* operator new(std::size_t size)
+{
+  return HeapAllocate(size);
+}
+
+void* operator new[](std::size_t size)
+{
+  return HeapAllocate(size);
+}
+
+void operator delete(void* p) noexcept
+{
+  HeapFree(p);
+}
+
+void operator delete[](void* p) noexcept
+{
+  HeapFree(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept
+{
+  HeapFree(p);
+}
+
+void operator delete[](void* p, std::size_t) noexcept
+{
+  HeapFree(p);
+}
+
+// Table per subsystem and per phase on stdout and in comprehensive_heap_accounting.csv
+static void WriteHeapAccounting()
+{
+  if (g_heapMode != 1)
+  {
+    return;
+  }
+  std::ofstream csv("comprehensive_heap_accounting.csv");
+  csv << "kind,name,allocs,frees,allocatedBytes,liveBytes,peakLiveBytes\n";
+  std::cout << "\nHeap Accounting (live/peak/allocated KiB, allocations):\n";
+  const char* kinds[] = {"subsystem", "phase"};
+  HeapCounters* tables[] = {g_heapByTag, g_heapByPhase};
+  for (int k = 0; k < 2; ++k)
+  {
+    std::cout << "By " << kinds[k] << ":\n";
+    for (uint16_t t = 0; t < g_heapTagCount; ++t)
+    {
+      const HeapCounters& c = tables[k][t];
+      if (c.allocs == 0)
+      {
+        continue;
+      }
+      csv << kinds[k] << "," << g_heapTagNames[t] << "," << c.allocs << "," << c.frees << ","
+          << c.allocatedBytes << "," << c.liveBytes << "," << c.peakLiveBytes << "\n";
+      std::cout << "  " << std::left << std::setw(16) << g_heapTagNames[t] << std::right << std::fixed
+                << std::setprecision(1) << std::setw(12) << c.liveBytes / 1024.0 << std::setw(12)
+                << c.peakLiveBytes / 1024.0 << std::setw(14) << c.allocatedBytes / 1024.0 << std::setw(12)
+                << c.allocs << "\n";
+    }
+  }
+  std::cout << "Peak live heap: " << std::setprecision(1) << g_heapPeakTotal / 1048576.0 << " MiB\n";
+}
+
 // Global variables for NetAnim
 static AnimationInterface* g_anim = nullptr;
 static std::map<uint64_t, uint32_t> g_ueToNodeId; // Map IMSI to node ID for NetAnim
 
 // Global file streams for comprehensive data collection
 static std::ofstream g_measCsv("comprehensive_meas_reports.csv");
-static std::ofstream g_enbRrcCsv("comprehensive_enb_rrc_events.csv");
-static std::ofstream g_ueRrcCsv("comprehensive_ue_rrc_events.csv");
 static std::ofstream g_mobilityTraceFile("comprehensive_ue_mobility_trace.csv");
 static std::ofstream g_throughputFile("comprehensive_throughput_analysis.csv");
-static std::ofstream g_handoverStatsFile("comprehensive_handover_statistics.csv");
 static std::ofstream g_rsrpFile("comprehensive_rsrp_measurements.csv");
 static std::ofstream g_baseStationFile("comprehensive_base_station_info.csv");
 static std::ofstream g_securityEventsFile("comprehensive_security_events.csv");
+static std::ofstream g_pathPlanFile;  // Opened only when the path planner is used
+static std::ofstream g_cellLoadFile;  // Opened only when cell load collection is enabled
+static std::ofstream g_phyMatrixFile; // Opened only when PHY ground-truth capture is enabled
 
 // Global counters and tracking variables
 static uint32_t g_totalHandovers = 0;
@@ -43,261 +304,3037 @@ static std::map<uint64_t, uint32_t> g_ueHandoverCount;
 static std::map<uint64_t, Vector> g_lastUePosition;
 static std::map<uint16_t, std::string> g_baseStationTypes; // cellId -> type (legitimate/faulty/fake)
 
-// Enhanced measurement report callback with base station classification
-static void
-MeasReportSink(std::string context, uint64_t imsi, uint16_t cellId, uint16_t rnti, LteRrcSap::MeasurementReport report)
+// Static description of every cell, indexed by cellId - 1
+struct CellSite
 {
-  const auto& mr = report.measResults;
-  uint8_t measId = mr.measId;
-  
-  // Serving cell measurements
-  int srp = mr.measResultPCell.rsrpResult;   // 0..97 quantized per 36.331
-  int srq = mr.measResultPCell.rsrqResult;   // 0..34  quantized per 36.331
-  
-  // Convert quantized values to actual dBm/dB values for analysis
-  double rsrpDbm = -140.0 + srp;  // RSRP in dBm
-  double rsrqDb = -19.5 + 0.5 * srq;  // RSRQ in dB
-  
-  bool hasNeigh = mr.haveMeasResultNeighCells;
-  std::string event = hasNeigh ? "A3" : "PERIODIC";
-  
-  // Determine serving cell type
-  std::string servingCellType = "UNKNOWN";
-  if (g_baseStationTypes.find(cellId) != g_baseStationTypes.end())
+  uint16_t cellId;
+  std::string cellType;
+  Vector position;
+  double txPowerDbm;
+};
+static std::vector<CellSite> g_cellSites;
+
+// Transmit power used for each base station class
+static double CellTypeTxPower(const std::string& cellType)
+{
+  if (cellType == "FAULTY") return 25.0;   // Poor coverage
+  if (cellType == "FAKE") return 40.0;     // Attractive but not overwhelming
+  return 43.0;                             // 20W legitimate
+}
+
+// ---------------------------------------------------------------------------
+// Scheduled fault timelines
+//
+// --faultSchedule loads per-cell fault timelines from a text file with one
+// entry per line:
+//
+//   <time> <cell> <attribute> <value>     e.g.  "12.5s 4 TxPower 10"
+//
+// <cell> is a cell id, a class (LEGITIMATE, FAULTY, FAKE) or "all".
+// Attributes:
+//   TxPower        eNB transmit power (dBm)
+//   NoiseFigure    eNB uplink noise figure (dB)
+//   Outage         1 = transmitter off, 0 = back to the power before the outage
+// Handover parameters are not schedulable: the A3 hysteresis and
+// TimeToTrigger are evaluated by the UE, and ns-3 sends the measurement
+// configuration only when the UE connects, so a change during the run would
+// not reach the UEs already in the cell.
+// Entries are sorted once. A single pending simulator event applies every due
+// entry through PHY pointers resolved at load time (no Config path lookups),
+// then reschedules itself for the next entry.
+// ---------------------------------------------------------------------------
+
+enum FaultAttribute : uint8_t
+{
+  FAULT_TX_POWER,
+  FAULT_NOISE_FIGURE,
+  FAULT_OUTAGE,
+};
+
+static const char* const kFaultAttributeNames[] = {"TxPower", "NoiseFigure", "Outage"};
+static const double kOutageTxPowerDbm = -100.0;  // Transmitter effectively off
+
+struct FaultEntry
+{
+  Time time;
+  uint16_t cellId;
+  FaultAttribute attribute;
+  double value;
+};
+
+struct FaultCell
+{
+  Ptr<LteEnbPhy> phy;
+  bool inOutage = false;
+  double restoreTxPowerDbm = 0.0;  // Power to return to when the outage ends
+};
+
+static std::vector<FaultEntry> g_faultTimeline;  // Sorted by time
+static size_t g_faultNext = 0;                   // First entry not applied yet
+static std::vector<FaultCell> g_faultCells;      // [cellId - 1]
+static std::ofstream g_faultEventsFile;
+static uint64_t g_faultApplied = 0;
+static uint64_t g_faultOutages = 0;
+
+static void ApplyFault(const FaultEntry& entry)
+{
+  FaultCell& cell = g_faultCells[entry.cellId - 1];
+  double previous = 0.0;
+  switch (entry.attribute)
   {
-    servingCellType = g_baseStationTypes[cellId];
+  case FAULT_TX_POWER:
+    if (cell.inOutage)
+    {
+      // Takes effect when the outage ends
+      previous = cell.restoreTxPowerDbm;
+      cell.restoreTxPowerDbm = entry.value;
+    }
+    else
+    {
+      previous = cell.phy->GetTxPower();
+      cell.phy->SetTxPower(entry.value);
+    }
+    break;
+  case FAULT_NOISE_FIGURE:
+    previous = cell.phy->GetNoiseFigure();
+    cell.phy->SetNoiseFigure(entry.value);
+    break;
+  case FAULT_OUTAGE:
+    previous = cell.inOutage ? 1.0 : 0.0;
+    if (entry.value != 0.0 && !cell.inOutage)
+    {
+      cell.restoreTxPowerDbm = cell.phy->GetTxPower();
+      cell.phy->SetTxPower(kOutageTxPowerDbm);
+      cell.inOutage = true;
+      g_faultOutages++;
+    }
+    else if (entry.value == 0.0 && cell.inOutage)
+    {
+      cell.phy->SetTxPower(cell.restoreTxPowerDbm);
+      cell.inOutage = false;
+    }
+    break;
   }
-  
-  g_measCsv << std::fixed << std::setprecision(6) << Simulator::Now().GetSeconds() << ","
-            << imsi << ","
-            << cellId << ","
-            << servingCellType << ","
-            << rnti << ","
-            << unsigned(measId) << ","
-            << event << ","
-            << srp << ","
-            << srq << ","
-            << rsrpDbm << ","
-            << rsrqDb;
-  
-  // Add neighbor cell measurements with classification
-  if (hasNeigh)
+  g_faultApplied++;
+  g_faultEventsFile << std::fixed << std::setprecision(6) << Simulator::Now().GetSeconds() << "," << entry.cellId
+                    << "," << g_baseStationTypes[entry.cellId] << "," << kFaultAttributeNames[entry.attribute] << ","
+                    << entry.value << "," << previous << "\n";
+}
+
+// The timer: apply every due entry, then wait for the next one
+static void ApplyDueFaults()
+{
+  Time now = Simulator::Now();
+  while (g_faultNext < g_faultTimeline.size() && g_faultTimeline[g_faultNext].time <= now)
   {
-    g_measCsv << ",";
-    for (auto it = mr.measResultListEutra.begin(); it != mr.measResultListEutra.end(); ++it)
+    ApplyFault(g_faultTimeline[g_faultNext++]);
+  }
+  if (g_faultNext < g_faultTimeline.size())
+  {
+    Simulator::Schedule(g_faultTimeline[g_faultNext].time - now, &ApplyDueFaults);
+  }
+}
+
+static void LoadFaultSchedule(const std::string& fileName, uint32_t numCells)
+{
+  std::ifstream in(fileName);
+  if (!in)
+  {
+    NS_FATAL_ERROR("Cannot open fault schedule " << fileName);
+  }
+  std::string line;
+  uint32_t lineNumber = 0;
+  while (std::getline(in, line))
+  {
+    lineNumber++;
+    line = line.substr(0, line.find('#'));
+    std::istringstream fields(line);
+    std::string timeText, cellText, attributeText;
+    double value;
+    if (!(fields >> timeText))
     {
-      uint16_t neighCellId = it->physCellId;
-      int neighRsrp = it->haveRsrpResult ? it->rsrpResult : -1;
-      int neighRsrq = it->haveRsrqResult ? it->rsrqResult : -1;
-      double neighRsrpDbm = (neighRsrp >= 0) ? (-140.0 + neighRsrp) : -200.0;
-      double neighRsrqDb = (neighRsrq >= 0) ? (-19.5 + 0.5 * neighRsrq) : -50.0;
-      
-      std::string neighType = "UNKNOWN";
-      if (g_baseStationTypes.find(neighCellId) != g_baseStationTypes.end())
-      {
-        neighType = g_baseStationTypes[neighCellId];
-      }
-      
-      g_measCsv << neighCellId << ":" << neighType << ":" << neighRsrp << ":" << neighRsrq 
-                << ":" << neighRsrpDbm << ":" << neighRsrqDb << ";";
-      
-      // Log potential security events
-      if (neighType == "FAKE" && neighRsrpDbm > rsrpDbm + 3.0)  // Strong fake signal
+      continue;  // Blank or comment
+    }
+    if (!(fields >> cellText >> attributeText >> value))
+    {
+      NS_FATAL_ERROR(fileName << ":" << lineNumber << ": expected <time> <cell> <attribute> <value>");
+    }
+
+    FaultEntry entry;
+    entry.time = Time(timeText);
+    if (entry.time.IsStrictlyNegative())
+    {
+      NS_FATAL_ERROR(fileName << ":" << lineNumber << ": negative time " << timeText);
+    }
+    auto name = std::find(std::begin(kFaultAttributeNames), std::end(kFaultAttributeNames), attributeText);
+    if (attributeText == "Hysteresis" || attributeText == "TimeToTrigger")
+    {
+      NS_FATAL_ERROR(fileName << ":" << lineNumber << ": " << attributeText
+                              << " is part of the UE measurement configuration and cannot be scheduled");
+    }
+    if (name == std::end(kFaultAttributeNames))
+    {
+      NS_FATAL_ERROR(fileName << ":" << lineNumber << ": unknown attribute '" << attributeText
+                              << "' (expected TxPower, NoiseFigure or Outage)");
+    }
+    entry.attribute = static_cast<FaultAttribute>(name - std::begin(kFaultAttributeNames));
+    entry.value = value;
+
+    bool matched = false;
+    for (uint16_t cellId = 1; cellId <= numCells; ++cellId)
+    {
+      if (cellText == "all" || cellText == g_baseStationTypes[cellId] || cellText == std::to_string(cellId))
       {
-        g_securityEventsFile << std::fixed << std::setprecision(6) << Simulator::Now().GetSeconds() << ","
-                            << "STRONG_FAKE_SIGNAL,IMSI:" << imsi << ",FakeCellId:" << neighCellId 
-                            << ",FakeRSRP:" << neighRsrpDbm << ",ServingRSRP:" << rsrpDbm << std::endl;
+        entry.cellId = cellId;
+        g_faultTimeline.push_back(entry);
+        matched = true;
       }
     }
+    if (!matched)
+    {
+      NS_FATAL_ERROR(fileName << ":" << lineNumber << ": no cell matches '" << cellText << "'");
+    }
   }
-  else
+  std::stable_sort(g_faultTimeline.begin(), g_faultTimeline.end(),
+                   [](const FaultEntry& a, const FaultEntry& b) { return a.time < b.time; });
+}
+
+// Resolve the PHY of every cell, apply the entries at time 0 and start the
+// timer for the rest
+static void SetupFaultTimeline(const std::string& fileName, NetDeviceContainer enbLteDevs)
+{
+  g_faultCells.assign(enbLteDevs.GetN(), FaultCell());
+  for (uint32_t i = 0; i < enbLteDevs.GetN(); ++i)
   {
-    g_measCsv << ",NONE";
+    g_faultCells[i].phy = DynamicCast<LteEnbNetDevice>(enbLteDevs.Get(i))->GetPhy();
   }
-  g_measCsv << std::endl;
-  
-  // Enhanced RSRP file with base station classification
-  g_rsrpFile << std::fixed << std::setprecision(6) << Simulator::Now().GetSeconds() << ","
-             << imsi << "," << cellId << "," << servingCellType << "," 
-             << rsrpDbm << "," << rsrqDb << std::endl;
+  LoadFaultSchedule(fileName, enbLteDevs.GetN());
+
+  g_faultEventsFile.open("comprehensive_fault_events.csv");
+  g_faultEventsFile << "time,cellId,cellType,attribute,value,previous\n";
+  while (g_faultNext < g_faultTimeline.size() && g_faultTimeline[g_faultNext].time.IsZero())
+  {
+    ApplyFault(g_faultTimeline[g_faultNext++]);
+  }
+  if (g_faultNext < g_faultTimeline.size())
+  {
+    Simulator::Schedule(g_faultTimeline[g_faultNext].time, &ApplyDueFaults);
+  }
+  std::cout << "Fault schedule: " << g_faultTimeline.size() << " entries from " << fileName << "\n";
 }
 
-static void EnbConnEstablished(std::string context, uint64_t imsi, uint16_t cellId, uint16_t rnti)
+// ---------------------------------------------------------------------------
+// Windowed feature-vector export for detector training
+//
+// Measurement reports and RRC events of each UE are folded into fixed per-UE
+// window accumulators. At the end of every window a fixed-width float32 feature
+// vector is written for each UE that reported, labelled with the ground-truth
+// class of its strongest neighbour from the cell table. Records go to a flat
+// binary file (numpy.memmap friendly) described by a JSON schema.
+// ---------------------------------------------------------------------------
+
+static const uint32_t kNumFeatures = 13;
+static const char* const kFeatureNames[kNumFeatures] = {
+  "servingRsrpMean", "servingRsrpMin", "servingRsrpMax", "servingRsrpDelta",
+  "bestNeighRsrpMean", "bestNeighRsrpMax", "bestNeighRsrpDelta", "maxNeighMinusServing",
+  "distinctNeighbours", "newPciCount", "handoverCount", "csgDenialCount", "reportCount"};
+static const float kRsrpFloorDbm = -140.0f;  // Used when a window has no neighbour samples
+
+// One record of comprehensive_features.bin (all fields 4 bytes, no padding)
+struct FeatureRecord
 {
-  std::string cellType = g_baseStationTypes[cellId];
-  g_enbRrcCsv << "CONN_EST," << std::fixed << std::setprecision(6) << Simulator::Now().GetSeconds() << ","
-              << imsi << "," << cellId << "," << cellType << "," << rnti << std::endl;
-  
-  // Update NetAnim visualization for connection establishment
-  if (g_anim && g_ueToNodeId.find(imsi) != g_ueToNodeId.end())
+  float windowEnd;
+  uint32_t imsi;
+  uint32_t candidateCellId;  // Strongest neighbour in the window, 0 if none
+  int32_t label;             // Class of the candidate: 0 legitimate, 1 faulty, 2 fake, -1 none
+  float features[kNumFeatures];
+};
+static_assert(sizeof(FeatureRecord) == 16 + 4 * kNumFeatures, "FeatureRecord must be packed");
+
+struct FeatureWindow
+{
+  uint32_t reports = 0;
+  double servingSum = 0.0;
+  double servingMin = 0.0;
+  double servingMax = 0.0;
+  double servingFirst = 0.0;
+  double servingLast = 0.0;
+  uint32_t neighSamples = 0;     // Reports carrying at least one neighbour
+  double neighSum = 0.0;
+  double neighMax = 0.0;
+  double neighFirst = 0.0;
+  double neighLast = 0.0;
+  double maxNeighMinusServing = 0.0;
+  uint16_t candidateCell = 0;
+  double candidateRsrp = -1e9;
+  uint32_t distinctNeighbours = 0;
+  uint32_t newPcis = 0;
+  uint32_t handovers = 0;
+  uint32_t csgDenials = 0;
+};
+
+static bool g_featureExport = false;
+static uint32_t g_featureNumCells = 0;
+static uint32_t g_featureWindowIndex = 0;
+static std::vector<FeatureWindow> g_featureWindows;  // [ueIndex]
+static std::vector<uint32_t> g_featureNeighStamp;    // [ueIndex * numCells + cellIndex]: last window + 1
+static std::vector<uint8_t> g_featureCellSeen;       // [ueIndex * numCells + cellIndex]: ever reported
+static std::vector<int64_t> g_featureCellCsgId;      // [cellIndex]: CSG identity broadcast in SIB1, -1 if open
+static std::vector<uint32_t> g_featureUeCsgId;       // [ueIndex]: CSG the UE is a member of
+static std::ofstream g_featureFile;
+static uint64_t g_featureRecords = 0;
+
+// The cell's SIB1 carries the CSG indication with a CSG the UE is not a member of
+static bool IsClosedCsgCell(uint32_t ueIndex, uint16_t cellId)
+{
+  int64_t csgId = g_featureCellCsgId[cellId - 1];
+  return csgId >= 0 && csgId != g_featureUeCsgId[ueIndex];
+}
+
+static int32_t CellClassLabel(uint16_t cellId)
+{
+  auto it = g_baseStationTypes.find(cellId);
+  if (it == g_baseStationTypes.end()) return -1;
+  if (it->second == "FAULTY") return 1;
+  if (it->second == "FAKE") return 2;
+  return 0;
+}
+
+static void FeatureObserveReport(uint64_t imsi, double servingDbm, const LteRrcSap::MeasResults& mr)
+{
+  HeapScope heapScope(kHeapFeatures);
+  if (imsi == 0 || imsi > g_featureWindows.size())
   {
-    uint32_t ueNodeId = g_ueToNodeId[imsi];
-    if (cellType == "LEGITIMATE")
+    return;
+  }
+  uint32_t u = imsi - 1;
+  FeatureWindow& w = g_featureWindows[u];
+  if (w.reports == 0)
+  {
+    w.servingMin = w.servingMax = w.servingFirst = servingDbm;
+  }
+  w.reports++;
+  w.servingSum += servingDbm;
+  w.servingMin = std::min(w.servingMin, servingDbm);
+  w.servingMax = std::max(w.servingMax, servingDbm);
+  w.servingLast = servingDbm;
+
+  double bestNeigh = -1e9;
+  uint16_t bestCell = 0;
+  for (const auto& neigh : mr.measResultListEutra)
+  {
+    if (!neigh.haveRsrpResult || neigh.physCellId == 0 || neigh.physCellId > g_featureNumCells)
     {
-      g_anim->UpdateNodeColor(ueNodeId, 0, 255, 0); // Green when connected to legitimate
+      continue;
     }
-    else if (cellType == "FAULTY")
+    double neighDbm = -140.0 + neigh.rsrpResult;
+    uint32_t slot = u * g_featureNumCells + neigh.physCellId - 1;
+    if (g_featureNeighStamp[slot] != g_featureWindowIndex + 1)
     {
-      g_anim->UpdateNodeColor(ueNodeId, 255, 165, 0); // Orange when connected to faulty
+      g_featureNeighStamp[slot] = g_featureWindowIndex + 1;
+      w.distinctNeighbours++;
     }
-    else if (cellType == "FAKE")
+    if (!g_featureCellSeen[slot])
     {
-      g_anim->UpdateNodeColor(ueNodeId, 255, 0, 255); // Magenta when connected to fake
+      g_featureCellSeen[slot] = 1;
+      w.newPcis++;
+    }
+    if (neighDbm > bestNeigh)
+    {
+      bestNeigh = neighDbm;
+      bestCell = neigh.physCellId;
     }
   }
-  
-  // Track fake connection attempts
-  if (cellType == "FAKE")
+  if (bestCell == 0)
   {
-    g_fakeAttachAttempts++;
-    g_securityEventsFile << std::fixed << std::setprecision(6) << Simulator::Now().GetSeconds() << ","
-                        << "FAKE_ATTACH_ATTEMPT,IMSI:" << imsi << ",FakeCellId:" << cellId << std::endl;
+    return;
+  }
+
+  if (w.neighSamples == 0)
+  {
+    w.neighMax = w.neighFirst = bestNeigh;
+    w.maxNeighMinusServing = bestNeigh - servingDbm;
+  }
+  w.neighSamples++;
+  w.neighSum += bestNeigh;
+  w.neighMax = std::max(w.neighMax, bestNeigh);
+  w.neighLast = bestNeigh;
+  w.maxNeighMinusServing = std::max(w.maxNeighMinusServing, bestNeigh - servingDbm);
+  if (bestNeigh > w.candidateRsrp)
+  {
+    w.candidateRsrp = bestNeigh;
+    w.candidateCell = bestCell;
+  }
+  // The strongest neighbour beats the serving cell but the UE may not access it
+  if (bestNeigh > servingDbm && IsClosedCsgCell(u, bestCell))
+  {
+    w.csgDenials++;
   }
 }
 
-static void EnbHoStart(std::string context, uint64_t imsi, uint16_t cellId, uint16_t rnti, uint16_t targetCid)
+static void FeatureObserveHandover(uint64_t imsi)
 {
-  g_totalHandovers++;
-  g_ueHandoverCount[imsi]++;
-  
-  std::string sourceCellType = g_baseStationTypes[cellId];
-  std::string targetCellType = g_baseStationTypes[targetCid];
-  
-  g_enbRrcCsv << "HO_START," << std::fixed << std::setprecision(6) << Simulator::Now().GetSeconds() << ","
-              << imsi << "," << cellId << "," << sourceCellType << "," << rnti 
-              << ",to:" << targetCid << "," << targetCellType << std::endl;
+  HeapScope heapScope(kHeapFeatures);
+  if (g_featureExport && imsi > 0 && imsi <= g_featureWindows.size())
+  {
+    g_featureWindows[imsi - 1].handovers++;
+  }
+}
+
+// Convert a finished window into a record
+static FeatureRecord BuildFeatureRecord(uint32_t ueIndex, const FeatureWindow& w, float windowEnd)
+{
+  FeatureRecord rec;
+  rec.windowEnd = windowEnd;
+  rec.imsi = ueIndex + 1;
+  rec.candidateCellId = w.candidateCell;
+  rec.label = w.candidateCell ? CellClassLabel(w.candidateCell) : -1;
+  bool haveNeigh = w.neighSamples > 0;
+  float* f = rec.features;
+  f[0] = w.servingSum / w.reports;
+  f[1] = w.servingMin;
+  f[2] = w.servingMax;
+  f[3] = w.servingLast - w.servingFirst;
+  f[4] = haveNeigh ? w.neighSum / w.neighSamples : kRsrpFloorDbm;
+  f[5] = haveNeigh ? w.neighMax : kRsrpFloorDbm;
+  f[6] = haveNeigh ? w.neighLast - w.neighFirst : 0.0f;
+  f[7] = haveNeigh ? w.maxNeighMinusServing : kRsrpFloorDbm - w.servingMax;
+  f[8] = w.distinctNeighbours;
+  f[9] = w.newPcis;
+  f[10] = w.handovers;
+  f[11] = w.csgDenials;
+  f[12] = w.reports;
+  return rec;
+}
+
+// ---------------------------------------------------------------------------
+// Embedded rogue-cell detector
+//
+// A small offline-trained model (logistic regression, gradient-boosted trees or
+// a one-hidden-layer MLP) is loaded from a text file. The feature windows closed
+// at each window boundary are scored as one batch; a cell whose windows score
+// above the threshold is flagged and, after detectorVotes positive windows,
+// blacklisted for the rest of the run.
+// ---------------------------------------------------------------------------
+
+class DetectorModel
+{
+public:
+  virtual ~DetectorModel() {}
+  virtual std::string GetName() const = 0;
+  // Score n row-major feature rows into probabilities that the candidate is FAKE
+  virtual void ScoreBatch(const float* x, uint32_t n, float* out) const = 0;
+
+  float mean[kNumFeatures] = {};
+  float invScale[kNumFeatures] = {1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1};
+};
+
+static inline float Sigmoid(float z)
+{
+  return 1.0f / (1.0f + std::exp(-z));
+}
+
+// Logistic regression on standardized features
+class LogisticDetector : public DetectorModel
+{
+public:
+  float weights[kNumFeatures] = {};
+  float bias = 0.0f;
+
+  std::string GetName() const override { return "logreg"; }
+
+  void ScoreBatch(const float* x, uint32_t n, float* out) const override
+  {
+    // Fold the standardization into the weights once per batch
+    float w[kNumFeatures];
+    float b = bias;
+    for (uint32_t j = 0; j < kNumFeatures; ++j)
+    {
+      w[j] = weights[j] * invScale[j];
+      b -= w[j] * mean[j];
+    }
+    for (uint32_t i = 0; i < n; ++i)
+    {
+      const float* row = x + i * kNumFeatures;
+      float z = b;
+      for (uint32_t j = 0; j < kNumFeatures; ++j)
+      {
+        z += w[j] * row[j];
+      }
+      out[i] = Sigmoid(z);
+    }
+  }
+};
+
+// One hidden ReLU layer followed by a sigmoid output unit
+class MlpDetector : public DetectorModel
+{
+public:
+  uint32_t hidden = 0;
+  std::vector<float> w1;  // hidden x kNumFeatures, row-major
+  std::vector<float> b1;
+  std::vector<float> w2;
+  float b2 = 0.0f;
+
+  std::string GetName() const override { return "mlp"; }
+
+  void ScoreBatch(const float* x, uint32_t n, float* out) const override
+  {
+    float z[kNumFeatures];
+    for (uint32_t i = 0; i < n; ++i)
+    {
+      const float* row = x + i * kNumFeatures;
+      for (uint32_t j = 0; j < kNumFeatures; ++j)
+      {
+        z[j] = (row[j] - mean[j]) * invScale[j];
+      }
+      float y = b2;
+      for (uint32_t h = 0; h < hidden; ++h)
+      {
+        const float* wh = &w1[h * kNumFeatures];
+        float a = b1[h];
+        for (uint32_t j = 0; j < kNumFeatures; ++j)
+        {
+          a += wh[j] * z[j];
+        }
+        y += w2[h] * std::max(0.0f, a);
+      }
+      out[i] = Sigmoid(y);
+    }
+  }
+};
+
+// Additive ensemble of binary trees; a node goes left when x[feature] < threshold
+class TreeEnsembleDetector : public DetectorModel
+{
+public:
+  struct Node
+  {
+    int32_t feature;   // -1 for a leaf
+    float threshold;
+    int32_t left;      // Indices relative to the tree root
+    int32_t right;
+    float value;       // Leaf contribution
+  };
+
+  float base = 0.0f;
+  std::vector<Node> nodes;      // All trees back to back
+  std::vector<uint32_t> roots;  // Offset of each tree in nodes
+
+  std::string GetName() const override { return "gbt"; }
+
+  void ScoreBatch(const float* x, uint32_t n, float* out) const override
+  {
+    std::fill(out, out + n, base);
+    // Tree-major traversal keeps one tree hot in cache across the whole batch
+    for (uint32_t root : roots)
+    {
+      const Node* tree = &nodes[root];
+      for (uint32_t i = 0; i < n; ++i)
+      {
+        const float* row = x + i * kNumFeatures;
+        const Node* node = tree;
+        while (node->feature >= 0)
+        {
+          node = &tree[row[node->feature] < node->threshold ? node->left : node->right];
+        }
+        out[i] += node->value;
+      }
+    }
+    for (uint32_t i = 0; i < n; ++i)
+    {
+      out[i] = Sigmoid(out[i]);
+    }
+  }
+};
+
+static void ReadModelValues(std::istream& in, float* dst, uint32_t count, const std::string& key)
+{
+  for (uint32_t i = 0; i < count; ++i)
+  {
+    if (!(in >> dst[i]))
+    {
+      NS_FATAL_ERROR("Detector model: expected " << count << " values after '" << key << "'");
+    }
+  }
+}
+
+// Parse a model file. Format (whitespace separated, '#' starts a comment):
+//   logreg | mlp <hidden> | gbt <trees>
+//   threshold <t>        optional decision threshold
+//   mean <13 values>     optional standardization (logreg, mlp)
+//   scale <13 values>
+//   logreg: weights <13> bias <1>
+//   mlp:    w1 <hidden*13> b1 <hidden> w2 <hidden> b2 <1>
+//   gbt:    base <1> then per tree "tree <nodes>" and one line per node:
+//           <feature> <threshold> <left> <right> <value>   (feature -1 = leaf)
+//           Children come after their parent, so every path ends in a leaf.
+// Every parameter key of the model type must appear exactly once and a gbt
+// model must contain the declared number of trees.
+static const uint32_t kMaxDetectorHidden = 4096;
+static const uint32_t kMaxDetectorTrees = 100000;
+static const uint32_t kMaxDetectorTreeNodes = 1 << 20;
+
+static std::unique_ptr<DetectorModel> LoadDetectorModel(const std::string& path, float& threshold)
+{
+  std::ifstream file(path);
+  if (!file)
+  {
+    NS_FATAL_ERROR("Cannot open detector model " << path);
+  }
+  std::stringstream in;
+  std::string line;
+  while (std::getline(file, line))
+  {
+    in << line.substr(0, line.find('#')) << "\n";
+  }
+
+  std::string type;
+  in >> type;
+  std::unique_ptr<DetectorModel> model;
+  LogisticDetector* logreg = nullptr;
+  MlpDetector* mlp = nullptr;
+  TreeEnsembleDetector* gbt = nullptr;
+  uint32_t numTrees = 0;
+  std::vector<std::string> required;
+  if (type == "logreg")
+  {
+    logreg = new LogisticDetector();
+    model.reset(logreg);
+    required = {"weights", "bias"};
+  }
+  else if (type == "mlp")
+  {
+    mlp = new MlpDetector();
+    model.reset(mlp);
+    if (!(in >> mlp->hidden) || mlp->hidden == 0 || mlp->hidden > kMaxDetectorHidden)
+    {
+      NS_FATAL_ERROR("Detector model: mlp needs 1.." << kMaxDetectorHidden << " hidden units in " << path);
+    }
+    required = {"w1", "b1", "w2", "b2"};
+    mlp->w1.resize(mlp->hidden * kNumFeatures);
+    mlp->b1.resize(mlp->hidden);
+    mlp->w2.resize(mlp->hidden);
+  }
+  else if (type == "gbt")
+  {
+    gbt = new TreeEnsembleDetector();
+    model.reset(gbt);
+    if (!(in >> numTrees) || numTrees == 0 || numTrees > kMaxDetectorTrees)
+    {
+      NS_FATAL_ERROR("Detector model: gbt needs 1.." << kMaxDetectorTrees << " trees in " << path);
+    }
+    gbt->roots.reserve(numTrees);
+  }
+  else
+  {
+    NS_FATAL_ERROR("Unknown detector model type '" << type << "' in " << path);
+  }
+
+  std::set<std::string> seen;
+  std::string key;
+  while (in >> key)
+  {
+    if (key != "tree" && !seen.insert(key).second)
+    {
+      NS_FATAL_ERROR("Detector model: duplicate key '" << key << "' in " << path);
+    }
+    if (key == "threshold")
+    {
+      ReadModelValues(in, &threshold, 1, key);
+    }
+    else if (key == "mean")
+    {
+      ReadModelValues(in, model->mean, kNumFeatures, key);
+    }
+    else if (key == "scale")
+    {
+      float scale[kNumFeatures];
+      ReadModelValues(in, scale, kNumFeatures, key);
+      for (uint32_t j = 0; j < kNumFeatures; ++j)
+      {
+        model->invScale[j] = (scale[j] != 0.0f) ? 1.0f / scale[j] : 1.0f;
+      }
+    }
+    else if (logreg && key == "weights")
+    {
+      ReadModelValues(in, logreg->weights, kNumFeatures, key);
+    }
+    else if (logreg && key == "bias")
+    {
+      ReadModelValues(in, &logreg->bias, 1, key);
+    }
+    else if (mlp && key == "w1")
+    {
+      ReadModelValues(in, mlp->w1.data(), mlp->w1.size(), key);
+    }
+    else if (mlp && key == "b1")
+    {
+      ReadModelValues(in, mlp->b1.data(), mlp->hidden, key);
+    }
+    else if (mlp && key == "w2")
+    {
+      ReadModelValues(in, mlp->w2.data(), mlp->hidden, key);
+    }
+    else if (mlp && key == "b2")
+    {
+      ReadModelValues(in, &mlp->b2, 1, key);
+    }
+    else if (gbt && key == "base")
+    {
+      ReadModelValues(in, &gbt->base, 1, key);
+    }
+    else if (gbt && key == "tree")
+    {
+      uint32_t numNodes;
+      if (gbt->roots.size() == numTrees || !(in >> numNodes) || numNodes == 0 || numNodes > kMaxDetectorTreeNodes)
+      {
+        NS_FATAL_ERROR("Detector model: malformed tree " << gbt->roots.size() << " (" << numTrees
+                                                          << " declared) in " << path);
+      }
+      uint32_t root = gbt->nodes.size();
+      gbt->roots.push_back(root);
+      for (uint32_t k = 0; k < numNodes; ++k)
+      {
+        TreeEnsembleDetector::Node node;
+        if (!(in >> node.feature >> node.threshold >> node.left >> node.right >> node.value) ||
+            node.feature < -1 || node.feature >= int32_t(kNumFeatures) ||
+            (node.feature >= 0 && (node.left <= int32_t(k) || node.right <= int32_t(k) ||
+                                   uint32_t(node.left) >= numNodes || uint32_t(node.right) >= numNodes)))
+        {
+          NS_FATAL_ERROR("Detector model: malformed node " << k << " in tree " << gbt->roots.size() - 1);
+        }
+        gbt->nodes.push_back(node);
+      }
+    }
+    else
+    {
+      NS_FATAL_ERROR("Detector model: unexpected key '" << key << "' in " << path);
+    }
+  }
+
+  for (const std::string& r : required)
+  {
+    if (!seen.count(r))
+    {
+      NS_FATAL_ERROR("Detector model: " << type << " model without '" << r << "' in " << path);
+    }
+  }
+  if (gbt && gbt->roots.size() != numTrees)
+  {
+    NS_FATAL_ERROR("Detector model: " << gbt->roots.size() << " of " << numTrees << " trees in " << path);
+  }
+  if (threshold < 0.0f || threshold > 1.0f)
+  {
+    NS_FATAL_ERROR("Detector model: threshold " << threshold << " outside [0, 1] in " << path);
+  }
+  return model;
+}
+
+static std::unique_ptr<DetectorModel> g_detector;
+static float g_detectorThreshold = 0.5f;
+static uint32_t g_detectorVotes = 3;
+static std::vector<FeatureRecord> g_detectorPending;  // Windows waiting to be scored
+static std::vector<float> g_detectorBatch;            // Their features, row-major
+static std::vector<float> g_detectorScores;
+static std::vector<uint32_t> g_cellDetectorVotes;     // Indexed by cellId - 1
+static std::vector<uint8_t> g_cellBlacklisted;        // Indexed by cellId - 1
+
+// Detector performance and quality counters
+static uint64_t g_detectorDecisions = 0;
+static uint64_t g_detectorBatches = 0;
+static uint64_t g_detectorScoreNs = 0;
+static uint64_t g_detectorMaxBatchNs = 0;
+static uint64_t g_detectorTruePos = 0;
+static uint64_t g_detectorFalsePos = 0;
+static uint64_t g_detectorFalseNeg = 0;
+static uint64_t g_detectorTrueNeg = 0;
+
+static bool IsCellBlacklisted(uint16_t cellId)
+{
+  return cellId > 0 && cellId <= g_cellBlacklisted.size() && g_cellBlacklisted[cellId - 1];
+}
+
+static void QueueDetectorWindow(const FeatureRecord& rec)
+{
+  g_detectorPending.push_back(rec);
+  g_detectorBatch.insert(g_detectorBatch.end(), rec.features, rec.features + kNumFeatures);
+}
+
+// Score all pending windows as one batch and act on the decisions
+static void ScorePendingWindows()
+{
+  uint32_t n = g_detectorPending.size();
+  if (n == 0)
+  {
+    return;
+  }
+  g_detectorScores.resize(n);
+  auto start = std::chrono::steady_clock::now();
+  g_detector->ScoreBatch(g_detectorBatch.data(), n, g_detectorScores.data());
+  uint64_t elapsedNs = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+  g_detectorScoreNs += elapsedNs;
+  g_detectorMaxBatchNs = std::max(g_detectorMaxBatchNs, elapsedNs);
+  g_detectorBatches++;
+  g_detectorDecisions += n;
+
+  for (uint32_t i = 0; i < n; ++i)
+  {
+    const FeatureRecord& rec = g_detectorPending[i];
+    bool flagged = g_detectorScores[i] >= g_detectorThreshold;
+    bool isFake = rec.label == 2;
+    g_detectorTruePos += flagged && isFake;
+    g_detectorFalsePos += flagged && !isFake;
+    g_detectorFalseNeg += !flagged && isFake;
+    g_detectorTrueNeg += !flagged && !isFake;
+
+    uint16_t cellId = rec.candidateCellId;
+    if (!flagged || cellId == 0 || cellId > g_cellDetectorVotes.size())
+    {
+      continue;
+    }
+    g_securityEventsFile << std::fixed << std::setprecision(6) << Simulator::Now().GetSeconds() << ","
+                         << "DETECTOR_FLAG,IMSI:" << rec.imsi << ",CellId:" << cellId
+                         << ",Score:" << g_detectorScores[i] << std::endl;
+    if (++g_cellDetectorVotes[cellId - 1] == g_detectorVotes)
+    {
+      g_cellBlacklisted[cellId - 1] = 1;
+      g_securityEventsFile << std::fixed << std::setprecision(6) << Simulator::Now().GetSeconds() << ","
+                           << "DETECTOR_BLACKLIST,CellId:" << cellId << "(" << g_baseStationTypes[cellId]
+                           << "),Votes:" << g_detectorVotes << std::endl;
+    }
+  }
+  g_detectorPending.clear();
+  g_detectorBatch.clear();
+}
+
+// Close the current window for all UEs, then export and/or score the records
+static void CloseFeatureWindows()
+{
+  HeapScope heapScope(kHeapFeatures);
+  float windowEnd = Simulator::Now().GetSeconds();
+  for (uint32_t u = 0; u < g_featureWindows.size(); ++u)
+  {
+    const FeatureWindow& w = g_featureWindows[u];
+    if (w.reports > 0)
+    {
+      FeatureRecord rec = BuildFeatureRecord(u, w, windowEnd);
+      if (g_featureFile.is_open())
+      {
+        g_featureFile.write(reinterpret_cast<const char*>(&rec), sizeof(rec));
+        g_featureRecords++;
+      }
+      if (g_detector)
+      {
+        QueueDetectorWindow(rec);
+      }
+    }
+    g_featureWindows[u] = FeatureWindow();
+  }
+  if (g_detector)
+  {
+    ScorePendingWindows();
+  }
+}
+
+static void FlushFeatureWindows(Time window)
+{
+  CloseFeatureWindows();
+  g_featureWindowIndex++;
+  Simulator::Schedule(window, &FlushFeatureWindows, window);
+}
+
+// At the end of the run: export and score the partial window since the last flush
+static void FlushFinalFeatureWindows()
+{
+  if (g_featureExport)
+  {
+    CloseFeatureWindows();
+  }
+}
+
+static void WriteFeatureSchema(Time window)
+{
+  std::ofstream schema("comprehensive_features.schema.json");
+  schema << "{\n"
+         << "  \"file\": \"comprehensive_features.bin\",\n"
+         << "  \"byteOrder\": \"little\",\n"
+         << "  \"recordSize\": " << sizeof(FeatureRecord) << ",\n"
+         << "  \"windowSeconds\": " << window.GetSeconds() << ",\n"
+         << "  \"fields\": [\n"
+         << "    {\"name\": \"windowEnd\", \"dtype\": \"<f4\"},\n"
+         << "    {\"name\": \"imsi\", \"dtype\": \"<u4\"},\n"
+         << "    {\"name\": \"candidateCellId\", \"dtype\": \"<u4\"},\n"
+         << "    {\"name\": \"label\", \"dtype\": \"<i4\"},\n"
+         << "    {\"name\": \"features\", \"dtype\": \"<f4\", \"shape\": [" << kNumFeatures << "]}\n"
+         << "  ],\n"
+         << "  \"features\": [";
+  for (uint32_t i = 0; i < kNumFeatures; ++i)
+  {
+    schema << (i ? ", " : "") << "\"" << kFeatureNames[i] << "\"";
+  }
+  schema << "],\n"
+         << "  \"labels\": {\"-1\": \"NONE\", \"0\": \"LEGITIMATE\", \"1\": \"FAULTY\", \"2\": \"FAKE\"}\n"
+         << "}\n";
+}
+
+// Start feature windowing; the binary export is optional since the detector
+// consumes the same windows. The CSG configuration is read from the devices,
+// as a UE would read it from SIB1 and its subscription.
+static void SetupFeatureExport(NetDeviceContainer enbLteDevs, NetDeviceContainer ueLteDevs, Time window,
+                               bool writeFile)
+{
+  uint32_t numUes = ueLteDevs.GetN();
+  uint32_t numCells = enbLteDevs.GetN();
+  g_featureExport = true;
+  g_featureNumCells = numCells;
+  g_featureWindows.assign(numUes, FeatureWindow());
+  g_featureNeighStamp.assign(numUes * numCells, 0);
+  g_featureCellSeen.assign(numUes * numCells, 0);
+  g_featureCellCsgId.assign(numCells, -1);
+  for (uint32_t i = 0; i < numCells; ++i)
+  {
+    Ptr<LteEnbNetDevice> enbDev = DynamicCast<LteEnbNetDevice>(enbLteDevs.Get(i));
+    if (enbDev->GetCsgIndication())
+    {
+      g_featureCellCsgId[i] = enbDev->GetCsgId();
+    }
+  }
+  g_featureUeCsgId.assign(numUes, 0);
+  for (uint32_t u = 0; u < numUes; ++u)
+  {
+    g_featureUeCsgId[u] = DynamicCast<LteUeNetDevice>(ueLteDevs.Get(u))->GetCsgId();
+  }
+  if (writeFile)
+  {
+    g_featureFile.open("comprehensive_features.bin", std::ios::binary);
+    WriteFeatureSchema(window);
+  }
+  Simulator::Schedule(window, &FlushFeatureWindows, window);
+}
+
+// ---------------------------------------------------------------------------
+// Rogue-aware A3 handover algorithm
+//
+// Drop-in replacement for A3RsrpHandoverAlgorithm (same A3 event, Hysteresis
+// and TimeToTrigger). Before a handover is triggered, the target gets a
+// suspicion score from X2 membership, the network-wide measurement history of
+// the cell and the detector blacklist. Suspicious targets are suppressed (or,
+// with a SuspicionPenalty, have their RSRP lowered by penalty * score) and the
+// next best candidate is used. Targets without an X2 link to the serving cell
+// are never prepared. Every suppressed plain-A3 decision is counted as an
+// avoided preparation.
+// ---------------------------------------------------------------------------
+
+static const uint32_t kSuspicionMinReports = 5;    // Reports before a cell's history counts
+static const double kWeakCellRsrpDbm = -110.0;     // Mean neighbour RSRP of a barely-serving cell
+static const double kSuspicionNoX2 = 0.6;
+static const double kSuspicionWeak = 0.5;  // Alone reaches the default threshold
+static const double kSuspicionUnknown = 0.2;
+
+// Measurement history of a cell, shared by the algorithm instances of all eNBs
+struct CellHistory
+{
+  double rsrpEwmaDbm = 0.0;
+  uint32_t reports = 0;
+};
+
+static bool g_rogueAwareHo = false;
+static std::vector<CellHistory> g_cellHistory;             // Indexed by cellId - 1
+static std::map<uint32_t, uint64_t> g_rntiToImsi;          // (cellId << 16 | rnti) -> IMSI
+
+// Avoided handover preparations and measured interruption of the ones that ran
+static uint64_t g_hoAvoidedNoX2 = 0;
+static uint64_t g_hoAvoidedSuspicious = 0;
+static uint64_t g_hoAvoidedBlacklisted = 0;
+static uint64_t g_hoAvoidedFaulty = 0;  // Avoided handovers (any reason) whose target was a FAULTY cell
+static uint64_t g_hoRedirected = 0;  // Overridden decisions that handed over to another target instead
+static std::map<uint64_t, Time> g_ueHoStartTime;
+static Time g_hoInterruptionTotal = Seconds(0);
+static uint64_t g_hoInterruptionCount = 0;
+
+class RogueAwareA3HandoverAlgorithm : public LteHandoverAlgorithm
+{
+public:
+  RogueAwareA3HandoverAlgorithm();
+  ~RogueAwareA3HandoverAlgorithm() override;
+
+  static TypeId GetTypeId();
+
+  void SetCellId(uint16_t cellId);
+
+  void SetLteHandoverManagementSapUser(LteHandoverManagementSapUser* s) override;
+  LteHandoverManagementSapProvider* GetLteHandoverManagementSapProvider() override;
+
+  friend class MemberLteHandoverManagementSapProvider<RogueAwareA3HandoverAlgorithm>;
+
+protected:
+  void DoInitialize() override;
+  void DoDispose() override;
+  void DoReportUeMeas(uint16_t rnti, LteRrcSap::MeasResults measResults) override;
+
+private:
+  double Suspicion(uint16_t targetCellId) const;
+  void RecordAvoided(uint16_t rnti, uint16_t plainTarget, uint16_t chosenTarget, double score);
+
+  double m_hysteresisDb;
+  Time m_timeToTrigger;
+  double m_suspicionThreshold;
+  double m_suspicionPenaltyDb;
+  uint16_t m_cellId;
+  std::vector<uint8_t> m_measIds;
+  std::map<uint16_t, std::pair<uint16_t, uint16_t>> m_suppressedTarget;  // rnti -> (plain, chosen) counted
+
+  LteHandoverManagementSapUser* m_handoverManagementSapUser;
+  LteHandoverManagementSapProvider* m_handoverManagementSapProvider;
+};
+
+NS_OBJECT_ENSURE_REGISTERED(RogueAwareA3HandoverAlgorithm);
+
+RogueAwareA3HandoverAlgorithm::RogueAwareA3HandoverAlgorithm()
+  : m_cellId(0),
+    m_handoverManagementSapUser(nullptr)
+{
+  m_handoverManagementSapProvider =
+    new MemberLteHandoverManagementSapProvider<RogueAwareA3HandoverAlgorithm>(this);
+}
+
+RogueAwareA3HandoverAlgorithm::~RogueAwareA3HandoverAlgorithm()
+{
+}
+
+TypeId
+RogueAwareA3HandoverAlgorithm::GetTypeId()
+{
+  static TypeId tid =
+    TypeId("ns3::RogueAwareA3HandoverAlgorithm")
+      .SetParent<LteHandoverAlgorithm>()
+      .SetGroupName("Lte")
+      .AddConstructor<RogueAwareA3HandoverAlgorithm>()
+      .AddAttribute("Hysteresis",
+                    "Handover margin (hysteresis) in dB (rounded to the nearest multiple of 0.5 dB)",
+                    DoubleValue(3.0),
+                    MakeDoubleAccessor(&RogueAwareA3HandoverAlgorithm::m_hysteresisDb),
+                    MakeDoubleChecker<uint8_t>(0.0, 15.0))
+      .AddAttribute("TimeToTrigger",
+                    "Time during which neighbour cell's RSRP must continuously be higher than "
+                    "serving cell's RSRP in order to trigger a handover",
+                    TimeValue(MilliSeconds(256)),
+                    MakeTimeAccessor(&RogueAwareA3HandoverAlgorithm::m_timeToTrigger),
+                    MakeTimeChecker())
+      .AddAttribute("SuspicionThreshold",
+                    "Targets with a suspicion score at or above this value are never prepared",
+                    DoubleValue(0.5),
+                    MakeDoubleAccessor(&RogueAwareA3HandoverAlgorithm::m_suspicionThreshold),
+                    MakeDoubleChecker<double>(0.0, 1.0))
+      .AddAttribute("SuspicionPenalty",
+                    "RSRP penalty in dB per unit of suspicion for targets below the threshold "
+                    "(0 = rank targets by RSRP only)",
+                    DoubleValue(0.0),
+                    MakeDoubleAccessor(&RogueAwareA3HandoverAlgorithm::m_suspicionPenaltyDb),
+                    MakeDoubleChecker<double>(0.0));
+  return tid;
+}
+
+void
+RogueAwareA3HandoverAlgorithm::SetCellId(uint16_t cellId)
+{
+  m_cellId = cellId;
+}
+
+void
+RogueAwareA3HandoverAlgorithm::SetLteHandoverManagementSapUser(LteHandoverManagementSapUser* s)
+{
+  m_handoverManagementSapUser = s;
+}
+
+LteHandoverManagementSapProvider*
+RogueAwareA3HandoverAlgorithm::GetLteHandoverManagementSapProvider()
+{
+  return m_handoverManagementSapProvider;
+}
+
+void
+RogueAwareA3HandoverAlgorithm::DoInitialize()
+{
+  uint8_t hysteresisIeValue = EutranMeasurementMapping::ActualHysteresis2IeValue(m_hysteresisDb);
+
+  LteRrcSap::ReportConfigEutra reportConfig;
+  reportConfig.eventId = LteRrcSap::ReportConfigEutra::EVENT_A3;
+  reportConfig.a3Offset = 0;
+  reportConfig.hysteresis = hysteresisIeValue;
+  reportConfig.timeToTrigger = m_timeToTrigger.GetMilliSeconds();
+  reportConfig.reportOnLeave = false;
+  reportConfig.triggerQuantity = LteRrcSap::ReportConfigEutra::RSRP;
+  reportConfig.reportInterval = LteRrcSap::ReportConfigEutra::MS1024;
+  m_measIds = m_handoverManagementSapUser->AddUeMeasReportConfigForHandover(reportConfig);
+
+  LteHandoverAlgorithm::DoInitialize();
+}
+
+void
+RogueAwareA3HandoverAlgorithm::DoDispose()
+{
+  delete m_handoverManagementSapProvider;
+}
+
+// 0 (trusted) .. 1 (certainly rogue)
+double
+RogueAwareA3HandoverAlgorithm::Suspicion(uint16_t targetCellId) const
+{
+  if (IsCellBlacklisted(targetCellId))
+  {
+    return 1.0;
+  }
+  double score = 0.0;
+  if (!HasX2Link(m_cellId, targetCellId))
+  {
+    score += kSuspicionNoX2;
+  }
+  const CellHistory& h = g_cellHistory[targetCellId - 1];
+  if (h.reports < kSuspicionMinReports)
+  {
+    score += kSuspicionUnknown;
+  }
+  else if (h.rsrpEwmaDbm < kWeakCellRsrpDbm)
+  {
+    score += kSuspicionWeak;
+  }
+  return std::min(score, 1.0);
+}
+
+// Count an overridden plain-A3 decision, once per UE and outcome. Only a
+// decision without any other target avoids a handover (and its interruption);
+// a redirect still hands over, just to another cell.
+void
+RogueAwareA3HandoverAlgorithm::RecordAvoided(uint16_t rnti, uint16_t plainTarget, uint16_t chosenTarget,
+                                             double score)
+{
+  auto it = m_suppressedTarget.find(rnti);
+  if (it != m_suppressedTarget.end() && it->second == std::make_pair(plainTarget, chosenTarget))
+  {
+    return;
+  }
+  m_suppressedTarget[rnti] = std::make_pair(plainTarget, chosenTarget);
+
+  std::string reason;
+  if (IsCellBlacklisted(plainTarget))
+  {
+    reason = "BLACKLISTED";
+  }
+  else if (!HasX2Link(m_cellId, plainTarget))
+  {
+    reason = "NO_X2";
+  }
+  else
+  {
+    reason = "SUSPICIOUS";
+  }
+  if (chosenTarget == 0 && g_baseStationTypes[plainTarget] == "FAULTY")
+  {
+    g_hoAvoidedFaulty++;
+  }
+  if (chosenTarget != 0)
+  {
+    g_hoRedirected++;
+  }
+  else if (reason == "BLACKLISTED")
+  {
+    g_hoAvoidedBlacklisted++;
+  }
+  else if (reason == "NO_X2")
+  {
+    g_hoAvoidedNoX2++;
+  }
+  else
+  {
+    g_hoAvoidedSuspicious++;
+  }
+
+  g_securityEventsFile << std::fixed << std::setprecision(6) << Simulator::Now().GetSeconds() << ","
+                       << "HO_SUPPRESSED,IMSI:" << g_rntiToImsi[uint32_t(m_cellId) << 16 | rnti]
+                       << ",Source:" << m_cellId << ",Target:" << plainTarget << "("
+                       << g_baseStationTypes[plainTarget] << "),Reason:" << reason
+                       << ",Suspicion:" << std::setprecision(2) << score
+                       << ",Redirected:" << chosenTarget << std::endl;
+}
+
+void
+RogueAwareA3HandoverAlgorithm::DoReportUeMeas(uint16_t rnti, LteRrcSap::MeasResults measResults)
+{
+  if (std::find(m_measIds.begin(), m_measIds.end(), measResults.measId) == m_measIds.end())
+  {
+    return;
+  }
+  if (!measResults.haveMeasResultNeighCells || measResults.measResultListEutra.empty())
+  {
+    m_suppressedTarget.erase(rnti);
+    return;
+  }
+
+  // Update the shared history first so the first report of a cell already counts
+  for (const auto& neigh : measResults.measResultListEutra)
+  {
+    if (neigh.haveRsrpResult && neigh.physCellId > 0 && neigh.physCellId <= g_cellHistory.size())
+    {
+      CellHistory& h = g_cellHistory[neigh.physCellId - 1];
+      double rsrpDbm = EutranMeasurementMapping::RsrpRange2Dbm(neigh.rsrpResult);
+      h.rsrpEwmaDbm = h.reports == 0 ? rsrpDbm : 0.9 * h.rsrpEwmaDbm + 0.1 * rsrpDbm;
+      h.reports++;
+    }
+  }
+
+  // Plain A3 picks the strongest reported neighbour; this variant picks the
+  // strongest one that survives the suspicion checks
+  uint16_t plainTarget = 0;
+  uint8_t plainRsrp = 0;
+  uint16_t chosenTarget = 0;
+  double chosenRsrpDbm = -1e9;
+  double plainScore = 0.0;
+  for (const auto& neigh : measResults.measResultListEutra)
+  {
+    if (!neigh.haveRsrpResult || neigh.physCellId == 0 || neigh.physCellId > g_cellHistory.size())
+    {
+      continue;
+    }
+    double score = Suspicion(neigh.physCellId);
+    if (plainTarget == 0 || neigh.rsrpResult > plainRsrp)
+    {
+      plainTarget = neigh.physCellId;
+      plainRsrp = neigh.rsrpResult;
+      plainScore = score;
+    }
+    if (score >= m_suspicionThreshold || !HasX2Link(m_cellId, neigh.physCellId))
+    {
+      continue;
+    }
+    double rankDbm = EutranMeasurementMapping::RsrpRange2Dbm(neigh.rsrpResult) - m_suspicionPenaltyDb * score;
+    if (rankDbm > chosenRsrpDbm)
+    {
+      chosenTarget = neigh.physCellId;
+      chosenRsrpDbm = rankDbm;
+    }
+  }
+
+  // A penalised target must still beat the serving cell
+  if (chosenTarget != 0 && m_suspicionPenaltyDb > 0
+      && chosenRsrpDbm <= EutranMeasurementMapping::RsrpRange2Dbm(measResults.measResultPCell.rsrpResult))
+  {
+    chosenTarget = 0;
+  }
+
+  if (plainTarget != 0 && chosenTarget != plainTarget)
+  {
+    RecordAvoided(rnti, plainTarget, chosenTarget, plainScore);
+  }
+  else
+  {
+    m_suppressedTarget.erase(rnti);
+  }
+  if (chosenTarget != 0)
+  {
+    HoTimingDecision(m_cellId, rnti, false);
+    m_handoverManagementSapUser->TriggerHandover(rnti, chosenTarget);
+  }
+}
+
+// ---------------------------------------------------------------------------
+// Predictive handover algorithm
+//
+// Reactive A3 starts the preparation only after a neighbour has been better
+// than the serving cell for a whole TimeToTrigger. This variant also configures
+// a periodic A4 report of all neighbours. It fits the recent RSRP trend of each
+// neighbour relative to the serving cell and extrapolates the UE trajectory
+// from its mobility model. When the trend predicts the A3 entry condition
+// within PredictionHorizon and the UE is moving towards the target site, the
+// handover to that target is prepared over X2 at once. The regular A3 report
+// remains the fallback. ns-3 runs preparation and execution as one step
+// (TriggerHandover), so a proactive decision prepares and executes early.
+// ---------------------------------------------------------------------------
+
+static const uint32_t kTrendSamples = 4;              // Reports per neighbour in the trend fit
+static const uint32_t kTrendMinSamples = 3;
+static const double kTrendMinSlopeDbPerS = 0.5;       // Slower convergence is not extrapolated
+static const double kTrendMaxGapDb = 6.0;             // Neighbours further behind are never prepared early
+static const Time kPingPongWindow = Seconds(1.0);
+
+static bool g_predictiveHo = false;
+static NodeContainer g_predictiveUeNodes;             // [imsi - 1], for trajectory extrapolation
+static uint64_t g_predProactive = 0;                  // Handovers prepared ahead of the A3 trigger
+static uint64_t g_predReactive = 0;                   // Fallback decisions on the A3 report
+static uint64_t g_predTrendReports = 0;               // Extra periodic measurement reports
+static uint64_t g_predPingPongs = 0;                  // Proactive handovers reverted within kPingPongWindow
+static double g_predLeadSeconds = 0.0;                // Estimated lead over the A3 trigger, summed
+static double g_predDecisionRsrpDbm[2] = {0.0, 0.0};  // Serving RSRP at decision, summed [reactive, proactive]
+
+// Handover timing of every algorithm, for the comparison with plain A3
+struct LastHandover
+{
+  Time time;
+  uint16_t sourceCellId;
+  uint16_t targetCellId;
+  bool proactive;
+};
+
+static std::map<uint64_t, double> g_lastServingRsrpDbm;  // IMSI -> last reported serving RSRP
+static std::map<uint64_t, LastHandover> g_lastHandover;  // IMSI -> last decision of the predictive algorithm
+static double g_hoStartRsrpSum = 0.0;
+static uint64_t g_hoStartRsrpCount = 0;
+static uint64_t g_hoFailures = 0;
+
+class PredictiveHandoverAlgorithm : public LteHandoverAlgorithm
+{
+public:
+  PredictiveHandoverAlgorithm();
+  ~PredictiveHandoverAlgorithm() override;
+
+  static TypeId GetTypeId();
+
+  void SetCellId(uint16_t cellId);
+
+  void SetLteHandoverManagementSapUser(LteHandoverManagementSapUser* s) override;
+  LteHandoverManagementSapProvider* GetLteHandoverManagementSapProvider() override;
+
+  friend class MemberLteHandoverManagementSapProvider<PredictiveHandoverAlgorithm>;
+
+protected:
+  void DoInitialize() override;
+  void DoDispose() override;
+  void DoReportUeMeas(uint16_t rnti, LteRrcSap::MeasResults measResults) override;
+
+private:
+  // Neighbour minus serving RSRP over the last reports of one UE and neighbour
+  struct Trend
+  {
+    double timeS[kTrendSamples];
+    double deltaDb[kTrendSamples];
+    uint32_t count = 0;
+
+    void Add(double t, double delta);
+    double Slope() const;
+  };
+
+  void UpdateTrends(uint16_t rnti, const LteRrcSap::MeasResults& measResults);
+  bool MovingTowards(uint64_t imsi, uint16_t targetCellId) const;
+  void Decide(uint16_t rnti, uint16_t targetCellId, bool proactive, double servingRsrpDbm, double leadS);
+
+  double m_hysteresisDb;
+  Time m_timeToTrigger;
+  Time m_predictionHorizon;
+  uint16_t m_cellId;
+  std::vector<uint8_t> m_a3MeasIds;
+  std::vector<uint8_t> m_trendMeasIds;
+  std::map<uint16_t, std::map<uint16_t, Trend>> m_trends;  // rnti -> neighbour cellId -> trend
+  std::map<uint16_t, Time> m_lastDecision;                 // rnti -> time of the last TriggerHandover
+
+  LteHandoverManagementSapUser* m_handoverManagementSapUser;
+  LteHandoverManagementSapProvider* m_handoverManagementSapProvider;
+};
+
+NS_OBJECT_ENSURE_REGISTERED(PredictiveHandoverAlgorithm);
+
+void
+PredictiveHandoverAlgorithm::Trend::Add(double t, double delta)
+{
+  if (count == kTrendSamples)
+  {
+    std::copy(timeS + 1, timeS + kTrendSamples, timeS);
+    std::copy(deltaDb + 1, deltaDb + kTrendSamples, deltaDb);
+    count--;
+  }
+  timeS[count] = t;
+  deltaDb[count] = delta;
+  count++;
+}
+
+// Least-squares slope in dB/s
+double
+PredictiveHandoverAlgorithm::Trend::Slope() const
+{
+  double mt = 0.0;
+  double md = 0.0;
+  for (uint32_t i = 0; i < count; ++i)
+  {
+    mt += timeS[i] / count;
+    md += deltaDb[i] / count;
+  }
+  double stt = 0.0;
+  double stdd = 0.0;
+  for (uint32_t i = 0; i < count; ++i)
+  {
+    stt += (timeS[i] - mt) * (timeS[i] - mt);
+    stdd += (timeS[i] - mt) * (deltaDb[i] - md);
+  }
+  return stt > 0.0 ? stdd / stt : 0.0;
+}
+
+PredictiveHandoverAlgorithm::PredictiveHandoverAlgorithm()
+  : m_cellId(0),
+    m_handoverManagementSapUser(nullptr)
+{
+  m_handoverManagementSapProvider =
+    new MemberLteHandoverManagementSapProvider<PredictiveHandoverAlgorithm>(this);
+}
+
+PredictiveHandoverAlgorithm::~PredictiveHandoverAlgorithm()
+{
+}
+
+TypeId
+PredictiveHandoverAlgorithm::GetTypeId()
+{
+  static TypeId tid =
+    TypeId("ns3::PredictiveHandoverAlgorithm")
+      .SetParent<LteHandoverAlgorithm>()
+      .SetGroupName("Lte")
+      .AddConstructor<PredictiveHandoverAlgorithm>()
+      .AddAttribute("Hysteresis",
+                    "Handover margin (hysteresis) in dB (rounded to the nearest multiple of 0.5 dB)",
+                    DoubleValue(3.0),
+                    MakeDoubleAccessor(&PredictiveHandoverAlgorithm::m_hysteresisDb),
+                    MakeDoubleChecker<uint8_t>(0.0, 15.0))
+      .AddAttribute("TimeToTrigger",
+                    "Time during which neighbour cell's RSRP must continuously be higher than "
+                    "serving cell's RSRP in order to trigger a reactive handover",
+                    TimeValue(MilliSeconds(256)),
+                    MakeTimeAccessor(&PredictiveHandoverAlgorithm::m_timeToTrigger),
+                    MakeTimeChecker())
+      .AddAttribute("PredictionHorizon",
+                    "Prepare the handover when the RSRP trend predicts the A3 entry condition "
+                    "within this time",
+                    TimeValue(MilliSeconds(500)),
+                    MakeTimeAccessor(&PredictiveHandoverAlgorithm::m_predictionHorizon),
+                    MakeTimeChecker());
+  return tid;
+}
+
+void
+PredictiveHandoverAlgorithm::SetCellId(uint16_t cellId)
+{
+  m_cellId = cellId;
+}
+
+void
+PredictiveHandoverAlgorithm::SetLteHandoverManagementSapUser(LteHandoverManagementSapUser* s)
+{
+  m_handoverManagementSapUser = s;
+}
+
+LteHandoverManagementSapProvider*
+PredictiveHandoverAlgorithm::GetLteHandoverManagementSapProvider()
+{
+  return m_handoverManagementSapProvider;
+}
+
+void
+PredictiveHandoverAlgorithm::DoInitialize()
+{
+  LteRrcSap::ReportConfigEutra a3Config;
+  a3Config.eventId = LteRrcSap::ReportConfigEutra::EVENT_A3;
+  a3Config.a3Offset = 0;
+  a3Config.hysteresis = EutranMeasurementMapping::ActualHysteresis2IeValue(m_hysteresisDb);
+  a3Config.timeToTrigger = m_timeToTrigger.GetMilliSeconds();
+  a3Config.reportOnLeave = false;
+  a3Config.triggerQuantity = LteRrcSap::ReportConfigEutra::RSRP;
+  a3Config.reportInterval = LteRrcSap::ReportConfigEutra::MS1024;
+  m_a3MeasIds = m_handoverManagementSapUser->AddUeMeasReportConfigForHandover(a3Config);
+
+  // A4 with the lowest threshold reports every neighbour periodically
+  LteRrcSap::ReportConfigEutra trendConfig;
+  trendConfig.eventId = LteRrcSap::ReportConfigEutra::EVENT_A4;
+  trendConfig.threshold1.choice = LteRrcSap::ThresholdEutra::THRESHOLD_RSRP;
+  trendConfig.threshold1.range = 0;
+  trendConfig.triggerQuantity = LteRrcSap::ReportConfigEutra::RSRP;
+  trendConfig.reportInterval = LteRrcSap::ReportConfigEutra::MS240;
+  m_trendMeasIds = m_handoverManagementSapUser->AddUeMeasReportConfigForHandover(trendConfig);
+
+  LteHandoverAlgorithm::DoInitialize();
+}
+
+void
+PredictiveHandoverAlgorithm::DoDispose()
+{
+  delete m_handoverManagementSapProvider;
+}
+
+void
+PredictiveHandoverAlgorithm::UpdateTrends(uint16_t rnti, const LteRrcSap::MeasResults& measResults)
+{
+  double now = Simulator::Now().GetSeconds();
+  double servingDbm = EutranMeasurementMapping::RsrpRange2Dbm(measResults.measResultPCell.rsrpResult);
+  std::map<uint16_t, Trend>& trends = m_trends[rnti];
+  for (const auto& neigh : measResults.measResultListEutra)
+  {
+    if (neigh.haveRsrpResult && neigh.physCellId != m_cellId)
+    {
+      trends[neigh.physCellId].Add(now, EutranMeasurementMapping::RsrpRange2Dbm(neigh.rsrpResult) - servingDbm);
+    }
+  }
+}
+
+// True if the UE approaches the target site faster than the serving site
+bool
+PredictiveHandoverAlgorithm::MovingTowards(uint64_t imsi, uint16_t targetCellId) const
+{
+  if (imsi == 0 || imsi > g_predictiveUeNodes.GetN() || targetCellId > g_cellSites.size()
+      || m_cellId == 0 || m_cellId > g_cellSites.size())
+  {
+    return false;
+  }
+  Ptr<MobilityModel> mobility = g_predictiveUeNodes.Get(imsi - 1)->GetObject<MobilityModel>();
+  Vector p = mobility->GetPosition();
+  Vector v = mobility->GetVelocity();
+  auto closingSpeed = [&p, &v](const Vector& site) {
+    double d = CalculateDistance(p, site);
+    return d > 0.0 ? (v.x * (site.x - p.x) + v.y * (site.y - p.y)) / d : 0.0;
+  };
+  double towardsTarget = closingSpeed(g_cellSites[targetCellId - 1].position);
+  return towardsTarget > 0.0 && towardsTarget > closingSpeed(g_cellSites[m_cellId - 1].position);
+}
+
+void
+PredictiveHandoverAlgorithm::Decide(uint16_t rnti, uint16_t targetCellId, bool proactive, double servingRsrpDbm,
+                                    double leadS)
+{
+  Time now = Simulator::Now();
+  m_lastDecision[rnti] = now;
+  m_trends.erase(rnti);
+
+  uint64_t imsi = g_rntiToImsi[uint32_t(m_cellId) << 16 | rnti];
+  auto last = g_lastHandover.find(imsi);
+  if (last != g_lastHandover.end() && last->second.proactive && now - last->second.time <= kPingPongWindow
+      && last->second.sourceCellId == targetCellId && last->second.targetCellId == m_cellId)
+  {
+    g_predPingPongs++;
+  }
+  g_lastHandover[imsi] = {now, m_cellId, targetCellId, proactive};
+
+  if (proactive)
+  {
+    g_predProactive++;
+    g_predLeadSeconds += leadS;
+  }
+  else
+  {
+    g_predReactive++;
+  }
+  g_predDecisionRsrpDbm[proactive ? 1 : 0] += servingRsrpDbm;
+  HoTimingDecision(m_cellId, rnti, false);
+  m_handoverManagementSapUser->TriggerHandover(rnti, targetCellId);
+}
+
+void
+PredictiveHandoverAlgorithm::DoReportUeMeas(uint16_t rnti, LteRrcSap::MeasResults measResults)
+{
+  bool isA3 = std::find(m_a3MeasIds.begin(), m_a3MeasIds.end(), measResults.measId) != m_a3MeasIds.end();
+  bool isTrend = std::find(m_trendMeasIds.begin(), m_trendMeasIds.end(), measResults.measId) != m_trendMeasIds.end();
+  if (!isA3 && !isTrend)
+  {
+    return;
+  }
+  if (isTrend)
+  {
+    g_predTrendReports++;
+  }
+  if (!measResults.haveMeasResultNeighCells || measResults.measResultListEutra.empty())
+  {
+    return;
+  }
+  auto last = m_lastDecision.find(rnti);
+  if (last != m_lastDecision.end() && Simulator::Now() - last->second < kHoGuardTime)
+  {
+    return;
+  }
+  double servingDbm = EutranMeasurementMapping::RsrpRange2Dbm(measResults.measResultPCell.rsrpResult);
+
+  // Reactive fallback: the A3 condition held for TimeToTrigger, same choice as plain A3
+  if (isA3)
+  {
+    uint16_t bestCell = 0;
+    uint8_t bestRsrp = 0;
+    for (const auto& neigh : measResults.measResultListEutra)
+    {
+      if (neigh.haveRsrpResult && (bestCell == 0 || neigh.rsrpResult > bestRsrp))
+      {
+        bestCell = neigh.physCellId;
+        bestRsrp = neigh.rsrpResult;
+      }
+    }
+    if (bestCell != 0)
+    {
+      Decide(rnti, bestCell, false, servingDbm, 0.0);
+    }
+    return;
+  }
+
+  // Proactive: extrapolate each X2 neighbour's margin to the A3 entry condition
+  UpdateTrends(rnti, measResults);
+  uint64_t imsi = g_rntiToImsi[uint32_t(m_cellId) << 16 | rnti];
+  uint16_t target = 0;
+  double targetCrossingS = m_predictionHorizon.GetSeconds();
+  for (const auto& entry : m_trends[rnti])
+  {
+    const Trend& trend = entry.second;
+    if (trend.count < kTrendMinSamples || !HasX2Link(m_cellId, entry.first))
+    {
+      continue;
+    }
+    double delta = trend.deltaDb[trend.count - 1];
+    double slope = trend.Slope();
+    if (delta < -kTrendMaxGapDb || slope < kTrendMinSlopeDbPerS)
+    {
+      continue;
+    }
+    double crossingS = std::max(0.0, (m_hysteresisDb - delta) / slope);
+    if (crossingS <= targetCrossingS && MovingTowards(imsi, entry.first))
+    {
+      target = entry.first;
+      targetCrossingS = crossingS;
+    }
+  }
+  if (target != 0)
+  {
+    // A3 would have fired TimeToTrigger after the predicted entry
+    Decide(rnti, target, true, servingDbm, targetCrossingS + m_timeToTrigger.GetSeconds());
+  }
+}
+
+// ---------------------------------------------------------------------------
+// X2 / S1 signalling tracer
+//
+// Taps the eNB-to-eNB X2 links and the MME-SGW S11 link at the point-to-point
+// devices and decodes the X2AP and GTP-C headers. Together with the RRC traces
+// this gives a timestamp for every stage of a handover, kept in a fixed
+// per-IMSI pending table. A record starts when the source sends the X2
+// Handover Request, stamped with the handover algorithm's decision time.
+// Completed handovers are written one row each and folded into
+// stage-latency histograms per source/target class pair. S1-AP
+// (PathSwitchRequest) is a direct SAP call in ns-3, so the S1 path switch is
+// observed through the S11 ModifyBearer exchange it triggers.
+// ---------------------------------------------------------------------------
+
+enum SignallingStage : uint8_t
+{
+  SIG_DECISION = 0,      // Handover algorithm decision (X2 Handover Request if unknown)
+  SIG_X2_HO_REQUEST,     // X2AP Handover Request sent by the source
+  SIG_X2_HO_ACK,         // X2AP Handover Request Acknowledge sent by the target
+  SIG_RRC_RECONF,        // UE receives the RRC reconfiguration (handover command)
+  SIG_SN_STATUS,         // X2AP SN Status Transfer sent by the source
+  SIG_HO_COMPLETE,       // Target eNB receives the reconfiguration complete
+  SIG_S11_MB_REQUEST,    // S11 Modify Bearer Request (MME -> SGW)
+  SIG_S11_MB_RESPONSE,   // S11 Modify Bearer Response (SGW -> MME)
+  SIG_X2_UE_RELEASE,     // X2AP UE Context Release sent by the target
+  kNumSignallingStages
+};
+
+static const char* const kSignallingStageNames[kNumSignallingStages] = {
+  "decision", "x2HoRequest", "x2HoAck", "rrcReconf", "snStatus",
+  "hoComplete", "s11MbRequest", "s11MbResponse", "x2UeRelease"};
+
+// Stage latencies reported in the histograms
+struct SignallingInterval
+{
+  const char* name;
+  SignallingStage from;
+  SignallingStage to;
+};
+
+static const SignallingInterval kSignallingIntervals[] = {
+  {"x2_preparation", SIG_X2_HO_REQUEST, SIG_X2_HO_ACK},
+  {"rrc_reconfiguration", SIG_X2_HO_ACK, SIG_RRC_RECONF},
+  {"sn_status_transfer", SIG_X2_HO_ACK, SIG_SN_STATUS},
+  {"ue_access", SIG_RRC_RECONF, SIG_HO_COMPLETE},
+  {"s1_path_switch", SIG_HO_COMPLETE, SIG_S11_MB_RESPONSE},
+  {"ue_context_release", SIG_S11_MB_RESPONSE, SIG_X2_UE_RELEASE},
+  {"total", SIG_DECISION, SIG_X2_UE_RELEASE}};
+static const size_t kNumSignallingIntervals = sizeof(kSignallingIntervals) / sizeof(kSignallingIntervals[0]);
+
+// Histogram bin upper edges in ms; the last bin is open
+static const double kSignallingBinEdgesMs[] = {0.5, 1, 2, 5, 10, 20, 50, 100, 200, 500, 1000};
+static const size_t kNumSignallingBins = sizeof(kSignallingBinEdgesMs) / sizeof(kSignallingBinEdgesMs[0]) + 1;
+
+static const uint16_t kGtpcUdpPort = 2123;
+
+struct SignallingPending
+{
+  bool active = false;
+  uint16_t sourceCellId = 0;
+  uint16_t targetCellId = 0;
+  int64_t stampNs[kNumSignallingStages];
+  uint16_t x2Messages = 0;
+  uint32_t x2Bytes = 0;
+  uint16_t s11Messages = 0;
+};
+
+static bool g_sigEnabled = false;
+static std::vector<SignallingPending> g_sigPending;               // [imsi - 1]
+static std::map<uint32_t, uint64_t> g_sigX2apToImsi;              // (source cellId << 16 | old X2AP id) -> IMSI
+static std::map<uint32_t, uint16_t> g_sigNodeCell;                // eNB node id -> cellId
+static std::map<std::string, std::vector<uint64_t>> g_sigHistograms;  // class pair -> [interval][bin]
+static std::ofstream g_signallingFile;
+static uint64_t g_sigX2Messages = 0;
+static uint64_t g_sigX2Bytes = 0;
+static uint64_t g_sigS11Messages = 0;
+static uint64_t g_sigCompleted = 0;
+static uint64_t g_sigIncomplete = 0;
+static uint64_t g_sigUnmatched = 0;
+
+static SignallingPending* SignallingEntry(uint64_t imsi)
+{
+  if (!g_sigEnabled || imsi == 0 || imsi > g_sigPending.size() || !g_sigPending[imsi - 1].active)
+  {
+    return nullptr;
+  }
+  return &g_sigPending[imsi - 1];
+}
+
+static void SignallingBegin(uint64_t imsi, uint16_t sourceCellId, uint16_t targetCellId, Time decisionTime)
+{
+  if (!g_sigEnabled || imsi == 0 || imsi > g_sigPending.size())
+  {
+    return;
+  }
+  SignallingPending& e = g_sigPending[imsi - 1];
+  if (e.active)
+  {
+    g_sigIncomplete++;  // Previous handover never released its context (failed or cancelled)
+  }
+  e = SignallingPending();
+  e.active = true;
+  e.sourceCellId = sourceCellId;
+  e.targetCellId = targetCellId;
+  std::fill(e.stampNs, e.stampNs + kNumSignallingStages, -1);
+  e.stampNs[SIG_DECISION] = decisionTime.GetNanoSeconds();
+}
+
+// Write the finished handover and add its stage latencies to the histograms
+static void SignallingFinish(uint64_t imsi, SignallingPending& e)
+{
+  std::string pair = g_baseStationTypes[e.sourceCellId] + "->" + g_baseStationTypes[e.targetCellId];
+  std::vector<uint64_t>& hist = g_sigHistograms[pair];
+  hist.resize(kNumSignallingIntervals * kNumSignallingBins, 0);
+
+  g_signallingFile << imsi << "," << e.sourceCellId << "," << e.targetCellId << "," << pair;
+  for (size_t s = 0; s < kNumSignallingStages; ++s)
+  {
+    g_signallingFile << ",";
+    if (e.stampNs[s] >= 0)
+    {
+      g_signallingFile << std::fixed << std::setprecision(6) << e.stampNs[s] * 1e-9;
+    }
+  }
+  for (size_t i = 0; i < kNumSignallingIntervals; ++i)
+  {
+    const SignallingInterval& iv = kSignallingIntervals[i];
+    g_signallingFile << ",";
+    if (e.stampNs[iv.from] < 0 || e.stampNs[iv.to] < 0)
+    {
+      continue;
+    }
+    double ms = (e.stampNs[iv.to] - e.stampNs[iv.from]) * 1e-6;
+    g_signallingFile << std::setprecision(3) << ms;
+    size_t bin = 0;
+    while (bin < kNumSignallingBins - 1 && ms >= kSignallingBinEdgesMs[bin])
+    {
+      bin++;
+    }
+    hist[i * kNumSignallingBins + bin]++;
+  }
+  g_signallingFile << "," << e.x2Messages << "," << e.x2Bytes << "," << e.s11Messages << "\n";
+
+  g_sigCompleted++;
+  e.active = false;
+}
+
+static void SignallingStamp(uint64_t imsi, SignallingStage stage)
+{
+  SignallingPending* e = SignallingEntry(imsi);
+  if (e && e->stampNs[stage] < 0)
+  {
+    e->stampNs[stage] = Simulator::Now().GetNanoSeconds();
+  }
+}
+
+// MacTx of an X2 device: the packet still carries its IPv4 and UDP headers
+static void SignallingX2Tx(uint16_t senderCellId, uint16_t peerCellId, Ptr<const Packet> p)
+{
+  HeapScope heapScope(kHeapSignalling);
+  Ptr<Packet> packet = p->Copy();
+  Ipv4Header ipHeader;
+  packet->RemoveHeader(ipHeader);
+  UdpHeader udpHeader;
+  packet->RemoveHeader(udpHeader);
+  if (udpHeader.GetDestinationPort() == kX2uUdpPort)
+  {
+    return;
+  }
+  g_sigX2Messages++;
+  g_sigX2Bytes += p->GetSize();
+
+  EpcX2Header x2Header;
+  packet->RemoveHeader(x2Header);
+  uint8_t procedure = x2Header.GetProcedureCode();
+  uint8_t type = x2Header.GetMessageType();
+
+  uint64_t imsi = 0;
+  SignallingStage stage = kNumSignallingStages;
+  if (procedure == EpcX2Header::HandoverPreparation && type == EpcX2Header::InitiatingMessage)
+  {
+    EpcX2HandoverRequestHeader req;
+    packet->RemoveHeader(req);
+    imsi = req.GetMmeUeS1apId();
+    // The old X2AP id is the UE's RNTI in the source cell
+    uint32_t key = uint32_t(senderCellId) << 16 | req.GetOldEnbUeX2apId();
+    g_sigX2apToImsi[key] = imsi;
+    auto decision = g_hoDecisions.find(key);
+    SignallingBegin(imsi, senderCellId, peerCellId,
+                    decision != g_hoDecisions.end() ? decision->second.time : Simulator::Now());
+    stage = SIG_X2_HO_REQUEST;
+  }
+  else
+  {
+    uint32_t key = 0;
+    if (procedure == EpcX2Header::HandoverPreparation && type == EpcX2Header::SuccessfulOutcome)
+    {
+      EpcX2HandoverRequestAckHeader ack;
+      packet->RemoveHeader(ack);
+      key = uint32_t(peerCellId) << 16 | ack.GetOldEnbUeX2apId();
+      stage = SIG_X2_HO_ACK;
+    }
+    else if (procedure == EpcX2Header::SnStatusTransfer)
+    {
+      EpcX2SnStatusTransferHeader sn;
+      packet->RemoveHeader(sn);
+      key = uint32_t(senderCellId) << 16 | sn.GetOldEnbUeX2apId();
+      stage = SIG_SN_STATUS;
+    }
+    else if (procedure == EpcX2Header::UeContextRelease)
+    {
+      EpcX2UeContextReleaseHeader release;
+      packet->RemoveHeader(release);
+      key = uint32_t(peerCellId) << 16 | release.GetOldEnbUeX2apId();
+      stage = SIG_X2_UE_RELEASE;
+    }
+    else
+    {
+      return;  // Load indication, resource status: counted only
+    }
+    auto it = g_sigX2apToImsi.find(key);
+    if (it == g_sigX2apToImsi.end())
+    {
+      g_sigUnmatched++;
+      return;
+    }
+    imsi = it->second;
+    if (stage == SIG_X2_UE_RELEASE)
+    {
+      g_sigX2apToImsi.erase(it);
+    }
+  }
+
+  SignallingPending* e = SignallingEntry(imsi);
+  if (!e)
+  {
+    g_sigUnmatched++;
+    return;
+  }
+  e->x2Messages++;
+  e->x2Bytes += p->GetSize();
+  SignallingStamp(imsi, stage);
+  if (stage == SIG_X2_UE_RELEASE)
+  {
+    SignallingFinish(imsi, *e);
+  }
+}
+
+// S11 GTP-C between MME and SGW. The request carries the IMSI; the SGW
+// answers with the IMSI as MME-side TEID. MacTx sees the packet before the
+// PPP header is added, MacRx before it is removed.
+static void SignallingS11(bool received, Ptr<const Packet> p)
+{
+  HeapScope heapScope(kHeapSignalling);
+  Ptr<Packet> packet = p->Copy();
+  if (received)
+  {
+    PppHeader pppHeader;
+    packet->RemoveHeader(pppHeader);
+  }
+  Ipv4Header ipHeader;
+  packet->RemoveHeader(ipHeader);
+  UdpHeader udpHeader;
+  packet->RemoveHeader(udpHeader);
+  if (udpHeader.GetDestinationPort() != kGtpcUdpPort && udpHeader.GetSourcePort() != kGtpcUdpPort)
+  {
+    return;
+  }
+  g_sigS11Messages++;
+
+  GtpcHeader gtpc;
+  packet->PeekHeader(gtpc);
+  uint64_t imsi = 0;
+  SignallingStage stage;
+  if (gtpc.GetMessageType() == GtpcHeader::ModifyBearerRequest)
+  {
+    GtpcModifyBearerRequestMessage msg;
+    packet->RemoveHeader(msg);
+    imsi = msg.GetImsi();
+    stage = SIG_S11_MB_REQUEST;
+  }
+  else if (gtpc.GetMessageType() == GtpcHeader::ModifyBearerResponse)
+  {
+    imsi = gtpc.GetTeid();
+    stage = SIG_S11_MB_RESPONSE;
+  }
+  else
+  {
+    return;  // Session creation at attach
+  }
+  SignallingPending* e = SignallingEntry(imsi);
+  if (e)
+  {
+    e->s11Messages++;
+    SignallingStamp(imsi, stage);
+  }
+}
+
+static void WriteSignallingHistograms()
+{
+  std::ofstream histFile("comprehensive_signalling_histograms.csv");
+  histFile << "classPair,stage,binLowMs,binHighMs,count\n";
+  for (const auto& entry : g_sigHistograms)
+  {
+    for (size_t i = 0; i < kNumSignallingIntervals; ++i)
+    {
+      for (size_t b = 0; b < kNumSignallingBins; ++b)
+      {
+        histFile << entry.first << "," << kSignallingIntervals[i].name << ","
+                 << (b == 0 ? 0.0 : kSignallingBinEdgesMs[b - 1]) << ",";
+        if (b < kNumSignallingBins - 1)
+        {
+          histFile << kSignallingBinEdgesMs[b];
+        }
+        histFile << "," << entry.second[i * kNumSignallingBins + b] << "\n";
+      }
+    }
+  }
+}
+
+// Hook the X2 devices of every eNB and the S11 device of the SGW (the SGW link
+// whose peer is neither the PGW nor an eNB)
+static void SetupSignallingTracer(NodeContainer enbNodes, Ptr<Node> sgw, Ptr<Node> pgw, uint32_t numUes)
+{
+  g_sigEnabled = true;
+  g_sigPending.assign(numUes, SignallingPending());
+  for (uint32_t i = 0; i < enbNodes.GetN(); ++i)
+  {
+    g_sigNodeCell[enbNodes.Get(i)->GetId()] = i + 1;
+  }
+
+  ForEachX2Device(enbNodes, [](Ptr<PointToPointNetDevice> p2p, uint32_t enbIndex, uint32_t peerIndex) {
+    p2p->TraceConnectWithoutContext("MacTx", MakeBoundCallback(&SignallingX2Tx, uint16_t(enbIndex + 1),
+                                                               uint16_t(peerIndex + 1)));
+  });
+
+  for (uint32_t d = 0; d < sgw->GetNDevices(); ++d)
+  {
+    Ptr<PointToPointNetDevice> p2p = DynamicCast<PointToPointNetDevice>(sgw->GetDevice(d));
+    Ptr<Node> peer = p2p ? PeerNode(p2p) : nullptr;
+    if (peer && peer != pgw && !g_sigNodeCell.count(peer->GetId()))
+    {
+      p2p->TraceConnectWithoutContext("MacTx", MakeBoundCallback(&SignallingS11, false));
+      p2p->TraceConnectWithoutContext("MacRx", MakeBoundCallback(&SignallingS11, true));
+    }
+  }
+
+  g_signallingFile.open("comprehensive_signalling_stages.csv");
+  g_signallingFile << "imsi,sourceCellId,targetCellId,classPair";
+  for (size_t s = 0; s < kNumSignallingStages; ++s)
+  {
+    g_signallingFile << "," << kSignallingStageNames[s];
+  }
+  for (size_t i = 0; i < kNumSignallingIntervals; ++i)
+  {
+    g_signallingFile << "," << kSignallingIntervals[i].name << "Ms";
+  }
+  g_signallingFile << ",x2Messages,x2Bytes,s11Messages\n";
+}
+
+// Class column of the RRC event stream
+static std::string RrcCellType(uint16_t cellId)
+{
+  return g_baseStationTypes[cellId];
+}
+
+// The stream's buffers and chunks are credited to the rrc-stream heap tag
+static void RecordTaggedRrcEvent(RrcEventType type, uint8_t side, uint64_t imsi, uint16_t cellId, uint16_t rnti,
+                                 uint16_t targetCellId = 0)
+{
+  HeapScope heapScope(kHeapRrcStream);
+  RecordRrcEvent(type, side, imsi, cellId, rnti, targetCellId);
+}
+
+// ---------------------------------------------------------------------------
+// UE state store and snapshot matrix
+//
+// The RRC, measurement report and downlink receive callbacks keep the current
+// state of every UE in flat per-UE arrays. At every snapshot tick the arrays
+// are appended as one fixed-width row, so comprehensive_ue_state.bin is a
+// contiguous time x UE matrix: memory-mapping it with the dtype from
+// comprehensive_ue_state.schema.json turns state queries (e.g. the fraction of
+// UEs served by FAULTY cells over time) into array slicing.
+// ---------------------------------------------------------------------------
+
+enum UeRrcState : uint8_t
+{
+  UE_STATE_IDLE = 0,       // Not connected: before attach, or after a failed handover or radio link failure
+  UE_STATE_CONNECTED = 1,
+  UE_STATE_HANDOVER = 2,   // Between HandoverStart and HandoverEndOk at the eNB
+};
+
+static const uint8_t kUeStateNoRsrp = 255;  // No serving RSRP reported yet
+
+struct UeStateStore
+{
+  std::vector<uint16_t> servingCellId;  // [imsi - 1], 0 = not attached
+  std::vector<uint8_t> rrcState;        // UeRrcState
+  std::vector<uint8_t> rsrpBucket;      // Last reported serving RSRP, 36.331 range 0..97
+  std::vector<uint32_t> intervalBytes;  // Downlink bytes received since the previous row
+};
+
+static UeStateStore g_ueState;
+static std::ofstream g_ueStateFile;
+static uint64_t g_ueStateRows = 0;
+static Time g_ueStateRowTime = Seconds(0);  // Time of the last row
+
+static void UeStateSetCell(uint64_t imsi, uint16_t cellId, UeRrcState state)
+{
+  if (imsi == 0 || imsi > g_ueState.rrcState.size())
+  {
+    return;
+  }
+  if (cellId != 0)
+  {
+    g_ueState.servingCellId[imsi - 1] = cellId;
+  }
+  g_ueState.rrcState[imsi - 1] = state;
+}
+
+// The UE lost its connection; it is connected again at its next ConnectionEstablished
+static void UeStateDetach(uint64_t imsi)
+{
+  if (imsi != 0 && imsi <= g_ueState.rrcState.size())
+  {
+    g_ueState.servingCellId[imsi - 1] = 0;
+    g_ueState.rrcState[imsi - 1] = UE_STATE_IDLE;
+  }
+}
+
+static void UeStateSetRsrp(uint64_t imsi, uint8_t rsrpBucket)
+{
+  if (imsi != 0 && imsi <= g_ueState.rsrpBucket.size())
+  {
+    g_ueState.rsrpBucket[imsi - 1] = rsrpBucket;
+  }
+}
+
+static void UeStateRx(uint32_t ueIndex, Ptr<const Packet> packet)
+{
+  g_ueState.intervalBytes[ueIndex] += packet->GetSize();
+}
+
+// Append the current state of all UEs as one row and reset the interval counters
+static void AppendUeStateRow()
+{
+  double now = Simulator::Now().GetSeconds();
+  size_t numUes = g_ueState.rrcState.size();
+  g_ueStateFile.write(reinterpret_cast<const char*>(&now), sizeof(now));
+  g_ueStateFile.write(reinterpret_cast<const char*>(g_ueState.servingCellId.data()), numUes * sizeof(uint16_t));
+  g_ueStateFile.write(reinterpret_cast<const char*>(g_ueState.rrcState.data()), numUes * sizeof(uint8_t));
+  g_ueStateFile.write(reinterpret_cast<const char*>(g_ueState.rsrpBucket.data()), numUes * sizeof(uint8_t));
+  g_ueStateFile.write(reinterpret_cast<const char*>(g_ueState.intervalBytes.data()), numUes * sizeof(uint32_t));
+  std::fill(g_ueState.intervalBytes.begin(), g_ueState.intervalBytes.end(), 0);
+  g_ueStateRows++;
+  g_ueStateRowTime = Simulator::Now();
+}
+
+static void WriteUeStateRow(Time interval)
+{
+  AppendUeStateRow();
+  Simulator::Schedule(interval, &WriteUeStateRow, interval);
+}
+
+// At the end of the run: append the row of the partial interval since the last one
+static void WriteFinalUeStateRow()
+{
+  if (g_ueStateFile.is_open() && Simulator::Now() > g_ueStateRowTime)
+  {
+    AppendUeStateRow();
+  }
+}
+
+static void WriteUeStateSchema(uint32_t numUes, Time interval)
+{
+  std::ofstream schema("comprehensive_ue_state.schema.json");
+  schema << "{\n"
+         << "  \"file\": \"comprehensive_ue_state.bin\",\n"
+         << "  \"byteOrder\": \"little\",\n"
+         << "  \"recordSize\": " << sizeof(double) + numUes * 8 << ",\n"
+         << "  \"intervalSeconds\": " << interval.GetSeconds() << ",\n"
+         << "  \"numUes\": " << numUes << ",\n"
+         << "  \"fields\": [\n"
+         << "    {\"name\": \"time\", \"dtype\": \"<f8\"},\n"
+         << "    {\"name\": \"servingCellId\", \"dtype\": \"<u2\", \"shape\": [" << numUes << "]},\n"
+         << "    {\"name\": \"rrcState\", \"dtype\": \"u1\", \"shape\": [" << numUes << "]},\n"
+         << "    {\"name\": \"rsrpBucket\", \"dtype\": \"u1\", \"shape\": [" << numUes << "]},\n"
+         << "    {\"name\": \"intervalBytes\", \"dtype\": \"<u4\", \"shape\": [" << numUes << "]}\n"
+         << "  ],\n"
+         << "  \"rrcStates\": {\"0\": \"IDLE\", \"1\": \"CONNECTED\", \"2\": \"HANDOVER\"},\n"
+         << "  \"rsrpBucket\": \"RSRP dBm = bucket - 140, " << int(kUeStateNoRsrp) << " = none\",\n"
+         << "  \"cellTypes\": {";
+  bool first = true;
+  for (const auto& cell : g_baseStationTypes)
+  {
+    schema << (first ? "" : ", ") << "\"" << cell.first << "\": \"" << cell.second << "\"";
+    first = false;
+  }
+  schema << "}\n"
+         << "}\n";
+}
+
+// Size the store, hook the downlink UdpServer of every UE and start the rows
+static void SetupUeStateSnapshot(NodeContainer ueNodes, Time interval)
+{
+  uint32_t numUes = ueNodes.GetN();
+  g_ueState.servingCellId.assign(numUes, 0);
+  g_ueState.rrcState.assign(numUes, UE_STATE_IDLE);
+  g_ueState.rsrpBucket.assign(numUes, kUeStateNoRsrp);
+  g_ueState.intervalBytes.assign(numUes, 0);
+
+  for (uint32_t u = 0; u < numUes; ++u)
+  {
+    Ptr<Node> node = ueNodes.Get(u);
+    for (uint32_t a = 0; a < node->GetNApplications(); ++a)
+    {
+      Ptr<UdpServer> server = DynamicCast<UdpServer>(node->GetApplication(a));
+      if (server)
+      {
+        server->TraceConnectWithoutContext("Rx", MakeBoundCallback(&UeStateRx, u));
+      }
+    }
+  }
+
+  g_ueStateFile.open("comprehensive_ue_state.bin", std::ios::binary);
+  WriteUeStateSchema(numUes, interval);
+  Simulator::Schedule(interval, &WriteUeStateRow, interval);
+}
+
+// Enhanced measurement report callback with base station classification
+static void
+MeasReportSink(std::string context, uint64_t imsi, uint16_t cellId, uint16_t rnti, LteRrcSap::MeasurementReport report)
+{
+  HeapScope heapScope(kHeapMeasReports);
+  const auto& mr = report.measResults;
+  uint8_t measId = mr.measId;
+  
+  // Serving cell measurements
+  int srp = mr.measResultPCell.rsrpResult;   // 0..97 quantized per 36.331
+  int srq = mr.measResultPCell.rsrqResult;   // 0..34  quantized per 36.331
+  
+  // Convert quantized values to actual dBm/dB values for analysis
+  double rsrpDbm = -140.0 + srp;  // RSRP in dBm
+  double rsrqDb = -19.5 + 0.5 * srq;  // RSRQ in dB
+  UeStateSetRsrp(imsi, srp);
+  HoTimingReport(cellId, rnti, mr);
+  g_lastServingRsrpDbm[imsi] = rsrpDbm;
+  
+  bool hasNeigh = mr.haveMeasResultNeighCells;
+  std::string event = hasNeigh ? "A3" : "PERIODIC";
+  
+  // Quantized report for the golden digest
+  std::string digestLine = "MR," + std::to_string(Simulator::Now().GetNanoSeconds()) + "," + std::to_string(imsi) + ","
+                           + std::to_string(cellId) + "," + std::to_string(rnti) + "," + std::to_string(measId) + ","
+                           + std::to_string(srp) + "," + std::to_string(srq) + ",";
+  if (hasNeigh)
+  {
+    for (const auto& neigh : mr.measResultListEutra)
+    {
+      digestLine += std::to_string(neigh.physCellId) + ":" + std::to_string(neigh.haveRsrpResult ? neigh.rsrpResult : -1)
+                    + ":" + std::to_string(neigh.haveRsrqResult ? neigh.rsrqResult : -1) + ";";
+    }
+  }
+  DigestEvent(digestLine);
+  
+  // Determine serving cell type
+  std::string servingCellType = "UNKNOWN";
+  if (g_baseStationTypes.find(cellId) != g_baseStationTypes.end())
+  {
+    servingCellType = g_baseStationTypes[cellId];
+  }
+  
+  g_measCsv << std::fixed << std::setprecision(6) << Simulator::Now().GetSeconds() << ","
+            << imsi << ","
+            << cellId << ","
+            << servingCellType << ","
+            << rnti << ","
+            << unsigned(measId) << ","
+            << event << ","
+            << srp << ","
+            << srq << ","
+            << rsrpDbm << ","
+            << rsrqDb;
+  
+  // Add neighbor cell measurements with classification
+  if (hasNeigh)
+  {
+    g_measCsv << ",";
+    for (auto it = mr.measResultListEutra.begin(); it != mr.measResultListEutra.end(); ++it)
+    {
+      uint16_t neighCellId = it->physCellId;
+      int neighRsrp = it->haveRsrpResult ? it->rsrpResult : -1;
+      int neighRsrq = it->haveRsrqResult ? it->rsrqResult : -1;
+      double neighRsrpDbm = (neighRsrp >= 0) ? (-140.0 + neighRsrp) : -200.0;
+      double neighRsrqDb = (neighRsrq >= 0) ? (-19.5 + 0.5 * neighRsrq) : -50.0;
+      
+      std::string neighType = "UNKNOWN";
+      if (g_baseStationTypes.find(neighCellId) != g_baseStationTypes.end())
+      {
+        neighType = g_baseStationTypes[neighCellId];
+      }
+      
+      g_measCsv << neighCellId << ":" << neighType << ":" << neighRsrp << ":" << neighRsrq 
+                << ":" << neighRsrpDbm << ":" << neighRsrqDb << ";";
+      
+      // Log potential security events
+      if (neighType == "FAKE" && neighRsrpDbm > rsrpDbm + 3.0)  // Strong fake signal
+      {
+        g_securityEventsFile << std::fixed << std::setprecision(6) << Simulator::Now().GetSeconds() << ","
+                            << "STRONG_FAKE_SIGNAL,IMSI:" << imsi << ",FakeCellId:" << neighCellId 
+                            << ",FakeRSRP:" << neighRsrpDbm << ",ServingRSRP:" << rsrpDbm << std::endl;
+      }
+    }
+  }
+  else
+  {
+    g_measCsv << ",NONE";
+  }
+  g_measCsv << std::endl;
+  
+  if (g_featureExport)
+  {
+    FeatureObserveReport(imsi, rsrpDbm, mr);
+  }
+  
+  // Enhanced RSRP file with base station classification
+  g_rsrpFile << std::fixed << std::setprecision(6) << Simulator::Now().GetSeconds() << ","
+             << imsi << "," << cellId << "," << servingCellType << "," 
+             << rsrpDbm << "," << rsrqDb << std::endl;
+}
+
+static void EnbConnEstablished(std::string context, uint64_t imsi, uint16_t cellId, uint16_t rnti)
+{
+  std::string cellType = g_baseStationTypes[cellId];
+  RecordTaggedRrcEvent(RRC_CONN_EST, kRrcSideEnb, imsi, cellId, rnti);
+  g_rntiToImsi[uint32_t(cellId) << 16 | rnti] = imsi;
+  UeStateSetCell(imsi, cellId, UE_STATE_CONNECTED);
+  
+  // Update NetAnim visualization for connection establishment
+  if (g_anim && g_ueToNodeId.find(imsi) != g_ueToNodeId.end())
+  {
+    uint32_t ueNodeId = g_ueToNodeId[imsi];
+    if (cellType == "LEGITIMATE")
+    {
+      g_anim->UpdateNodeColor(ueNodeId, 0, 255, 0); // Green when connected to legitimate
+    }
+    else if (cellType == "FAULTY")
+    {
+      g_anim->UpdateNodeColor(ueNodeId, 255, 165, 0); // Orange when connected to faulty
+    }
+    else if (cellType == "FAKE")
+    {
+      g_anim->UpdateNodeColor(ueNodeId, 255, 0, 255); // Magenta when connected to fake
+    }
+  }
+  
+  // Track fake connection attempts
+  if (cellType == "FAKE")
+  {
+    g_fakeAttachAttempts++;
+    g_securityEventsFile << std::fixed << std::setprecision(6) << Simulator::Now().GetSeconds() << ","
+                        << "FAKE_ATTACH_ATTEMPT,IMSI:" << imsi << ",FakeCellId:" << cellId << std::endl;
+  }
+}
+
+static void EnbHoStart(std::string context, uint64_t imsi, uint16_t cellId, uint16_t rnti, uint16_t targetCid)
+{
+  g_totalHandovers++;
+  g_ueHandoverCount[imsi]++;
+  auto servingRsrp = g_lastServingRsrpDbm.find(imsi);
+  if (servingRsrp != g_lastServingRsrpDbm.end())
+  {
+    g_hoStartRsrpSum += servingRsrp->second;
+    g_hoStartRsrpCount++;
+  }
+  
+  std::string sourceCellType = g_baseStationTypes[cellId];
+  std::string targetCellType = g_baseStationTypes[targetCid];
+  
+  RecordTaggedRrcEvent(RRC_HO_START, kRrcSideEnb, imsi, cellId, rnti, targetCid);
+  UeStateSetCell(imsi, 0, UE_STATE_HANDOVER);
+  HoTimingPrepared(imsi, cellId, rnti);
+  
+  // Update NetAnim visualization for handover start
+  if (g_anim && g_ueToNodeId.find(imsi) != g_ueToNodeId.end())
+  {
+    uint32_t ueNodeId = g_ueToNodeId[imsi];
+    g_anim->UpdateNodeColor(ueNodeId, 255, 255, 0); // Yellow during handover
+    g_anim->UpdateNodeDescription(ueNodeId, "UE-" + std::to_string(imsi) + "-HO:" + std::to_string(cellId) + "→" + std::to_string(targetCid));
+  }
+  
+  // Track faulty handovers
+  if (sourceCellType == "FAULTY" || targetCellType == "FAULTY")
+  {
+    g_faultyHandovers++;
+    g_securityEventsFile << std::fixed << std::setprecision(6) << Simulator::Now().GetSeconds() << ","
+                        << "FAULTY_HANDOVER,IMSI:" << imsi << ",Source:" << cellId << "(" << sourceCellType 
+                        << "),Target:" << targetCid << "(" << targetCellType << ")" << std::endl;
+  }
+  
+  // Track fake handover attempts
+  if (targetCellType == "FAKE")
+  {
+    g_securityEventsFile << std::fixed << std::setprecision(6) << Simulator::Now().GetSeconds() << ","
+                        << "FAKE_HANDOVER_ATTEMPT,IMSI:" << imsi << ",Source:" << cellId 
+                        << ",FakeTarget:" << targetCid << std::endl;
+  }
+}
+
+static void EnbHoEndOk(std::string context, uint64_t imsi, uint16_t cellId, uint16_t rnti)
+{
+  g_successfulHandovers++;
   
-  g_handoverStatsFile << "HO_START," << std::fixed << std::setprecision(6) << Simulator::Now().GetSeconds() << ","
-                      << imsi << "," << cellId << "," << sourceCellType << "," 
-                      << targetCid << "," << targetCellType << std::endl;
+  std::string cellType = g_baseStationTypes[cellId];
+  RecordTaggedRrcEvent(RRC_HO_END_OK, kRrcSideEnb, imsi, cellId, rnti);
+  g_rntiToImsi[uint32_t(cellId) << 16 | rnti] = imsi;
+  UeStateSetCell(imsi, cellId, UE_STATE_CONNECTED);
+  SignallingStamp(imsi, SIG_HO_COMPLETE);
   
-  // Update NetAnim visualization for handover start
+  // Update NetAnim visualization for successful handover completion
   if (g_anim && g_ueToNodeId.find(imsi) != g_ueToNodeId.end())
   {
     uint32_t ueNodeId = g_ueToNodeId[imsi];
-    g_anim->UpdateNodeColor(ueNodeId, 255, 255, 0); // Yellow during handover
-    g_anim->UpdateNodeDescription(ueNodeId, "UE-" + std::to_string(imsi) + "-HO:" + std::to_string(cellId) + "→" + std::to_string(targetCid));
+    if (cellType == "LEGITIMATE")
+    {
+      g_anim->UpdateNodeColor(ueNodeId, 0, 255, 0); // Green when connected to legitimate
+    }
+    else if (cellType == "FAULTY")
+    {
+      g_anim->UpdateNodeColor(ueNodeId, 255, 165, 0); // Orange when connected to faulty
+    }
+    else if (cellType == "FAKE")
+    {
+      g_anim->UpdateNodeColor(ueNodeId, 255, 0, 255); // Magenta when connected to fake
+    }
+    g_anim->UpdateNodeDescription(ueNodeId, "UE-" + std::to_string(imsi) + "-Cell:" + std::to_string(cellId));
   }
+}
+
+// Handover failures (preamble, RACH, leaving and joining timeouts) of any
+// algorithm. The eNBs drop the UE context, so the UE is no longer connected.
+static void EnbHoFailure(std::string context, uint64_t imsi, uint16_t rnti, uint16_t cellId)
+{
+  g_hoFailures++;
+  UeStateDetach(imsi);
+}
+
+static void UeRadioLinkFailure(std::string context, uint64_t imsi, uint16_t cellId, uint16_t rnti)
+{
+  UeStateDetach(imsi);
+}
+
+static void UeConnEstablished(std::string context, uint64_t imsi, uint16_t cellId, uint16_t rnti)
+{
+  RecordTaggedRrcEvent(RRC_CONN_EST, kRrcSideUe, imsi, cellId, rnti);
+}
+
+static void UeHoStart(std::string context, uint64_t imsi, uint16_t cellId, uint16_t rnti, uint16_t targetCid)
+{
+  RecordTaggedRrcEvent(RRC_HO_START, kRrcSideUe, imsi, cellId, rnti, targetCid);
+  g_ueHoStartTime[imsi] = Simulator::Now();
+  HoTimingCommand(imsi);
+  SignallingStamp(imsi, SIG_RRC_RECONF);
   
-  // Track faulty handovers
-  if (sourceCellType == "FAULTY" || targetCellType == "FAULTY")
+  FeatureObserveHandover(imsi);
+}
+
+static void UeHoEndOk(std::string context, uint64_t imsi, uint16_t cellId, uint16_t rnti)
+{
+  RecordTaggedRrcEvent(RRC_HO_END_OK, kRrcSideUe, imsi, cellId, rnti);
+  
+  // Interruption as seen by the UE, from the handover command to completion
+  auto it = g_ueHoStartTime.find(imsi);
+  if (it != g_ueHoStartTime.end())
+  {
+    Time interruption = Simulator::Now() - it->second;
+    g_hoInterruptionTotal += interruption;
+    g_hoInterruptionCount++;
+    HoTimingComplete(imsi, interruption);
+    g_ueHoStartTime.erase(it);
+  }
+}
+
+// Enhanced mobility tracing function
+void CourseChange(std::string context, Ptr<const MobilityModel> model)
+{
+  HeapScope heapScope(kHeapMobilityTrace);
+  Vector pos = model->GetPosition();
+  Vector vel = model->GetVelocity();
+  
+  // Extract UE index from context
+  std::string::size_type pos1 = context.find("/NodeList/");
+  std::string::size_type pos2 = context.find("/", pos1 + 10);
+  std::string nodeIdStr = context.substr(pos1 + 10, pos2 - pos1 - 10);
+  uint32_t nodeId = std::stoi(nodeIdStr);
+  
+  g_mobilityTraceFile << std::fixed << std::setprecision(6) << Simulator::Now().GetSeconds() << ","
+                      << nodeId << ","
+                      << pos.x << "," << pos.y << "," << pos.z << ","
+                      << vel.x << "," << vel.y << "," << vel.z << ","
+                      << sqrt(vel.x*vel.x + vel.y*vel.y) << std::endl;  // Speed magnitude
+}
+
+// Function to change UE direction to ensure interaction with all BS types
+void ChangeUeDirection(uint32_t ueIndex, NodeContainer ueNodes, double speed)
+{
+  Ptr<MobilityModel> mobilityModel = ueNodes.Get(ueIndex)->GetObject<MobilityModel>();
+  Ptr<ConstantVelocityMobilityModel> cvMobility = DynamicCast<ConstantVelocityMobilityModel>(mobilityModel);
+  
+  Vector currentPos = cvMobility->GetPosition();
+  
+  if (ueIndex == 1)  // UE 1 doing vertical zigzag
+  {
+    if (currentPos.y > 200.0)
+    {
+      cvMobility->SetVelocity(Vector(0.0, -speed, 0.0)); // Go down
+    }
+    else if (currentPos.y < -200.0)
+    {
+      cvMobility->SetVelocity(Vector(0.0, speed, 0.0));  // Go up
+    }
+  }
+  
+  // Schedule next direction change
+  Simulator::Schedule(Seconds(20.0), &ChangeUeDirection, ueIndex, ueNodes, speed);
+}
+
+// ---------------------------------------------------------------------------
+// Coverage-aware UE path planner
+//
+// Instead of hand-tuned start points, UEs can be routed across the borders of
+// requested cell-class pairs (e.g. LEGITIMATE-FAKE). Borders are located with a
+// predicted RSRP model from the cell positions and transmit powers, and each UE
+// group shuttles across the borders of its class pair for the whole run.
+// ---------------------------------------------------------------------------
+
+// One crossing of the border between two cells
+struct BorderCrossing
+{
+  uint16_t cellA;
+  uint16_t cellB;
+  Vector border;     // Point where A and B have equal predicted RSRP
+  Vector start;      // Inside the dominance area of A
+  Vector end;        // Inside the dominance area of B
+  double rsrpDbm;    // Predicted RSRP at the border point
+};
+
+// Route shared by one UE group
+struct PlannedRoute
+{
+  std::string classPair;
+  std::vector<BorderCrossing> crossings;
+};
+
+// Predicted RSRP (dBm per resource element) of a cell at a position. Mirrors the
+// LteHelper defaults: Friis path loss on the EARFCN 100 (2120 MHz) downlink with
+// the transmit power spread over 25 RBs (300 subcarriers).
+static double PredictRsrpDbm(const CellSite& site, const Vector& pos)
+{
+  const double freqHz = 2120e6;
+  const double speedOfLight = 299792458.0;
+  double distance = std::max(1.0, CalculateDistance(site.position, pos));
+  double pathLossDb = 20.0 * std::log10(4.0 * M_PI * distance * freqHz / speedOfLight);
+  return site.txPowerDbm - 10.0 * std::log10(300.0) - pathLossDb;
+}
+
+// Indices (into g_cellSites) of the two strongest predicted cells at a position
+static void RankCells(const Vector& pos, int& best, int& second)
+{
+  best = second = -1;
+  double bestRsrp = -1e9;
+  double secondRsrp = -1e9;
+  for (size_t c = 0; c < g_cellSites.size(); ++c)
+  {
+    double rsrp = PredictRsrpDbm(g_cellSites[c], pos);
+    if (rsrp > bestRsrp)
+    {
+      second = best;
+      secondRsrp = bestRsrp;
+      best = c;
+      bestRsrp = rsrp;
+    }
+    else if (rsrp > secondRsrp)
+    {
+      second = c;
+      secondRsrp = rsrp;
+    }
+  }
+}
+
+// Parse "LEGITIMATE-FAKE,FAULTY-FAKE" (or "all") into class pairs
+static std::vector<std::pair<std::string, std::string>> ParseClassPairs(const std::string& spec)
+{
+  std::vector<std::pair<std::string, std::string>> pairs;
+  if (spec == "all")
+  {
+    pairs.push_back({"LEGITIMATE", "FAULTY"});
+    pairs.push_back({"LEGITIMATE", "FAKE"});
+    pairs.push_back({"FAULTY", "FAKE"});
+    return pairs;
+  }
+
+  auto isClass = [](const std::string& name) {
+    return name == "LEGITIMATE" || name == "FAULTY" || name == "FAKE";
+  };
+  std::stringstream ss(spec);
+  std::string item;
+  while (std::getline(ss, item, ','))
+  {
+    std::string::size_type dash = item.find('-');
+    if (dash == std::string::npos)
+    {
+      NS_FATAL_ERROR("pathPlan: malformed entry '" << item << "', expected CLASS-CLASS");
+    }
+    std::string first = item.substr(0, dash);
+    std::string second = item.substr(dash + 1);
+    if (!isClass(first) || !isClass(second))
+    {
+      NS_FATAL_ERROR("pathPlan: unknown class in '" << item << "', expected LEGITIMATE, FAULTY or FAKE");
+    }
+    pairs.push_back({first, second});
+  }
+  return pairs;
+}
+
+// Locate the border between cells a and b (indices into g_cellSites). A coarse
+// grid search finds the shared border nearest the midpoint of the two sites and
+// a bisection along the a->b direction refines it. Returns false if the two
+// cells never are the two strongest cells anywhere (e.g. co-located or shadowed).
+static bool FindBorderCrossing(int a, int b, double halfLength, BorderCrossing& crossing)
+{
+  const CellSite& siteA = g_cellSites[a];
+  const CellSite& siteB = g_cellSites[b];
+  double dx = siteB.position.x - siteA.position.x;
+  double dy = siteB.position.y - siteA.position.y;
+  double separation = std::sqrt(dx * dx + dy * dy);
+  if (separation < 1.0)
+  {
+    return false;
+  }
+  Vector dir(dx / separation, dy / separation, 0.0);
+  Vector mid((siteA.position.x + siteB.position.x) / 2.0, (siteA.position.y + siteB.position.y) / 2.0, 1.5);
+
+  const double gridStep = 10.0;
+  const double extent = separation + 2.0 * halfLength;
+  bool found = false;
+  double bestScore = 1e9;
+  Vector candidate;
+  for (double gx = mid.x - extent; gx <= mid.x + extent; gx += gridStep)
+  {
+    for (double gy = mid.y - extent; gy <= mid.y + extent; gy += gridStep)
+    {
+      Vector p(gx, gy, 1.5);
+      int best, second;
+      RankCells(p, best, second);
+      if (!((best == a && second == b) || (best == b && second == a)))
+      {
+        continue;
+      }
+      // Prefer points close to equal RSRP and close to the line between the sites
+      double diff = std::fabs(PredictRsrpDbm(siteA, p) - PredictRsrpDbm(siteB, p));
+      double score = diff + 0.01 * CalculateDistance(p, mid);
+      if (score < bestScore)
+      {
+        bestScore = score;
+        candidate = p;
+        found = true;
+      }
+    }
+  }
+  if (!found)
+  {
+    return false;
+  }
+
+  // Refine along the a->b direction: A dominates at lo, B dominates at hi
+  double lo = -gridStep;
+  double hi = gridStep;
+  for (int iter = 0; iter < 30; ++iter)
+  {
+    double t = (lo + hi) / 2.0;
+    Vector p(candidate.x + dir.x * t, candidate.y + dir.y * t, 1.5);
+    if (PredictRsrpDbm(siteA, p) > PredictRsrpDbm(siteB, p))
+    {
+      lo = t;
+    }
+    else
+    {
+      hi = t;
+    }
+  }
+  double t = (lo + hi) / 2.0;
+  crossing.cellA = siteA.cellId;
+  crossing.cellB = siteB.cellId;
+  crossing.border = Vector(candidate.x + dir.x * t, candidate.y + dir.y * t, 1.5);
+  crossing.start = Vector(crossing.border.x - dir.x * halfLength, crossing.border.y - dir.y * halfLength, 1.5);
+  crossing.end = Vector(crossing.border.x + dir.x * halfLength, crossing.border.y + dir.y * halfLength, 1.5);
+  crossing.rsrpDbm = PredictRsrpDbm(siteA, crossing.border);
+  return true;
+}
+
+// Compute one route per requested class pair. The crossings of all matching cell
+// pairs are chained in nearest-neighbour order to keep transit legs short.
+static std::vector<PlannedRoute> PlanBorderRoutes(const std::vector<std::pair<std::string, std::string>>& classPairs,
+                                                  double halfLength)
+{
+  std::vector<PlannedRoute> routes;
+  for (const auto& classPair : classPairs)
+  {
+    std::vector<BorderCrossing> crossings;
+    for (size_t a = 0; a < g_cellSites.size(); ++a)
+    {
+      for (size_t b = a + 1; b < g_cellSites.size(); ++b)
+      {
+        const std::string& typeA = g_cellSites[a].cellType;
+        const std::string& typeB = g_cellSites[b].cellType;
+        bool forward = (typeA == classPair.first && typeB == classPair.second);
+        bool backward = (typeA == classPair.second && typeB == classPair.first);
+        if (!forward && !backward)
+        {
+          continue;
+        }
+        BorderCrossing crossing;
+        // Always cross from the first class of the pair into the second
+        if (forward ? FindBorderCrossing(a, b, halfLength, crossing) : FindBorderCrossing(b, a, halfLength, crossing))
+        {
+          crossings.push_back(crossing);
+        }
+      }
+    }
+
+    std::string name = classPair.first + "-" + classPair.second;
+    if (crossings.empty())
+    {
+      std::cout << "Path planner: no reachable border for class pair " << name << std::endl;
+      continue;
+    }
+
+    // Nearest-neighbour ordering starting from the first crossing
+    PlannedRoute route;
+    route.classPair = name;
+    route.crossings.push_back(crossings.front());
+    crossings.erase(crossings.begin());
+    while (!crossings.empty())
+    {
+      const Vector& last = route.crossings.back().end;
+      auto nearest = std::min_element(crossings.begin(), crossings.end(),
+                                      [&last](const BorderCrossing& x, const BorderCrossing& y) {
+                                        return CalculateDistance(last, x.start) < CalculateDistance(last, y.start);
+                                      });
+      route.crossings.push_back(*nearest);
+      crossings.erase(nearest);
+    }
+    routes.push_back(route);
+  }
+  return routes;
+}
+
+// Install waypoint trajectories for all UEs. UE i joins group i % routes.size();
+// members of a group start at different crossings and odd members run the route
+// backwards so a group does not move in lockstep. Returns the index of the
+// strongest predicted non-FAKE eNB at each UE's start position for attachment.
+static std::vector<uint32_t> InstallPlannedRoutes(NodeContainer ueNodes, const std::vector<PlannedRoute>& routes,
+                                                  double speed, Time simTime)
+{
+  if (speed <= 0.0)
+  {
+    NS_FATAL_ERROR("Planned routes need a positive ueSpeed, got " << speed);
+  }
+  std::vector<uint32_t> attachIndex(ueNodes.GetN(), 0);
+  MobilityHelper ueMobility;
+  ueMobility.SetMobilityModel("ns3::WaypointMobilityModel");
+
+  for (uint32_t i = 0; i < ueNodes.GetN(); ++i)
+  {
+    uint32_t group = i % routes.size();
+    uint32_t member = i / routes.size();
+    const PlannedRoute& route = routes[group];
+
+    // Points of one forward pass: start/end of every crossing, rotated per member
+    std::vector<Vector> pass;
+    size_t n = route.crossings.size();
+    for (size_t k = 0; k < n; ++k)
+    {
+      const BorderCrossing& c = route.crossings[(k + member) % n];
+      pass.push_back(c.start);
+      pass.push_back(c.end);
+    }
+    if (member % 2 == 1)
+    {
+      std::reverse(pass.begin(), pass.end());
+    }
+
+    ueMobility.Install(ueNodes.Get(i));
+    Ptr<WaypointMobilityModel> waypoints = ueNodes.Get(i)->GetObject<WaypointMobilityModel>();
+
+    // Shuttle forward and backward along the pass until the end of the run.
+    // Zero-length legs (repeated points) are skipped, since waypoint times
+    // must increase; a route that is a single point leaves the UE there.
+    Time t = Seconds(0.0);
+    Vector last = pass.front();
+    waypoints->AddWaypoint(Waypoint(t, last));
+    bool reversed = false;
+    while (t < simTime)
+    {
+      Time passStart = t;
+      for (size_t k = 1; k < pass.size(); ++k)
+      {
+        const Vector& next = reversed ? pass[pass.size() - 1 - k] : pass[k];
+        Time leg = Seconds(CalculateDistance(last, next) / speed);
+        if (!leg.IsStrictlyPositive())
+        {
+          continue;
+        }
+        t += leg;
+        waypoints->AddWaypoint(Waypoint(t, next));
+        last = next;
+      }
+      if (t == passStart)
+      {
+        break;
+      }
+      reversed = !reversed;
+    }
+
+    // Attach to the strongest legitimate-looking cell at the start position
+    double bestRsrp = -1e9;
+    for (size_t c = 0; c < g_cellSites.size(); ++c)
+    {
+      double rsrp = PredictRsrpDbm(g_cellSites[c], pass.front());
+      if (g_cellSites[c].cellType != "FAKE" && rsrp > bestRsrp)
+      {
+        bestRsrp = rsrp;
+        attachIndex[i] = c;
+      }
+    }
+
+    for (size_t k = 0; k < n; ++k)
+    {
+      const BorderCrossing& c = route.crossings[(k + member) % n];
+      g_pathPlanFile << i + 1 << "," << group << "," << route.classPair << "," << k << ","
+                     << c.cellA << "," << c.cellB << ","
+                     << std::fixed << std::setprecision(2) << c.border.x << "," << c.border.y << ","
+                     << c.rsrpDbm << std::endl;
+    }
+  }
+  return attachIndex;
+}
+
+// ---------------------------------------------------------------------------
+// Per-cell load collector
+//
+// Accumulates allocated PRBs, scheduled UEs and bytes from the eNB MAC
+// scheduling traces into fixed per-cell counters and writes one row per cell
+// per epoch. The MAC traces carry TB size and MCS but no PRB count, so PRBs are
+// recovered from a TB size table built once from LteAmc.
+// ---------------------------------------------------------------------------
+
+struct CellLoadCounters
+{
+  uint64_t dlPrbs = 0;
+  uint64_t ulPrbs = 0;
+  uint64_t dlBytes = 0;
+  uint64_t ulBytes = 0;
+  uint32_t dlAllocations = 0;
+  uint32_t ulAllocations = 0;
+  uint32_t scheduledUes = 0;    // Distinct RNTIs scheduled in the epoch
+};
+
+static std::vector<CellLoadCounters> g_cellLoad;                // Indexed by cellId - 1
+static std::vector<std::vector<uint32_t>> g_cellLoadLastEpoch;  // Per cell, per RNTI: last epoch + 1
+static uint32_t g_cellLoadEpoch = 0;
+static Time g_cellLoadEpochStart;
+static uint16_t g_dlRbs = 25;
+static uint16_t g_ulRbs = 25;
+static std::vector<std::vector<uint16_t>> g_dlTbsTable;  // [mcs][nPrb - 1] -> TB size in bytes
+static std::vector<std::vector<uint16_t>> g_ulTbsTable;
+
+// Smallest PRB count whose TB size at this MCS covers the allocated TB
+static uint32_t PrbsForTbSize(const std::vector<std::vector<uint16_t>>& table, uint8_t mcs, uint16_t tbBytes)
+{
+  const std::vector<uint16_t>& row = table[std::min<size_t>(mcs, table.size() - 1)];
+  auto it = std::lower_bound(row.begin(), row.end(), tbBytes);
+  return (it == row.end()) ? row.size() : (it - row.begin()) + 1;
+}
+
+static void CountScheduledUe(uint32_t cellIndex, uint16_t rnti)
+{
+  HeapScope heapScope(kHeapCellLoad);
+  std::vector<uint32_t>& lastEpoch = g_cellLoadLastEpoch[cellIndex];
+  if (rnti >= lastEpoch.size())
+  {
+    lastEpoch.resize(rnti + 1, 0);
+  }
+  if (lastEpoch[rnti] != g_cellLoadEpoch + 1)
+  {
+    lastEpoch[rnti] = g_cellLoadEpoch + 1;
+    g_cellLoad[cellIndex].scheduledUes++;
+  }
+}
+
+static void CellLoadDlScheduling(uint32_t cellIndex, DlSchedulingCallbackInfo info)
+{
+  CellLoadCounters& load = g_cellLoad[cellIndex];
+  load.dlPrbs += PrbsForTbSize(g_dlTbsTable, info.mcsTb1, info.sizeTb1);
+  load.dlBytes += info.sizeTb1 + info.sizeTb2;
+  load.dlAllocations++;
+  CountScheduledUe(cellIndex, info.rnti);
+}
+
+static void CellLoadUlScheduling(uint32_t cellIndex, uint32_t frameNo, uint32_t subframeNo, uint16_t rnti,
+                                 uint8_t mcs, uint16_t tbSize, uint8_t componentCarrierId)
+{
+  CellLoadCounters& load = g_cellLoad[cellIndex];
+  load.ulPrbs += PrbsForTbSize(g_ulTbsTable, mcs, tbSize);
+  load.ulBytes += tbSize;
+  load.ulAllocations++;
+  CountScheduledUe(cellIndex, rnti);
+}
+
+// Write one row per cell for the epoch ending now and reset the counters
+static void WriteCellLoadEpoch()
+{
+  HeapScope heapScope(kHeapCellLoad);
+  double ttis = (Simulator::Now() - g_cellLoadEpochStart).GetSeconds() * 1000.0;  // One TTI per millisecond
+  for (uint32_t i = 0; i < g_cellLoad.size(); ++i)
+  {
+    const CellLoadCounters& load = g_cellLoad[i];
+    g_cellLoadFile << std::fixed << std::setprecision(6) << Simulator::Now().GetSeconds() << ","
+                   << i + 1 << "," << g_baseStationTypes[i + 1] << ","
+                   << load.dlPrbs << "," << load.ulPrbs << ","
+                   << load.dlPrbs / (g_dlRbs * ttis) << "," << load.ulPrbs / (g_ulRbs * ttis) << ","
+                   << load.dlAllocations << "," << load.ulAllocations << ","
+                   << load.scheduledUes << ","
+                   << load.dlBytes << "," << load.ulBytes << "\n";
+    g_cellLoad[i] = CellLoadCounters();
+  }
+  g_cellLoadEpoch++;
+  g_cellLoadEpochStart = Simulator::Now();
+}
+
+static void FlushCellLoadEpoch(Time epoch)
+{
+  WriteCellLoadEpoch();
+  Simulator::Schedule(epoch, &FlushCellLoadEpoch, epoch);
+}
+
+// At the end of the run: write the partial epoch since the last flush
+static void FlushFinalCellLoadEpoch()
+{
+  if (g_cellLoadFile.is_open() && Simulator::Now() > g_cellLoadEpochStart)
+  {
+    WriteCellLoadEpoch();
+  }
+}
+
+// Build the TB size tables and hook the MAC scheduling traces of every eNB
+static void SetupCellLoadCollector(NetDeviceContainer enbLteDevs, Time epoch)
+{
+  if (epoch < MilliSeconds(1))
+  {
+    NS_FATAL_ERROR("loadEpoch must be at least one TTI (1 ms)");
+  }
+  Ptr<LteEnbNetDevice> firstEnb = enbLteDevs.Get(0)->GetObject<LteEnbNetDevice>();
+  g_dlRbs = firstEnb->GetDlBandwidth();
+  g_ulRbs = firstEnb->GetUlBandwidth();
+
+  Ptr<LteAmc> amc = CreateObject<LteAmc>();
+  g_dlTbsTable.assign(29, std::vector<uint16_t>(g_dlRbs));
+  g_ulTbsTable.assign(29, std::vector<uint16_t>(g_ulRbs));
+  for (int mcs = 0; mcs < 29; ++mcs)
+  {
+    for (int nPrb = 1; nPrb <= g_dlRbs; ++nPrb)
+    {
+      g_dlTbsTable[mcs][nPrb - 1] = amc->GetDlTbSizeFromMcs(mcs, nPrb) / 8;
+    }
+    for (int nPrb = 1; nPrb <= g_ulRbs; ++nPrb)
+    {
+      g_ulTbsTable[mcs][nPrb - 1] = amc->GetUlTbSizeFromMcs(mcs, nPrb) / 8;
+    }
+  }
+
+  g_cellLoad.assign(enbLteDevs.GetN(), CellLoadCounters());
+  g_cellLoadLastEpoch.assign(enbLteDevs.GetN(), std::vector<uint32_t>());
+  for (uint32_t i = 0; i < enbLteDevs.GetN(); ++i)
+  {
+    Ptr<LteEnbMac> mac = enbLteDevs.Get(i)->GetObject<LteEnbNetDevice>()->GetMac();
+    mac->TraceConnectWithoutContext("DlScheduling", MakeBoundCallback(&CellLoadDlScheduling, i));
+    mac->TraceConnectWithoutContext("UlScheduling", MakeBoundCallback(&CellLoadUlScheduling, i));
+  }
+
+  g_cellLoadFile.open("comprehensive_cell_load.csv");
+  g_cellLoadFile << "time,cellId,cellType,dlPrbs,ulPrbs,dlPrbUtilization,ulPrbUtilization,"
+                 << "dlAllocations,ulAllocations,scheduledUes,dlBytes,ulBytes\n";
+  Simulator::Schedule(epoch, &FlushCellLoadEpoch, epoch);
+}
+
+// ---------------------------------------------------------------------------
+// Ground-truth PHY RSRP/SINR capture
+//
+// The UE PHY reports RSRP/RSRQ for every detected cell (FAKE cells under CSG
+// included) every 200 ms, independently of the RRC measurement configuration.
+// Samples are folded into fixed UE x cell min/sum/max accumulators and written
+// as one dense row per UE per tick.
+// ---------------------------------------------------------------------------
+
+struct PhyWindow
+{
+  double min = 1e9;
+  double max = -1e9;
+  double sum = 0.0;
+  uint32_t count = 0;
+
+  void Add(double value)
+  {
+    min = std::min(min, value);
+    max = std::max(max, value);
+    sum += value;
+    count++;
+  }
+};
+
+static uint32_t g_phyNumCells = 0;
+static std::vector<PhyWindow> g_phyRsrp;        // [ueIndex * g_phyNumCells + cellIndex]
+static std::vector<PhyWindow> g_phyServingSinr; // [ueIndex], in dB
+static std::vector<uint16_t> g_phyServingCell;  // [ueIndex], last serving cell seen by the PHY
+static Time g_phyWindowStart = Seconds(0);
+
+static void PhyUeMeasurementSink(uint32_t ueIndex, uint16_t rnti, uint16_t cellId, double rsrpDbm, double rsrqDb,
+                                 bool isServingCell, uint8_t componentCarrierId)
+{
+  HeapScope heapScope(kHeapPhyCapture);
+  if (cellId == 0 || cellId > g_phyNumCells)
   {
-    g_faultyHandovers++;
-    g_securityEventsFile << std::fixed << std::setprecision(6) << Simulator::Now().GetSeconds() << ","
-                        << "FAULTY_HANDOVER,IMSI:" << imsi << ",Source:" << cellId << "(" << sourceCellType 
-                        << "),Target:" << targetCid << "(" << targetCellType << ")" << std::endl;
+    return;
   }
-  
-  // Track fake handover attempts
-  if (targetCellType == "FAKE")
+  g_phyRsrp[ueIndex * g_phyNumCells + cellId - 1].Add(rsrpDbm);
+  if (isServingCell)
   {
-    g_securityEventsFile << std::fixed << std::setprecision(6) << Simulator::Now().GetSeconds() << ","
-                        << "FAKE_HANDOVER_ATTEMPT,IMSI:" << imsi << ",Source:" << cellId 
-                        << ",FakeTarget:" << targetCid << std::endl;
+    g_phyServingCell[ueIndex] = cellId;
   }
 }
 
-static void EnbHoEndOk(std::string context, uint64_t imsi, uint16_t cellId, uint16_t rnti)
+static void PhyServingSinrSink(uint32_t ueIndex, uint16_t cellId, uint16_t rnti, double rsrp, double sinr,
+                               uint8_t componentCarrierId)
 {
-  g_successfulHandovers++;
-  
-  std::string cellType = g_baseStationTypes[cellId];
-  g_enbRrcCsv << "HO_END_OK," << std::fixed << std::setprecision(6) << Simulator::Now().GetSeconds() << ","
-              << imsi << "," << cellId << "," << cellType << "," << rnti << std::endl;
-  
-  g_handoverStatsFile << "HO_END_OK," << std::fixed << std::setprecision(6) << Simulator::Now().GetSeconds() << ","
-                      << imsi << "," << cellId << "," << cellType << std::endl;
-  
-  // Update NetAnim visualization for successful handover completion
-  if (g_anim && g_ueToNodeId.find(imsi) != g_ueToNodeId.end())
+  HeapScope heapScope(kHeapPhyCapture);
+  if (sinr > 0.0)
   {
-    uint32_t ueNodeId = g_ueToNodeId[imsi];
-    if (cellType == "LEGITIMATE")
-    {
-      g_anim->UpdateNodeColor(ueNodeId, 0, 255, 0); // Green when connected to legitimate
-    }
-    else if (cellType == "FAULTY")
-    {
-      g_anim->UpdateNodeColor(ueNodeId, 255, 165, 0); // Orange when connected to faulty
-    }
-    else if (cellType == "FAKE")
-    {
-      g_anim->UpdateNodeColor(ueNodeId, 255, 0, 255); // Magenta when connected to fake
-    }
-    g_anim->UpdateNodeDescription(ueNodeId, "UE-" + std::to_string(imsi) + "-Cell:" + std::to_string(cellId));
+    g_phyServingSinr[ueIndex].Add(10.0 * std::log10(sinr));
   }
 }
 
-static void UeConnEstablished(std::string context, uint64_t imsi, uint16_t cellId, uint16_t rnti)
+static void WritePhyWindowValue(double value, bool valid)
 {
-  std::string cellType = g_baseStationTypes[cellId];
-  g_ueRrcCsv << "UE_CONN_EST," << std::fixed << std::setprecision(6) << Simulator::Now().GetSeconds() << ","
-             << imsi << "," << cellId << "," << cellType << "," << rnti << std::endl;
+  if (valid)
+  {
+    g_phyMatrixFile << "," << value;
+  }
+  else
+  {
+    g_phyMatrixFile << ",nan";
+  }
 }
 
-static void UeHoStart(std::string context, uint64_t imsi, uint16_t cellId, uint16_t rnti, uint16_t targetCid)
+// Emit the current window of every UE and start a new one
+static void WritePhyMatrixWindow()
 {
-  std::string sourceCellType = g_baseStationTypes[cellId];
-  std::string targetCellType = g_baseStationTypes[targetCid];
-  
-  g_ueRrcCsv << "UE_HO_START," << std::fixed << std::setprecision(6) << Simulator::Now().GetSeconds() << ","
-             << imsi << "," << cellId << "," << sourceCellType << "," << rnti 
-             << ",to:" << targetCid << "," << targetCellType << std::endl;
+  HeapScope heapScope(kHeapPhyCapture);
+  uint32_t numUes = g_phyServingSinr.size();
+  double now = Simulator::Now().GetSeconds();
+  g_phyMatrixFile << std::fixed << std::setprecision(3);
+  for (uint32_t u = 0; u < numUes; ++u)
+  {
+    const PhyWindow& sinr = g_phyServingSinr[u];
+    g_phyMatrixFile << now << "," << u + 1 << "," << g_phyServingCell[u];
+    WritePhyWindowValue(sinr.count ? sinr.sum / sinr.count : 0.0, sinr.count > 0);
+    for (uint32_t c = 0; c < g_phyNumCells; ++c)
+    {
+      const PhyWindow& w = g_phyRsrp[u * g_phyNumCells + c];
+      WritePhyWindowValue(w.min, w.count > 0);
+      WritePhyWindowValue(w.count ? w.sum / w.count : 0.0, w.count > 0);
+      WritePhyWindowValue(w.max, w.count > 0);
+    }
+    g_phyMatrixFile << "\n";
+  }
+  std::fill(g_phyRsrp.begin(), g_phyRsrp.end(), PhyWindow());
+  std::fill(g_phyServingSinr.begin(), g_phyServingSinr.end(), PhyWindow());
+  g_phyWindowStart = Simulator::Now();
 }
 
-static void UeHoEndOk(std::string context, uint64_t imsi, uint16_t cellId, uint16_t rnti)
+static void FlushPhyMatrix(Time interval)
 {
-  std::string cellType = g_baseStationTypes[cellId];
-  g_ueRrcCsv << "UE_HO_END_OK," << std::fixed << std::setprecision(6) << Simulator::Now().GetSeconds() << ","
-             << imsi << "," << cellId << "," << cellType << "," << rnti << std::endl;
+  WritePhyMatrixWindow();
+  Simulator::Schedule(interval, &FlushPhyMatrix, interval);
 }
 
-// Enhanced mobility tracing function
-void CourseChange(std::string context, Ptr<const MobilityModel> model)
+// At the end of the run: write the partial window since the last flush
+static void FlushFinalPhyMatrix()
 {
-  Vector pos = model->GetPosition();
-  Vector vel = model->GetVelocity();
-  
-  // Extract UE index from context
-  std::string::size_type pos1 = context.find("/NodeList/");
-  std::string::size_type pos2 = context.find("/", pos1 + 10);
-  std::string nodeIdStr = context.substr(pos1 + 10, pos2 - pos1 - 10);
-  uint32_t nodeId = std::stoi(nodeIdStr);
-  
-  g_mobilityTraceFile << std::fixed << std::setprecision(6) << Simulator::Now().GetSeconds() << ","
-                      << nodeId << ","
-                      << pos.x << "," << pos.y << "," << pos.z << ","
-                      << vel.x << "," << vel.y << "," << vel.z << ","
-                      << sqrt(vel.x*vel.x + vel.y*vel.y) << std::endl;  // Speed magnitude
+  if (g_phyMatrixFile.is_open() && Simulator::Now() > g_phyWindowStart)
+  {
+    WritePhyMatrixWindow();
+  }
 }
 
-// Function to change UE direction to ensure interaction with all BS types
-void ChangeUeDirection(uint32_t ueIndex, NodeContainer ueNodes, double speed)
+// Hook the PHY measurement traces of every UE and write the matrix header
+static void SetupPhyCapture(NetDeviceContainer ueLteDevs, uint32_t numCells, Time interval)
 {
-  Ptr<MobilityModel> mobilityModel = ueNodes.Get(ueIndex)->GetObject<MobilityModel>();
-  Ptr<ConstantVelocityMobilityModel> cvMobility = DynamicCast<ConstantVelocityMobilityModel>(mobilityModel);
-  
-  Vector currentPos = cvMobility->GetPosition();
-  
-  if (ueIndex == 1)  // UE 1 doing vertical zigzag
+  uint32_t numUes = ueLteDevs.GetN();
+  g_phyNumCells = numCells;
+  g_phyRsrp.assign(numUes * numCells, PhyWindow());
+  g_phyServingSinr.assign(numUes, PhyWindow());
+  g_phyServingCell.assign(numUes, 0);
+
+  for (uint32_t u = 0; u < numUes; ++u)
   {
-    if (currentPos.y > 200.0)
-    {
-      cvMobility->SetVelocity(Vector(0.0, -speed, 0.0)); // Go down
-    }
-    else if (currentPos.y < -200.0)
-    {
-      cvMobility->SetVelocity(Vector(0.0, speed, 0.0));  // Go up
-    }
+    Ptr<LteUePhy> phy = ueLteDevs.Get(u)->GetObject<LteUeNetDevice>()->GetPhy();
+    phy->TraceConnectWithoutContext("ReportUeMeasurements", MakeBoundCallback(&PhyUeMeasurementSink, u));
+    phy->TraceConnectWithoutContext("ReportCurrentCellRsrpSinr", MakeBoundCallback(&PhyServingSinrSink, u));
   }
-  
-  // Schedule next direction change
-  Simulator::Schedule(Seconds(20.0), &ChangeUeDirection, ueIndex, ueNodes, speed);
+
+  g_phyMatrixFile.open("comprehensive_phy_rsrp_matrix.csv");
+  g_phyMatrixFile << "time,imsi,servingCellId,servingSinrMeanDb";
+  for (uint32_t c = 1; c <= numCells; ++c)
+  {
+    g_phyMatrixFile << ",c" << c << "_rsrpMin,c" << c << "_rsrpMean,c" << c << "_rsrpMax";
+  }
+  g_phyMatrixFile << "\n";
+  Simulator::Schedule(interval, &FlushPhyMatrix, interval);
 }
 
 // Enhanced throughput monitoring function
 void MonitorThroughput(Ptr<FlowMonitor> monitor, FlowMonitorHelper* flowHelper)
 {
+  HeapScope heapScope(kHeapThroughput);
   monitor->CheckForLostPackets();
   std::map<FlowId, FlowMonitor::FlowStats> flowStats = monitor->GetFlowStats();
   
@@ -337,6 +3374,8 @@ void PrintFinalStatistics()
   std::cout << "Failed Handovers: " << g_failedHandovers << std::endl;
   std::cout << "Fake Attach Attempts: " << g_fakeAttachAttempts << std::endl;
   std::cout << "Faulty Base Station Handovers: " << g_faultyHandovers << std::endl;
+  std::cout << "RRC Event Records: " << g_rrcEventsWritten << " (" << g_rrcEventsMerged
+            << " mirrored reports merged)" << std::endl;
   
   if (g_totalHandovers > 0)
   {
@@ -344,6 +3383,93 @@ void PrintFinalStatistics()
     std::cout << "Handover Success Rate: " << std::fixed << std::setprecision(2) << successRate << "%" << std::endl;
   }
   
+  if (g_detector)
+  {
+    double scoreSeconds = g_detectorScoreNs * 1e-9;
+    std::cout << "\nEmbedded Detector (" << g_detector->GetName() << ", threshold " << g_detectorThreshold << "):\n";
+    std::cout << "Decisions: " << g_detectorDecisions << " in " << g_detectorBatches << " batches\n";
+    if (g_detectorDecisions > 0)
+    {
+      std::cout << "Mean latency per decision: " << std::setprecision(3)
+                << g_detectorScoreNs / double(g_detectorDecisions) << " ns\n";
+      std::cout << "Max batch latency: " << g_detectorMaxBatchNs / 1000.0 << " us\n";
+      std::cout << "Throughput: " << std::setprecision(0)
+                << (scoreSeconds > 0 ? g_detectorDecisions / scoreSeconds : 0.0) << " decisions/s\n";
+    }
+    std::cout << "TP/FP/FN/TN (FAKE candidate): " << g_detectorTruePos << "/" << g_detectorFalsePos << "/"
+              << g_detectorFalseNeg << "/" << g_detectorTrueNeg << "\n";
+    std::cout << "Blacklisted cells:";
+    for (uint32_t c = 0; c < g_cellBlacklisted.size(); ++c)
+    {
+      if (g_cellBlacklisted[c])
+      {
+        std::cout << " " << c + 1 << "(" << g_baseStationTypes[c + 1] << ")";
+      }
+    }
+    std::cout << "\n";
+  }
+  
+  if (g_rogueAwareHo)
+  {
+    uint64_t avoided = g_hoAvoidedNoX2 + g_hoAvoidedSuspicious + g_hoAvoidedBlacklisted;
+    double meanInterruption = g_hoInterruptionCount > 0
+                                ? g_hoInterruptionTotal.GetSeconds() / g_hoInterruptionCount
+                                : 0.0;
+    std::cout << "\nRogue-Aware Handover (vs. plain A3):\n";
+    std::cout << "Avoided handovers: " << avoided << " (no X2: " << g_hoAvoidedNoX2
+              << ", suspicious: " << g_hoAvoidedSuspicious << ", blacklisted: " << g_hoAvoidedBlacklisted
+              << "), redirected to another target (not avoided): " << g_hoRedirected << "\n";
+    std::cout << "Avoided handovers to FAULTY cells: " << g_hoAvoidedFaulty << "\n";
+    std::cout << "Mean measured interruption: " << std::setprecision(1) << meanInterruption * 1000.0
+              << " ms over " << g_hoInterruptionCount << " handovers\n";
+    std::cout << "Interruption avoided (estimate): " << avoided * meanInterruption * 1000.0 << " ms\n";
+  }
+  
+  std::cout << "\nHandover Timing:\n";
+  std::cout << "Mean serving RSRP at handover start: " << std::setprecision(1)
+            << (g_hoStartRsrpCount > 0 ? g_hoStartRsrpSum / g_hoStartRsrpCount : 0.0) << " dBm over "
+            << g_hoStartRsrpCount << " handovers\n";
+  std::cout << "Mean measured interruption: "
+            << (g_hoInterruptionCount > 0 ? g_hoInterruptionTotal.GetSeconds() / g_hoInterruptionCount * 1000.0 : 0.0)
+            << " ms over " << g_hoInterruptionCount << " handovers\n";
+  std::cout << "Handover failures: " << g_hoFailures << "\n";
+  PrintChoStatistics(g_totalHandovers);
+  if (g_predictiveHo)
+  {
+    uint64_t decisions = g_predProactive + g_predReactive;
+    std::cout << "Predictive decisions: " << g_predProactive << " proactive, " << g_predReactive
+              << " reactive (A3 fallback)\n";
+    if (g_predProactive > 0)
+    {
+      std::cout << "Estimated lead over the A3 trigger: " << g_predLeadSeconds / g_predProactive * 1000.0
+                << " ms per proactive handover\n";
+      std::cout << "Serving RSRP at decision: " << g_predDecisionRsrpDbm[1] / g_predProactive << " dBm proactive";
+      if (g_predReactive > 0)
+      {
+        std::cout << ", " << g_predDecisionRsrpDbm[0] / g_predReactive << " dBm reactive";
+      }
+      std::cout << "\n";
+    }
+    std::cout << "Signalling cost: " << g_predTrendReports << " extra periodic measurement reports ("
+              << (decisions > 0 ? (double)g_predTrendReports / decisions : 0.0) << " per decision), "
+              << g_predPingPongs << " proactive handovers reverted within " << kPingPongWindow.GetSeconds() << " s\n";
+  }
+  
+  if (!g_faultTimeline.empty())
+  {
+    std::cout << "\nFault Timeline:\n";
+    std::cout << "Entries applied: " << g_faultApplied << " of " << g_faultTimeline.size() << ", outages: "
+              << g_faultOutages << "\n";
+  }
+  
+  if (g_sigEnabled)
+  {
+    std::cout << "\nHandover Signalling:\n";
+    std::cout << "Traced handovers: " << g_sigCompleted << " completed, " << g_sigIncomplete << " incomplete\n";
+    std::cout << "X2-C messages: " << g_sigX2Messages << " (" << g_sigX2Bytes << " bytes), S11 messages: "
+              << g_sigS11Messages << ", unmatched: " << g_sigUnmatched << "\n";
+  }
+  
   std::cout << "\nBase Station Classification:\n";
   for (auto& pair : g_baseStationTypes)
   {
@@ -356,17 +3482,33 @@ void PrintFinalStatistics()
     std::cout << "UE IMSI " << pair.first << ": " << pair.second << " handovers" << std::endl;
   }
   
+  if (g_trafficBatches > 0)
+  {
+    std::cout << "\nBatched Traffic Sources:\n";
+    std::cout << "Packets sent: " << g_trafficPackets << " in " << g_trafficBatches << " send events (" << std::fixed
+              << std::setprecision(1) << (double)g_trafficPackets / g_trafficBatches << " per event)" << std::endl;
+  }
+  
   std::cout << "\nGenerated Files:\n";
   std::cout << "- comprehensive_meas_reports.csv (measurement reports with BS classification)\n";
-  std::cout << "- comprehensive_enb_rrc_events.csv (eNB RRC events)\n";
-  std::cout << "- comprehensive_ue_rrc_events.csv (UE RRC events)\n";
+  std::cout << "- comprehensive_rrc_events.csv (unified eNB/UE RRC event stream; legacy views via rrc_stream_convert.py)\n";
   std::cout << "- comprehensive_ue_mobility_trace.csv (UE positions and velocities)\n";
   std::cout << "- comprehensive_throughput_analysis.csv (throughput and QoS metrics)\n";
-  std::cout << "- comprehensive_handover_statistics.csv (handover timing analysis)\n";
   std::cout << "- comprehensive_rsrp_measurements.csv (detailed RSRP/RSRQ data)\n";
   std::cout << "- comprehensive_base_station_info.csv (base station classifications)\n";
   std::cout << "- comprehensive_security_events.csv (security-related events)\n";
+  std::cout << "- comprehensive_ue_path_plan.csv (planned border crossings, with --pathPlan)\n";
+  std::cout << "- comprehensive_cell_load.csv (per-cell PRB utilization per epoch, with --enableCellLoad)\n";
+  std::cout << "- comprehensive_phy_rsrp_matrix.csv (ground-truth UE x cell RSRP, with --enablePhyCapture)\n";
+  std::cout << "- comprehensive_ue_state.bin + .schema.json (time x UE state matrix, with --enableStateSnapshot)\n";
+  std::cout << "- comprehensive_features.bin + .schema.json (detector training features, with --enableFeatureExport)\n";
+  std::cout << "- comprehensive_signalling_stages.csv + _histograms.csv (handover stage latencies, with --enableSignalling)\n";
+  std::cout << "- comprehensive_fault_events.csv (applied fault timeline entries, with --faultSchedule)\n";
   std::cout << "- comprehensive-handover-analysis.xml (NetAnim visualization file)\n";
+  std::cout << "- comprehensive_heap_accounting.csv (heap by subsystem and setup phase, with HEAP_ACCOUNTING=1)\n";
+  std::cout << "- comprehensive_digest_trace.txt (canonical golden-digest events, with --digestTrace)\n";
+  std::cout << "- comprehensive_object_census.csv (objects per TypeId, appended per run, with --enableCensus)\n";
+  std::cout << "- comprehensive_log.bin (binary NS_LOG records, with --enableLogs --logFormat=binary; decode with binary_log_decode.py)\n";
   std::cout << "- PCAP files (*.pcap for packet capture analysis)\n";
   std::cout << "\nTo visualize the simulation:\n";
   std::cout << "1. Open NetAnim application\n";
@@ -377,6 +3519,7 @@ void PrintFinalStatistics()
 
 int main(int argc, char* argv[])
 {
+  auto wallStart = std::chrono::steady_clock::now();
   // Optimized simulation parameters for comprehensive BS interaction
   Time simTime = Seconds(120.0); // Longer time for more interactions
   uint32_t numUes = 3;           // Fewer UEs but more focused mobility
@@ -384,9 +3527,41 @@ int main(int argc, char* argv[])
   uint32_t numFaultyEnbs = 1;    // Faulty but legitimate base stations  
   uint32_t numFakeEnbs = 1;      // Fake/rogue base stations
   bool enableLogs = false;
+  std::string logFormat = "text";  // NS_LOG backend: text (stderr) or binary
   bool enablePcap = false;       // Disable by default to reduce file size
   bool enableNetAnim = true;     // Enable NetAnim visualization by default
   double ueSpeed = 15.0;         // Moderate speed for better interaction
+  std::string pathPlan = "";     // Class pairs for the path planner, empty = fixed paths
+  double planCrossingLength = 200.0; // Length of each planned border crossing (m)
+  bool enableCellLoad = false;   // Per-cell PRB/load time series
+  Time loadEpoch = MilliSeconds(100); // Cell load aggregation epoch
+  bool enablePhyCapture = false; // Ground-truth all-cell RSRP/SINR matrix
+  Time phyCaptureInterval = Seconds(1.0); // PHY capture output cadence
+  bool enableStateSnapshot = false; // Per-tick UE state matrix
+  Time stateSnapshotInterval = Seconds(1.0);
+  bool enableFeatureExport = false; // Labelled feature vectors for detector training
+  Time featureWindow = Seconds(1.0); // Feature extraction window
+  std::string detectorModel = "";  // Detector model file, empty = no in-simulation detection
+  double detectorThreshold = -1.0; // Overrides the model threshold when >= 0
+  uint32_t detectorVotes = 3;      // Positive windows before a cell is blacklisted
+  std::string faultSchedule = "";  // Per-cell fault timeline file, empty = static faults only
+  std::string hoAlgorithm = "a3";  // Handover algorithm: a3, rogue-aware, predictive or cho
+  double hoSuspicionThreshold = 0.5; // Rogue-aware: suspicion score that blocks a target
+  double hoSuspicionPenalty = 0.0;   // Rogue-aware: RSRP penalty (dB) per unit of suspicion
+  Time hoPredictionHorizon = MilliSeconds(500); // Predictive: lead of a proactive preparation
+  double choPrepareOffset = 3.0;   // CHO: prepare a neighbour this many dB before the execution condition
+  uint32_t choMaxCandidates = 3;   // CHO: prepared targets per UE
+  bool enableSignalling = false;   // X2/S11 handover stage tracer
+  uint32_t numRemoteHosts = 1;     // Remote hosts sourcing UE traffic, sharded by IMSI
+  uint32_t uesPerRemoteHost = 0;   // If > 0, overrides numRemoteHosts to bound UEs per host
+  Time trafficBatch = Seconds(0);  // UDP aggregation boundary, 0 = one UdpClient per UE
+  std::string goldenMode = "";     // Golden digest: record, verify or empty
+  std::string goldenFile = "golden_digests.txt";
+  bool digestTrace = false;        // Write the canonical digest events
+  bool enableCensus = false;       // Object census by TypeId after setup and at the end
+  double maxWallSeconds = 0;       // Run budgets, 0 = unlimited
+  double maxRssMb = 0;
+  uint64_t maxTraceBytes = 0;
   
   CommandLine cmd;
   cmd.AddValue("simTime", "Simulation time (s)", simTime);
@@ -395,20 +3570,74 @@ int main(int argc, char* argv[])
   cmd.AddValue("numFaultyEnbs", "Number of faulty eNBs", numFaultyEnbs);
   cmd.AddValue("numFakeEnbs", "Number of fake eNBs", numFakeEnbs);
   cmd.AddValue("enableLogs", "Turn on LTE logging", enableLogs);
+  cmd.AddValue("logFormat", "Log backend with enableLogs: text (stderr) or binary (comprehensive_log.bin)", logFormat);
   cmd.AddValue("enablePcap", "Enable PCAP tracing", enablePcap);
   cmd.AddValue("enableNetAnim", "Enable NetAnim visualization", enableNetAnim);
   cmd.AddValue("ueSpeed", "UE speed in m/s", ueSpeed);
+  cmd.AddValue("pathPlan", "Plan UE routes across borders of these class pairs, e.g. LEGITIMATE-FAKE,FAULTY-FAKE or all", pathPlan);
+  cmd.AddValue("planCrossingLength", "Length of each planned border crossing (m)", planCrossingLength);
+  cmd.AddValue("enableCellLoad", "Record per-cell PRB utilization and load per epoch", enableCellLoad);
+  cmd.AddValue("loadEpoch", "Aggregation epoch of the cell load collector", loadEpoch);
+  cmd.AddValue("enablePhyCapture", "Record ground-truth RSRP of every cell seen by every UE", enablePhyCapture);
+  cmd.AddValue("phyCaptureInterval", "Output cadence of the PHY RSRP/SINR matrix", phyCaptureInterval);
+  cmd.AddValue("enableStateSnapshot", "Write the serving cell, RRC state, RSRP and bytes of every UE per tick", enableStateSnapshot);
+  cmd.AddValue("stateSnapshotInterval", "Cadence of the UE state snapshot rows", stateSnapshotInterval);
+  cmd.AddValue("enableFeatureExport", "Write labelled per-UE window feature vectors", enableFeatureExport);
+  cmd.AddValue("featureWindow", "Length of a feature extraction window", featureWindow);
+  cmd.AddValue("detectorModel", "Rogue-cell detector model file scored in the simulation", detectorModel);
+  cmd.AddValue("faultSchedule", "Fault timeline file of <time> <cell> <attribute> <value> lines", faultSchedule);
+  cmd.AddValue("detectorThreshold", "Detector decision threshold (default: from the model file)", detectorThreshold);
+  cmd.AddValue("detectorVotes", "Positive windows needed to blacklist a cell", detectorVotes);
+  cmd.AddValue("hoAlgorithm", "Handover algorithm: a3, rogue-aware, predictive or cho", hoAlgorithm);
+  cmd.AddValue("hoSuspicionThreshold", "Rogue-aware handover: suspicion score that blocks a target", hoSuspicionThreshold);
+  cmd.AddValue("hoSuspicionPenalty", "Rogue-aware handover: RSRP penalty in dB per unit of suspicion", hoSuspicionPenalty);
+  cmd.AddValue("hoPredictionHorizon", "Predictive handover: prepare when the A3 entry is predicted within this time", hoPredictionHorizon);
+  cmd.AddValue("choPrepareOffset", "CHO: prepare a neighbour this many dB before the execution condition (dB)", choPrepareOffset);
+  cmd.AddValue("choMaxCandidates", "CHO: maximum prepared targets per UE", choMaxCandidates);
+  cmd.AddValue("enableSignalling", "Trace X2/S11 handover signalling stages and latencies", enableSignalling);
+  cmd.AddValue("numRemoteHosts", "Number of remote hosts behind the PGW (UEs sharded by IMSI)", numRemoteHosts);
+  cmd.AddValue("uesPerRemoteHost", "UEs per remote host; if > 0, sets numRemoteHosts from numUes", uesPerRemoteHost);
+  cmd.AddValue("trafficBatch", "Send UDP traffic in bursts per UE group at this boundary (e.g. 1ms), 0 = per packet", trafficBatch);
+  cmd.AddValue("goldenMode", "Golden digest mode: record or verify (empty = only print the digest)", goldenMode);
+  cmd.AddValue("goldenFile", "File of golden digests per scenario and seed", goldenFile);
+  cmd.AddValue("digestTrace", "Write the canonical digest events for trace_diff.py", digestTrace);
+  cmd.AddValue("enableCensus", "Count simulation objects per TypeId after setup and at the end of the run", enableCensus);
+  cmd.AddValue("maxWallSeconds", "Stop the run cleanly after this much wall-clock time (0 = unlimited)", maxWallSeconds);
+  cmd.AddValue("maxRssMb", "Stop the run cleanly once peak RSS exceeds this (MB, 0 = unlimited)", maxRssMb);
+  cmd.AddValue("maxTraceBytes", "Stop the run cleanly once the trace files exceed this size (0 = unlimited)", maxTraceBytes);
   cmd.Parse(argc, argv);
 
+  if (digestTrace)
+  {
+    g_digestTraceFile.open("comprehensive_digest_trace.txt");
+  }
+
+  if (uesPerRemoteHost > 0)
+  {
+    numRemoteHosts = (numUes + uesPerRemoteHost - 1) / uesPerRemoteHost;
+  }
+
   uint32_t totalEnbs = numLegitEnbs + numFaultyEnbs + numFakeEnbs;
 
   // Enable logging if requested
   if (enableLogs)
   {
-    LogComponentEnable("LteHelper", LOG_LEVEL_INFO);
-    LogComponentEnable("LteEnbRrc", LOG_LEVEL_INFO);
-    LogComponentEnable("LteUeRrc", LOG_LEVEL_INFO);
-    LogComponentEnable("A3RsrpHandoverAlgorithm", LOG_LEVEL_INFO);
+    LogLevel logLevel = LOG_LEVEL_INFO;
+    if (logFormat == "binary")
+    {
+      // Component and level prefixes let the backend split each line; no time prefix
+      g_binaryLog = new BinaryLogBuf("comprehensive_log.bin");
+      g_textLog = std::clog.rdbuf(g_binaryLog);
+      logLevel = static_cast<LogLevel>(LOG_LEVEL_INFO | LOG_PREFIX_FUNC | LOG_PREFIX_LEVEL);
+    }
+    else if (logFormat != "text")
+    {
+      NS_FATAL_ERROR("Unknown logFormat '" << logFormat << "' (expected text or binary)");
+    }
+    LogComponentEnable("LteHelper", logLevel);
+    LogComponentEnable("LteEnbRrc", logLevel);
+    LogComponentEnable("LteUeRrc", logLevel);
+    LogComponentEnable("A3RsrpHandoverAlgorithm", logLevel);
   }
 
   // Configure global random variables
@@ -416,6 +3645,7 @@ int main(int argc, char* argv[])
   RngSeedManager::SetRun(1);
 
   // Create EPC and LTE helpers
+  HeapPhase("epc");
   Ptr<PointToPointEpcHelper> epcHelper = CreateObject<PointToPointEpcHelper>();
   Ptr<LteHelper> lteHelper = CreateObject<LteHelper>();
   lteHelper->SetEpcHelper(epcHelper);
@@ -424,43 +3654,38 @@ int main(int argc, char* argv[])
   lteHelper->SetEnbAntennaModelType("ns3::IsotropicAntennaModel");
   lteHelper->SetUeAntennaModelType("ns3::IsotropicAntennaModel");
 
-  // Create remote host for traffic generation
+  // Create remote hosts for traffic generation, each on its own
+  // point-to-point link to the PGW
   Ptr<Node> pgw = epcHelper->GetPgwNode();
-  NodeContainer remoteHostContainer;
-  remoteHostContainer.Create(1);
-  Ptr<Node> remoteHost = remoteHostContainer.Get(0);
   InternetStackHelper internet;
-  internet.Install(remoteHostContainer);
-
-  // Create point-to-point link between PGW and remote host
   PointToPointHelper p2ph;
   p2ph.SetDeviceAttribute("DataRate", DataRateValue(DataRate("100Gbps")));
   p2ph.SetChannelAttribute("Delay", TimeValue(MilliSeconds(1)));
-  NetDeviceContainer internetDevices = p2ph.Install(pgw, remoteHost);
-  
-  Ipv4AddressHelper ipv4h;
-  ipv4h.SetBase("1.0.0.0", "255.0.0.0");
-  Ipv4InterfaceContainer internetIpIfaces = ipv4h.Assign(internetDevices);
+  NetDeviceContainer internetDevices = SetupRemoteHosts(pgw, numRemoteHosts, internet, p2ph);
+  std::cout << "Remote hosts: " << g_remoteHosts.GetN() << " (up to "
+            << (numUes + g_remoteHosts.GetN() - 1) / g_remoteHosts.GetN() << " UEs each)" << std::endl;
   
-  // Set up routing
   Ipv4StaticRoutingHelper ipv4RoutingHelper;
-  Ptr<Ipv4StaticRouting> remoteHostStaticRouting = ipv4RoutingHelper.GetStaticRouting(remoteHost->GetObject<Ipv4>());
-  remoteHostStaticRouting->AddNetworkRouteTo(Ipv4Address("7.0.0.0"), Ipv4Mask("255.0.0.0"), 1);
 
   // Set constant positions for infrastructure nodes (to avoid NetAnim warnings)
   MobilityHelper infraMobility;
   infraMobility.SetMobilityModel("ns3::ConstantPositionMobilityModel");
   infraMobility.Install(pgw);
-  infraMobility.Install(remoteHost);
+  infraMobility.Install(g_remoteHosts);
   
   // Position infrastructure nodes
   Ptr<MobilityModel> pgwMobility = pgw->GetObject<MobilityModel>();
   pgwMobility->SetPosition(Vector(-300.0, 0.0, 0.0));
   
-  Ptr<MobilityModel> remoteHostMobility = remoteHost->GetObject<MobilityModel>();
-  remoteHostMobility->SetPosition(Vector(-400.0, 0.0, 0.0));
+  // Remote hosts stacked in a column behind the PGW
+  for (uint32_t h = 0; h < g_remoteHosts.GetN(); ++h)
+  {
+    Ptr<MobilityModel> remoteHostMobility = g_remoteHosts.Get(h)->GetObject<MobilityModel>();
+    remoteHostMobility->SetPosition(Vector(-400.0, 40.0 * h, 0.0));
+  }
 
   // Create nodes
+  HeapPhase("topology");
   NodeContainer enbNodes;
   enbNodes.Create(totalEnbs);
   NodeContainer ueNodes;
@@ -475,6 +3700,7 @@ int main(int argc, char* argv[])
   {
     enbPositionAlloc->Add(Vector(i * 250.0, 0.0, 30.0));  // Reduced spacing
     g_baseStationTypes[i + 1] = "LEGITIMATE";  // Cell IDs start from 1
+    g_cellSites.push_back({uint16_t(i + 1), "LEGITIMATE", Vector(i * 250.0, 0.0, 30.0), CellTypeTxPower("LEGITIMATE")});
   }
   
   // Faulty eNB - positioned to create overlap with legitimate
@@ -482,6 +3708,7 @@ int main(int argc, char* argv[])
   {
     enbPositionAlloc->Add(Vector(125.0, 150.0, 30.0));  // Strategic position
     g_baseStationTypes[numLegitEnbs + i + 1] = "FAULTY";
+    g_cellSites.push_back({uint16_t(numLegitEnbs + i + 1), "FAULTY", Vector(125.0, 150.0, 30.0), CellTypeTxPower("FAULTY")});
   }
   
   // Fake eNB - positioned to intercept UE paths
@@ -489,45 +3716,108 @@ int main(int argc, char* argv[])
   {
     enbPositionAlloc->Add(Vector(125.0, -150.0, 30.0));  // Strategic interception point
     g_baseStationTypes[numLegitEnbs + numFaultyEnbs + i + 1] = "FAKE";
+    g_cellSites.push_back({uint16_t(numLegitEnbs + numFaultyEnbs + i + 1), "FAKE", Vector(125.0, -150.0, 30.0), CellTypeTxPower("FAKE")});
   }
   
   enbMobility.SetPositionAllocator(enbPositionAlloc);
   enbMobility.SetMobilityModel("ns3::ConstantPositionMobilityModel");
   enbMobility.Install(enbNodes);
 
+  // Plan UE routes across the requested class borders if asked to
+  std::vector<PlannedRoute> plannedRoutes;
+  if (!pathPlan.empty())
+  {
+    plannedRoutes = PlanBorderRoutes(ParseClassPairs(pathPlan), std::max(10.0, planCrossingLength) / 2.0);
+    if (plannedRoutes.empty())
+    {
+      NS_FATAL_ERROR("pathPlan: no reachable border for any of the class pairs in '" << pathPlan << "'");
+    }
+  }
+  std::vector<uint32_t> initialEnb(numUes, 0);  // eNB index each UE attaches to
+
   // Set up strategic UE mobility patterns to interact with all BS types
   MobilityHelper ueMobility;
   
-  for (uint32_t i = 0; i < numUes; ++i)
+  if (!plannedRoutes.empty())
   {
-    // All UEs use strategic paths to encounter all base station types
-    ueMobility.SetMobilityModel("ns3::ConstantVelocityMobilityModel");
-    ueMobility.Install(ueNodes.Get(i));
+    g_pathPlanFile.open("comprehensive_ue_path_plan.csv");
+    g_pathPlanFile << "imsi,group,classPair,crossing,cellA,cellB,borderX,borderY,predictedRsrpDbm\n";
+    initialEnb = InstallPlannedRoutes(ueNodes, plannedRoutes, ueSpeed, simTime);
+  }
+  else
+  {
+    for (uint32_t i = 0; i < numUes; ++i)
+    {
+      // All UEs use strategic paths to encounter all base station types
+      ueMobility.SetMobilityModel("ns3::ConstantVelocityMobilityModel");
+      ueMobility.Install(ueNodes.Get(i));
     
-    Ptr<MobilityModel> mobilityModel = ueNodes.Get(i)->GetObject<MobilityModel>();
-    Ptr<ConstantVelocityMobilityModel> cvMobility = DynamicCast<ConstantVelocityMobilityModel>(mobilityModel);
+      Ptr<MobilityModel> mobilityModel = ueNodes.Get(i)->GetObject<MobilityModel>();
+      Ptr<ConstantVelocityMobilityModel> cvMobility = DynamicCast<ConstantVelocityMobilityModel>(mobilityModel);
     
-    if (i == 0)
-    {
-      // UE 0: Horizontal path through all legitimate eNBs and near fake/faulty
-      cvMobility->SetPosition(Vector(-200.0, 0.0, 1.5));
-      cvMobility->SetVelocity(Vector(ueSpeed, 0.0, 0.0));
-    }
-    else if (i == 1)
-    {
-      // UE 1: Vertical zigzag to encounter all types
-      cvMobility->SetPosition(Vector(125.0, -300.0, 1.5));
-      cvMobility->SetVelocity(Vector(0.0, ueSpeed, 0.0));
-    }
-    else
-    {
-      // UE 2: Diagonal path intersecting all coverage areas
-      cvMobility->SetPosition(Vector(-100.0, -200.0, 1.5));
-      cvMobility->SetVelocity(Vector(ueSpeed * 0.7, ueSpeed * 0.7, 0.0));
+      if (i == 0)
+      {
+        // UE 0: Horizontal path through all legitimate eNBs and near fake/faulty
+        cvMobility->SetPosition(Vector(-200.0, 0.0, 1.5));
+        cvMobility->SetVelocity(Vector(ueSpeed, 0.0, 0.0));
+      }
+      else if (i == 1)
+      {
+        // UE 1: Vertical zigzag to encounter all types
+        cvMobility->SetPosition(Vector(125.0, -300.0, 1.5));
+        cvMobility->SetVelocity(Vector(0.0, ueSpeed, 0.0));
+      }
+      else
+      {
+        // UE 2: Diagonal path intersecting all coverage areas
+        cvMobility->SetPosition(Vector(-100.0, -200.0, 1.5));
+        cvMobility->SetVelocity(Vector(ueSpeed * 0.7, ueSpeed * 0.7, 0.0));
+      }
     }
   }
 
+  // The handover algorithm is created with the eNB devices, so configure it before installing them
+  if (hoAlgorithm == "rogue-aware")
+  {
+    g_rogueAwareHo = true;
+    lteHelper->SetHandoverAlgorithmType("ns3::RogueAwareA3HandoverAlgorithm");
+    lteHelper->SetHandoverAlgorithmAttribute("Hysteresis", DoubleValue(1.0));
+    lteHelper->SetHandoverAlgorithmAttribute("TimeToTrigger", TimeValue(MilliSeconds(64)));
+    lteHelper->SetHandoverAlgorithmAttribute("SuspicionThreshold", DoubleValue(hoSuspicionThreshold));
+    lteHelper->SetHandoverAlgorithmAttribute("SuspicionPenalty", DoubleValue(hoSuspicionPenalty));
+  }
+  else if (hoAlgorithm == "predictive")
+  {
+    g_predictiveHo = true;
+    g_predictiveUeNodes = ueNodes;
+    lteHelper->SetHandoverAlgorithmType("ns3::PredictiveHandoverAlgorithm");
+    lteHelper->SetHandoverAlgorithmAttribute("Hysteresis", DoubleValue(1.0));
+    lteHelper->SetHandoverAlgorithmAttribute("TimeToTrigger", TimeValue(MilliSeconds(64)));
+    lteHelper->SetHandoverAlgorithmAttribute("PredictionHorizon", TimeValue(hoPredictionHorizon));
+  }
+  else if (hoAlgorithm == "cho")
+  {
+    g_choHo = true;
+    lteHelper->SetHandoverAlgorithmType("ns3::ChoHandoverAlgorithm");
+    lteHelper->SetHandoverAlgorithmAttribute("Hysteresis", DoubleValue(1.0));
+    lteHelper->SetHandoverAlgorithmAttribute("TimeToTrigger", TimeValue(MilliSeconds(64)));
+    lteHelper->SetHandoverAlgorithmAttribute("PrepareOffset", DoubleValue(choPrepareOffset));
+    lteHelper->SetHandoverAlgorithmAttribute("MaxCandidates", UintegerValue(choMaxCandidates));
+  }
+  else if (hoAlgorithm == "a3")
+  {
+    g_hoTimingFromReports = true;
+    lteHelper->SetHandoverAlgorithmType("ns3::A3RsrpHandoverAlgorithm");
+    lteHelper->SetHandoverAlgorithmAttribute("Hysteresis", DoubleValue(1.0));      // Lower hysteresis
+    lteHelper->SetHandoverAlgorithmAttribute("TimeToTrigger", TimeValue(MilliSeconds(64))); // Faster trigger
+  }
+  else
+  {
+    NS_FATAL_ERROR("Unknown hoAlgorithm '" << hoAlgorithm << "' (expected a3, rogue-aware, predictive or cho)");
+  }
+
   // Install LTE devices
+  HeapPhase("lte-devices");
   NetDeviceContainer enbLteDevs = lteHelper->InstallEnbDevice(enbNodes);
   NetDeviceContainer ueLteDevs = lteHelper->InstallUeDevice(ueNodes);
 
@@ -543,18 +3833,38 @@ int main(int argc, char* argv[])
   }
 
   // Create X2 interfaces only between legitimate and faulty eNBs (not fake ones)
+  HeapPhase("x2");
   for (uint32_t i = 0; i < numLegitEnbs + numFaultyEnbs; ++i)
   {
     for (uint32_t j = i + 1; j < numLegitEnbs + numFaultyEnbs; ++j)
     {
       lteHelper->AddX2Interface(enbNodes.Get(i), enbNodes.Get(j));
+      g_x2Links.insert(std::make_pair(uint16_t(i + 1), uint16_t(j + 1)));
     }
   }
 
-  // Configure handover algorithm with more aggressive parameters
-  lteHelper->SetHandoverAlgorithmType("ns3::A3RsrpHandoverAlgorithm");
-  lteHelper->SetHandoverAlgorithmAttribute("Hysteresis", DoubleValue(1.0));      // Lower hysteresis
-  lteHelper->SetHandoverAlgorithmAttribute("TimeToTrigger", TimeValue(MilliSeconds(64))); // Faster trigger
+  // The handover algorithm does not know its own cell; hand it over after installation
+  g_cellHistory.assign(totalEnbs, CellHistory());
+  for (uint32_t i = 0; i < totalEnbs; ++i)
+  {
+    PointerValue algorithm;
+    enbLteDevs.Get(i)->GetAttribute("LteHandoverAlgorithm", algorithm);
+    Ptr<RogueAwareA3HandoverAlgorithm> rogueAware = algorithm.Get<RogueAwareA3HandoverAlgorithm>();
+    if (rogueAware)
+    {
+      rogueAware->SetCellId(i + 1);
+    }
+    Ptr<PredictiveHandoverAlgorithm> predictive = algorithm.Get<PredictiveHandoverAlgorithm>();
+    if (predictive)
+    {
+      predictive->SetCellId(i + 1);
+    }
+    Ptr<ChoHandoverAlgorithm> cho = algorithm.Get<ChoHandoverAlgorithm>();
+    if (cho)
+    {
+      cho->SetCellId(i + 1);
+    }
+  }
 
   // Apply specific configurations to different base station types
   for (uint32_t i = 0; i < totalEnbs; ++i)
@@ -566,13 +3876,13 @@ int main(int argc, char* argv[])
     {
       // Normal power and parameters for legitimate eNBs
       Config::Set("/NodeList/" + std::to_string(nodeId) + "/DeviceList/*/LteEnbPhy/TxPower", 
-                  DoubleValue(43.0)); // 20W
+                  DoubleValue(g_cellSites[i].txPowerDbm)); // 20W
     }
     else if (g_baseStationTypes[cellId] == "FAULTY")
     {
       // Reduced power and poor handover parameters for faulty eNBs
       Config::Set("/NodeList/" + std::to_string(nodeId) + "/DeviceList/*/LteEnbPhy/TxPower", 
-                  DoubleValue(25.0)); // Slightly better than before but still poor
+                  DoubleValue(g_cellSites[i].txPowerDbm)); // Slightly better than before but still poor
       Config::Set("/NodeList/" + std::to_string(nodeId) + "/DeviceList/*/LteEnbRrc/HandoverAlgorithm/Hysteresis", 
                   DoubleValue(6.0));  // Reduced from 8.0
       Config::Set("/NodeList/" + std::to_string(nodeId) + "/DeviceList/*/LteEnbRrc/HandoverAlgorithm/TimeToTrigger", 
@@ -582,7 +3892,7 @@ int main(int argc, char* argv[])
     {
       // High power to attract UEs but configure as CSG for access denial
       Config::Set("/NodeList/" + std::to_string(nodeId) + "/DeviceList/*/LteEnbPhy/TxPower", 
-                  DoubleValue(40.0)); // Reduced from 46.0 to be attractive but not overwhelming
+                  DoubleValue(g_cellSites[i].txPowerDbm)); // Reduced from 46.0 to be attractive but not overwhelming
       Config::Set("/NodeList/" + std::to_string(nodeId) + "/DeviceList/*/LteEnbNetDevice/CsgIndication", 
                   BooleanValue(true));
       Config::Set("/NodeList/" + std::to_string(nodeId) + "/DeviceList/*/LteEnbNetDevice/CsgId", 
@@ -590,15 +3900,37 @@ int main(int argc, char* argv[])
     }
   }
 
-  // Attach UEs to the first legitimate eNB initially
+  // Scheduled faults start from the static configuration above
+  if (!faultSchedule.empty())
+  {
+    SetupFaultTimeline(faultSchedule, enbLteDevs);
+  }
+
+  // Attach UEs to the first legitimate eNB initially (or the planned start cell)
   for (uint32_t i = 0; i < numUes; ++i)
   {
-    lteHelper->Attach(ueLteDevs.Get(i), enbLteDevs.Get(0));
+    lteHelper->Attach(ueLteDevs.Get(i), enbLteDevs.Get(initialEnb[i]));
   }
 
   // Set up lightweight traffic applications to reduce PCAP size
+  HeapPhase("applications");
   ApplicationContainer serverApps, clientApps;
   
+  // With trafficBatch, one batched source per remote host carries the
+  // downlink flows of all UEs in its shard
+  std::vector<Ptr<BatchedUdpSource>> dlBatchSources;
+  if (trafficBatch > Seconds(0))
+  {
+    for (uint32_t h = 0; h < g_remoteHosts.GetN(); ++h)
+    {
+      Ptr<BatchedUdpSource> source = CreateObject<BatchedUdpSource>();
+      source->SetAttribute("BatchInterval", TimeValue(trafficBatch));
+      g_remoteHosts.Get(h)->AddApplication(source);
+      clientApps.Add(source);
+      dlBatchSources.push_back(source);
+    }
+  }
+
   // Simplified traffic patterns - only essential traffic
   for (uint32_t i = 0; i < numUes; ++i)
   {
@@ -608,11 +3940,16 @@ int main(int argc, char* argv[])
     UdpServerHelper dlPacketSinkHelper(dlPort);
     serverApps.Add(dlPacketSinkHelper.Install(ueNodes.Get(i)));
     
+    if (!dlBatchSources.empty())
+    {
+      dlBatchSources[RemoteHostShard(i + 1)]->AddFlow(ueIpIfaces.GetAddress(i), dlPort, MilliSeconds(100), 512, 10000);
+      continue;
+    }
     UdpClientHelper dlClient(ueIpIfaces.GetAddress(i), dlPort);
     dlClient.SetAttribute("Interval", TimeValue(MilliSeconds(100)));  // Reduced frequency
     dlClient.SetAttribute("MaxPackets", UintegerValue(10000));        // Fewer packets
     dlClient.SetAttribute("PacketSize", UintegerValue(512));          // Smaller packets
-    clientApps.Add(dlClient.Install(remoteHost));
+    clientApps.Add(dlClient.Install(g_remoteHosts.Get(RemoteHostShard(i + 1))));
   }
 
   // Start applications
@@ -620,16 +3957,64 @@ int main(int argc, char* argv[])
   clientApps.Start(Seconds(1.0));
 
   // Set up flow monitoring
+  HeapPhase("flowmonitor");
   FlowMonitorHelper flowHelper;
   Ptr<FlowMonitor> monitor = flowHelper.InstallAll();
   
   // Schedule throughput monitoring
   Simulator::Schedule(Seconds(2.0), &MonitorThroughput, monitor, &flowHelper);
+
+  // Per-cell MAC load counters
+  HeapPhase("tracers");
+  if (enableCellLoad)
+  {
+    SetupCellLoadCollector(enbLteDevs, loadEpoch);
+  }
+
+  // Ground-truth PHY measurements of all cells
+  if (enablePhyCapture)
+  {
+    SetupPhyCapture(ueLteDevs, totalEnbs, phyCaptureInterval);
+  }
+
+  // Dense per-tick UE state matrix
+  if (enableStateSnapshot)
+  {
+    SetupUeStateSnapshot(ueNodes, stateSnapshotInterval);
+  }
+
+  // X2 and S11 handover signalling stages
+  if (enableSignalling)
+  {
+    SetupSignallingTracer(enbNodes, epcHelper->GetSgwNode(), pgw, numUes);
+  }
+
+  // In-simulation rogue-cell detector
+  if (!detectorModel.empty())
+  {
+    g_detector = LoadDetectorModel(detectorModel, g_detectorThreshold);
+    if (detectorThreshold >= 0.0)
+    {
+      g_detectorThreshold = detectorThreshold;
+    }
+    g_detectorVotes = std::max<uint32_t>(1, detectorVotes);
+    g_cellDetectorVotes.assign(totalEnbs, 0);
+    g_cellBlacklisted.assign(totalEnbs, 0);
+  }
+
+  // Windowed feature vectors for detector training and/or inference
+  if (enableFeatureExport || g_detector)
+  {
+    SetupFeatureExport(enbLteDevs, ueLteDevs, featureWindow, enableFeatureExport);
+  }
   
   // Schedule UE direction changes to ensure interaction with all BS types
-  for (uint32_t i = 0; i < numUes; ++i)
+  if (plannedRoutes.empty())
   {
-    Simulator::Schedule(Seconds(20.0), &ChangeUeDirection, i, ueNodes, ueSpeed);
+    for (uint32_t i = 0; i < numUes; ++i)
+    {
+      Simulator::Schedule(Seconds(20.0), &ChangeUeDirection, i, ueNodes, ueSpeed);
+    }
   }
 
   // Enable selective PCAP tracing if requested (only control plane)
@@ -640,8 +4025,11 @@ int main(int argc, char* argv[])
     // Skip PDCP traces to reduce file size significantly
     // lteHelper->EnablePdcpTraces();
     
-    // Only trace control plane on P2P link, not user data
-    p2ph.EnablePcap("comprehensive-handover-control", internetDevices.Get(0), true);
+    // Only trace control plane on the PGW side of each remote host link, not user data
+    for (uint32_t d = 0; d < internetDevices.GetN(); d += 2)
+    {
+      p2ph.EnablePcap("comprehensive-handover-control", internetDevices.Get(d), true);
+    }
   }
 
   // Connect all trace sources
@@ -662,17 +4050,23 @@ int main(int argc, char* argv[])
   Config::Connect("/NodeList/*/DeviceList/*/LteUeRrc/HandoverEndOk",
                   MakeCallback(&UeHoEndOk));
 
+  // Handover failure traces exist from ns-3.37 on
+  for (const char* failure : {"HandoverFailureNoPreamble", "HandoverFailureMaxRach", "HandoverFailureLeaving",
+                              "HandoverFailureJoining"})
+  {
+    Config::ConnectFailSafe(std::string("/NodeList/*/DeviceList/*/LteEnbRrc/") + failure, MakeCallback(&EnbHoFailure));
+  }
+  Config::ConnectFailSafe("/NodeList/*/DeviceList/*/LteUeRrc/RadioLinkFailure", MakeCallback(&UeRadioLinkFailure));
+
   // Connect mobility tracing
   Config::Connect("/NodeList/*/$ns3::MobilityModel/CourseChange",
                   MakeCallback(&CourseChange));
 
   // Initialize CSV file headers
   g_measCsv << "time,imsi,enbCellId,cellType,rnti,measId,event,servingRsrpQ,servingRsrqQ,servingRsrpDbm,servingRsrqDb,neighborCells\n";
-  g_enbRrcCsv << "event,time,imsi,cellId,cellType,rnti,info\n";
-  g_ueRrcCsv << "event,time,imsi,cellId,cellType,rnti,info\n";
+  OpenRrcEventStream("comprehensive_rrc_events.csv", &RrcCellType);
   g_mobilityTraceFile << "time,nodeId,posX,posY,posZ,velX,velY,velZ,speed\n";
   g_throughputFile << "time,flowId,throughputMbps,delayMs,jitterMs,packetLossPercent,rxPackets,txPackets\n";
-  g_handoverStatsFile << "event,time,imsi,sourceCellId,sourceCellType,targetCellId,targetCellType\n";
   g_rsrpFile << "time,imsi,cellId,cellType,rsrpDbm,rsrqDb\n";
   g_baseStationFile << "cellId,nodeId,cellType,posX,posY,posZ,txPowerDbm\n";
   g_securityEventsFile << "time,eventType,details\n";
@@ -684,9 +4078,7 @@ int main(int argc, char* argv[])
     uint16_t cellId = i + 1;
     std::string cellType = g_baseStationTypes[cellId];
     
-    double txPower = 43.0; // Default
-    if (cellType == "FAULTY") txPower = 25.0;        // Updated value
-    else if (cellType == "FAKE") txPower = 40.0;     // Updated value
+    double txPower = g_cellSites[i].txPowerDbm;
     
     g_baseStationFile << cellId << "," << enbNodes.Get(i)->GetId() << "," 
                       << cellType << "," << pos.x << "," << pos.y << "," 
@@ -701,10 +4093,13 @@ int main(int argc, char* argv[])
   std::cout << "- Faulty eNBs: " << numFaultyEnbs << "\n";
   std::cout << "- Fake eNBs: " << numFakeEnbs << "\n";
   std::cout << "- UE Speed: " << ueSpeed << " m/s\n";
+  std::cout << "- UE Paths: " << (plannedRoutes.empty() ? "Fixed" : "Planned (" + pathPlan + ")") << "\n";
+  std::cout << "- Handover Algorithm: " << hoAlgorithm << "\n";
   std::cout << "- PCAP Tracing: " << (enablePcap ? "Enabled" : "Disabled") << "\n";
   std::cout << "- NetAnim Visualization: " << (enableNetAnim ? "Enabled" : "Disabled") << "\n";
 
   // Set up NetAnim visualization
+  HeapPhase("netanim");
   AnimationInterface* anim = nullptr;
   if (enableNetAnim)
   {
@@ -756,9 +4151,13 @@ int main(int argc, char* argv[])
     anim->UpdateNodeColor(pgw, 128, 0, 128); // Purple for PGW
     anim->UpdateNodeSize(pgw, 20.0, 20.0);
     
-    anim->UpdateNodeDescription(remoteHost, "RemoteHost");
-    anim->UpdateNodeColor(remoteHost, 0, 128, 128); // Teal for remote host
-    anim->UpdateNodeSize(remoteHost, 12.0, 12.0);
+    for (uint32_t h = 0; h < g_remoteHosts.GetN(); ++h)
+    {
+      Ptr<Node> remoteHost = g_remoteHosts.Get(h);
+      anim->UpdateNodeDescription(remoteHost, "RemoteHost-" + std::to_string(h));
+      anim->UpdateNodeColor(remoteHost, 0, 128, 128); // Teal for remote hosts
+      anim->UpdateNodeSize(remoteHost, 12.0, 12.0);
+    }
     
     // Enable packet animation for key flows
     anim->EnablePacketMetadata(true);
@@ -772,15 +4171,48 @@ int main(int argc, char* argv[])
     std::cout << "UE colors change based on connection: Green=Legitimate, Orange=Faulty, Magenta=Fake, Yellow=During Handover\n";
   }
 
+  if (enableCensus)
+  {
+    WriteObjectCensus("comprehensive_object_census.csv", "setup", numUes, totalEnbs);
+  }
+
   // Run simulation
+  HeapPhase("run");
   Simulator::Stop(simTime);
+  StartRunBudget(wallStart, maxWallSeconds, maxRssMb, maxTraceBytes, {"comprehensive"});
+  double setupSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - wallStart).count();
   Simulator::Run();
+  StopRunBudget();
+  double runSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - wallStart).count() - setupSeconds;
+  uint64_t events = Simulator::GetEventCount();
+  double simSeconds = g_budgetExceeded.empty() ? simTime.GetSeconds() : g_budgetStopTime.GetSeconds();
 
   // Final flow monitor check
   monitor->CheckForLostPackets();
+  // Partial cell load epoch, while the simulator clock still reads the end time
+  FlushFinalCellLoadEpoch();
+  FlushFinalFeatureWindows();
+  FlushFinalPhyMatrix();
+  WriteFinalUeStateRow();
+  if (enableCensus)
+  {
+    WriteObjectCensus("comprehensive_object_census.csv", "end", numUes, totalEnbs);
+  }
   
   // Clean up
+  HeapPhase("teardown");
+  if (g_binaryLog)
+  {
+    g_binaryLog->FreezeClock();
+  }
   Simulator::Destroy();
+  if (g_binaryLog)
+  {
+    std::clog.rdbuf(g_textLog);
+    std::cout << "Binary log: " << g_binaryLog->GetRecords() << " records, " << g_binaryLog->GetBytes()
+              << " bytes in comprehensive_log.bin\n";
+    delete g_binaryLog;
+  }
 
   // Clean up NetAnim
   if (anim)
@@ -790,17 +4222,79 @@ int main(int argc, char* argv[])
 
   // Close all files
   g_measCsv.close();
-  g_enbRrcCsv.close();
-  g_ueRrcCsv.close();
+  CloseRrcEventStream();
   g_mobilityTraceFile.close();
   g_throughputFile.close();
-  g_handoverStatsFile.close();
   g_rsrpFile.close();
   g_baseStationFile.close();
   g_securityEventsFile.close();
+  if (g_pathPlanFile.is_open())
+  {
+    g_pathPlanFile.close();
+  }
+  if (g_cellLoadFile.is_open())
+  {
+    g_cellLoadFile.close();
+  }
+  if (g_phyMatrixFile.is_open())
+  {
+    g_phyMatrixFile.close();
+  }
+  if (g_faultEventsFile.is_open())
+  {
+    g_faultEventsFile.close();
+  }
+  if (g_ueStateFile.is_open())
+  {
+    g_ueStateFile.close();
+    std::cout << "UE state rows written: " << g_ueStateRows << "\n";
+  }
+  if (g_featureFile.is_open())
+  {
+    g_featureFile.close();
+    std::cout << "Feature records written: " << g_featureRecords << "\n";
+  }
+  if (g_signallingFile.is_open())
+  {
+    g_signallingFile.close();
+    WriteSignallingHistograms();
+  }
+
+  // KPI summary closes the golden digest
+  DigestEvent("KPI,handovers," + std::to_string(g_totalHandovers));
+  DigestEvent("KPI,successfulHandovers," + std::to_string(g_successfulHandovers));
+  DigestEvent("KPI,hoFailures," + std::to_string(g_hoFailures));
+  DigestEvent("KPI,failedHandovers," + std::to_string(g_failedHandovers));
+  DigestEvent("KPI,fakeAttachAttempts," + std::to_string(g_fakeAttachAttempts));
+  DigestEvent("KPI,faultyHandovers," + std::to_string(g_faultyHandovers));
+  DigestEvent("KPI,hoAvoided," + std::to_string(g_hoAvoidedNoX2) + "," + std::to_string(g_hoAvoidedSuspicious) + ","
+              + std::to_string(g_hoAvoidedBlacklisted));
+  DigestEvent("KPI,hoAvoidedFaulty," + std::to_string(g_hoAvoidedFaulty));
+  DigestEvent("KPI,hoRedirected," + std::to_string(g_hoRedirected));
+  for (const auto& pair : g_ueHandoverCount)
+  {
+    DigestEvent("KPI,ueHandovers," + std::to_string(pair.first) + "," + std::to_string(pair.second));
+  }
 
   // Print final statistics
   PrintFinalStatistics();
+  WriteHeapAccounting();
 
-  return 0;
+  if (!g_budgetExceeded.empty())
+  {
+    std::cout << "\nRESULT TRUNCATED: " << g_budgetExceeded << " budget exceeded, simulated " << simSeconds << " of "
+              << simTime.GetSeconds() << " s; all outputs cover [0, " << simSeconds << "] s only\n";
+    if (goldenMode == "record")
+    {
+      std::cout << "Not recording the golden digest of a truncated run\n";
+      goldenMode = "";
+    }
+  }
+
+  bool digestOk = FinishDigest(goldenMode, goldenFile, DigestScenarioKey("comprehensive-handover-analysis", argc, argv));
+  g_digestTraceFile.close();
+
+  PrintBenchLine("comprehensive-handover-analysis", setupSeconds, runSeconds, events, simSeconds, g_budgetExceeded);
+
+  return digestOk ? 0 : 1;
 }
@@ -4,6 +4,7 @@
 #include "ns3/internet-module.h"
 #include "ns3/lte-module.h"
 #include "ns3/point-to-point-helper.h"
+#include "ns3/point-to-point-module.h"
 #include "ns3/applications-module.h"
 #include "ns3/config-store-module.h"
 #include "ns3/flow-monitor-module.h"
@@ -12,6 +13,21 @@
 #include <iomanip>
 #include <cmath>
 #include <cstdlib>
+#include <algorithm>
+#include <set>
+#include <deque>
+#include <chrono>
+
+#include "common/remote-hosts.h"
+#include "common/batched-udp-source.h"
+#include "common/golden-digest.h"
+#include "common/object-census.h"
+#include "common/bench-line.h"
+#include "common/run-budget.h"
+#include "common/binary-log.h"
+#include "common/conditional-handover.h"
+#include "common/rrc-event-stream.h"
+#include "common/x2-links.h"
 
 using namespace ns3;
 
@@ -19,11 +35,8 @@ NS_LOG_COMPONENT_DEFINE("HandoverMobilityAnalysis");
 
 // Global file streams for data collection
 static std::ofstream g_measCsv("handover_meas_reports.csv");
-static std::ofstream g_enbRrcCsv("handover_enb_rrc_events.csv");
-static std::ofstream g_ueRrcCsv("handover_ue_rrc_events.csv");
 static std::ofstream g_mobilityTraceFile("ue_mobility_trace.csv");
 static std::ofstream g_throughputFile("throughput_analysis.csv");
-static std::ofstream g_handoverStatsFile("handover_statistics.csv");
 static std::ofstream g_rsrpFile("rsrp_measurements.csv");
 
 // Global counters for statistics
@@ -33,6 +46,911 @@ static uint32_t g_failedHandovers = 0;
 static std::map<uint64_t, uint32_t> g_ueHandoverCount;
 static std::map<uint64_t, Vector> g_lastUePosition;
 
+// ---------------------------------------------------------------------------
+// X2-U data forwarding accounting
+//
+// During a handover the source eNB forwards buffered and in-flight downlink
+// data to the target over X2-U (GTP-U). The X2 devices are tapped at MacTx;
+// forwarded packets are attributed to the UE through the bearer TEIDs carried
+// by the X2 Handover Request, and accumulated per handover (IMSI + start time).
+// A handover's record is written when the UE's next handover starts or at the
+// end of the run, so the drain after completion is included.
+// ---------------------------------------------------------------------------
+
+struct X2uForwarding
+{
+  uint16_t sourceCellId = 0;
+  uint16_t targetCellId = 0;
+  Time hoStart;
+  Time hoEnd = Seconds(-1);
+  uint32_t packets = 0;
+  uint64_t bytes = 0;
+  Time firstForward;
+  Time lastForward;
+};
+
+static std::ofstream g_x2uForwardingFile("handover_x2u_forwarding.csv");
+static std::map<uint32_t, uint64_t> g_x2uTeidToImsi;
+static std::map<uint64_t, X2uForwarding> g_x2uForwarding;  // IMSI -> current handover
+static uint32_t g_x2uHandovers = 0;
+static uint32_t g_x2uHandoversWithForwarding = 0;
+static uint64_t g_x2uTotalBytes = 0;
+static uint64_t g_x2uMaxBytes = 0;
+static double g_x2uMaxDurationMs = 0.0;
+
+static void FlushX2uForwarding(uint64_t imsi, const X2uForwarding& f)
+{
+  double durationMs = f.packets > 0 ? (f.lastForward - f.firstForward).GetSeconds() * 1000.0 : 0.0;
+  double drainMs = (f.packets > 0 && f.hoEnd >= Seconds(0) && f.lastForward > f.hoEnd)
+                     ? (f.lastForward - f.hoEnd).GetSeconds() * 1000.0
+                     : 0.0;
+  g_x2uForwardingFile << imsi << "," << f.sourceCellId << "," << f.targetCellId << ","
+                      << std::fixed << std::setprecision(6) << f.hoStart.GetSeconds() << ","
+                      << (f.hoEnd >= Seconds(0) ? f.hoEnd.GetSeconds() : -1.0) << ","
+                      << f.packets << "," << f.bytes << ","
+                      << (f.packets > 0 ? f.firstForward.GetSeconds() : -1.0) << ","
+                      << (f.packets > 0 ? f.lastForward.GetSeconds() : -1.0) << ","
+                      << std::setprecision(3) << durationMs << "," << drainMs << "\n";
+
+  g_x2uHandovers++;
+  if (f.packets > 0)
+  {
+    g_x2uHandoversWithForwarding++;
+  }
+  g_x2uTotalBytes += f.bytes;
+  g_x2uMaxBytes = std::max(g_x2uMaxBytes, f.bytes);
+  g_x2uMaxDurationMs = std::max(g_x2uMaxDurationMs, durationMs);
+}
+
+static void X2uHandoverStart(uint64_t imsi, uint16_t sourceCellId, uint16_t targetCellId)
+{
+  auto it = g_x2uForwarding.find(imsi);
+  if (it != g_x2uForwarding.end())
+  {
+    FlushX2uForwarding(imsi, it->second);
+  }
+  X2uForwarding& f = g_x2uForwarding[imsi];
+  f = X2uForwarding();
+  f.sourceCellId = sourceCellId;
+  f.targetCellId = targetCellId;
+  f.hoStart = Simulator::Now();
+}
+
+static void X2uHandoverEnd(uint64_t imsi)
+{
+  auto it = g_x2uForwarding.find(imsi);
+  if (it != g_x2uForwarding.end())
+  {
+    it->second.hoEnd = Simulator::Now();
+  }
+}
+
+// MacTx of an X2 device: the packet still carries its IPv4 and UDP headers
+static void X2DeviceTx(Ptr<const Packet> p)
+{
+  Ptr<Packet> packet = p->Copy();
+  Ipv4Header ipHeader;
+  packet->RemoveHeader(ipHeader);
+  UdpHeader udpHeader;
+  packet->RemoveHeader(udpHeader);
+
+  if (udpHeader.GetDestinationPort() != kX2uUdpPort)
+  {
+    // X2-C: learn the bearer TEIDs of each UE from its Handover Request
+    EpcX2Header x2Header;
+    packet->RemoveHeader(x2Header);
+    if (x2Header.GetProcedureCode() == EpcX2Header::HandoverPreparation
+        && x2Header.GetMessageType() == EpcX2Header::InitiatingMessage)
+    {
+      EpcX2HandoverRequestHeader req;
+      packet->RemoveHeader(req);
+      for (const auto& bearer : req.GetBearers())
+      {
+        g_x2uTeidToImsi[bearer.gtpTeid] = req.GetMmeUeS1apId();
+      }
+    }
+    return;
+  }
+
+  GtpuHeader gtpu;
+  packet->RemoveHeader(gtpu);
+  auto teid = g_x2uTeidToImsi.find(gtpu.GetTeid());
+  if (teid == g_x2uTeidToImsi.end())
+  {
+    return;
+  }
+  auto it = g_x2uForwarding.find(teid->second);
+  if (it == g_x2uForwarding.end())
+  {
+    return;
+  }
+  X2uForwarding& f = it->second;
+  if (f.packets == 0)
+  {
+    f.firstForward = Simulator::Now();
+  }
+  f.packets++;
+  f.bytes += packet->GetSize();
+  f.lastForward = Simulator::Now();
+}
+
+// Hook MacTx of every eNB point-to-point device whose peer is another eNB
+static void SetupX2uAccounting(NodeContainer enbNodes)
+{
+  ForEachX2Device(enbNodes, [](Ptr<PointToPointNetDevice> p2p, uint32_t, uint32_t) {
+    p2p->TraceConnectWithoutContext("MacTx", MakeCallback(&X2DeviceTx));
+  });
+}
+
+// ---------------------------------------------------------------------------
+// Traffic mix: on/off VoIP, segment-based video and web page bursts
+//
+// Each TrafficMixSource serves one UE from its remote host and only schedules
+// events at model transitions: VoIP talk-spurt/silence changes and voice
+// frames within a spurt, the start of each video segment or web page, and the
+// paced chunks a segment or page is delivered in. A chunk is sent as a
+// back-to-back run of packets from one event. Packets carry a SeqTsHeader, so
+// the UE's UdpServer still measures loss. --trafficMix gives the ratio of
+// models, e.g. "voip:2,video:1,web:1"; UE i takes entry i of the expanded pattern,
+// cycling through it.
+// ---------------------------------------------------------------------------
+enum TrafficModel
+{
+  MIX_VOIP = 0,
+  MIX_VIDEO,
+  MIX_WEB,
+  MIX_MODELS
+};
+static const char* const kTrafficModelNames[MIX_MODELS] = {"voip", "video", "web"};
+
+// VoIP: AMR 12.2 frames every 20 ms during talk spurts (ITU-T P.59 on/off means)
+static const Time kVoipFrameInterval = MilliSeconds(20);
+static const uint32_t kVoipPacketSize = 72;
+static const double kVoipMeanTalkSpurtS = 1.004;
+static const double kVoipMeanSilenceS = 1.587;
+// Video: 2 s segments at 2 Mb/s, fetched at twice the playout rate
+static const double kVideoBitrateBps = 2e6;
+static const Time kVideoSegmentDuration = Seconds(2.0);
+static const double kVideoFetchFactor = 2.0;
+// Web: 3GPP HTTP model object sizes, pages delivered at 8 Mb/s, exponential reading time
+static const double kWebMainObjectMu = 8.37;      // Lognormal, mean ~10.7 kB
+static const double kWebMainObjectSigma = 1.37;
+static const double kWebMainObjectMax = 2e6;
+static const double kWebEmbeddedMu = 6.17;        // Lognormal, mean ~7.8 kB
+static const double kWebEmbeddedSigma = 2.36;
+static const double kWebEmbeddedMax = 2e6;
+static const double kWebEmbeddedCountScale = 2.0;  // Pareto, mean ~5.6 objects
+static const double kWebEmbeddedCountShape = 1.1;
+static const double kWebEmbeddedCountMax = 53.0;
+static const double kWebRateBps = 8e6;
+static const double kWebMeanReadingS = 10.0;
+// Burst pacing
+static const Time kMixChunkInterval = MilliSeconds(10);
+static const uint32_t kMixMaxPacketSize = 1400;
+
+static uint64_t g_mixEvents[MIX_MODELS] = {0, 0, 0};
+static uint64_t g_mixPackets[MIX_MODELS] = {0, 0, 0};
+static uint64_t g_mixBytes[MIX_MODELS] = {0, 0, 0};
+static uint32_t g_mixUes[MIX_MODELS] = {0, 0, 0};
+
+class TrafficMixSource : public Application
+{
+public:
+  TrafficMixSource();
+  ~TrafficMixSource() override;
+
+  static TypeId GetTypeId();
+
+  void Setup(TrafficModel model, Ipv4Address peer, uint16_t port);
+
+protected:
+  void DoDispose() override;
+
+private:
+  void StartApplication() override;
+  void StopApplication() override;
+
+  void VoipToggle();
+  void VoipFrame();
+  void StartBurst(uint32_t bytes, double rateBps);
+  void SendChunk();
+  void BurstDone();
+  void SendPackets(uint32_t bytes, uint32_t packetSize);
+
+  TrafficModel m_model;
+  Ipv4Address m_peer;
+  uint16_t m_port;
+  Ptr<Socket> m_socket;
+  EventId m_event;
+  uint32_t m_seq;
+  bool m_voipTalking;
+  Time m_voipSpurtEnd;
+  Time m_burstStart;
+  uint32_t m_burstRemaining;
+  uint32_t m_chunkBytes;
+  Ptr<ExponentialRandomVariable> m_exponential;
+  Ptr<LogNormalRandomVariable> m_logNormal;
+  Ptr<ParetoRandomVariable> m_pareto;
+};
+
+NS_OBJECT_ENSURE_REGISTERED(TrafficMixSource);
+
+TrafficMixSource::TrafficMixSource()
+  : m_model(MIX_VOIP),
+    m_port(0),
+    m_seq(0),
+    m_voipTalking(false),
+    m_burstRemaining(0),
+    m_chunkBytes(0)
+{
+  m_exponential = CreateObject<ExponentialRandomVariable>();
+  m_logNormal = CreateObject<LogNormalRandomVariable>();
+  m_pareto = CreateObject<ParetoRandomVariable>();
+}
+
+TrafficMixSource::~TrafficMixSource()
+{
+}
+
+TypeId
+TrafficMixSource::GetTypeId()
+{
+  static TypeId tid =
+    TypeId("ns3::TrafficMixSource")
+      .SetParent<Application>()
+      .SetGroupName("Applications")
+      .AddConstructor<TrafficMixSource>();
+  return tid;
+}
+
+void
+TrafficMixSource::Setup(TrafficModel model, Ipv4Address peer, uint16_t port)
+{
+  m_model = model;
+  m_peer = peer;
+  m_port = port;
+}
+
+void
+TrafficMixSource::DoDispose()
+{
+  m_socket = nullptr;
+  Application::DoDispose();
+}
+
+void
+TrafficMixSource::StartApplication()
+{
+  if (!m_socket)
+  {
+    m_socket = Socket::CreateSocket(GetNode(), UdpSocketFactory::GetTypeId());
+    m_socket->Bind();
+  }
+  switch (m_model)
+  {
+  case MIX_VOIP:
+    // Start in silence so the UEs' talk spurts are not aligned
+    m_voipTalking = false;
+    m_event = Simulator::Schedule(Seconds(m_exponential->GetValue(kVoipMeanSilenceS, 0)),
+                                  &TrafficMixSource::VoipToggle, this);
+    break;
+  case MIX_VIDEO:
+  case MIX_WEB:
+    BurstDone();
+    break;
+  default:
+    break;
+  }
+}
+
+void
+TrafficMixSource::StopApplication()
+{
+  Simulator::Cancel(m_event);
+  if (m_socket)
+  {
+    m_socket->Close();
+  }
+}
+
+void
+TrafficMixSource::VoipToggle()
+{
+  m_voipTalking = !m_voipTalking;
+  if (m_voipTalking)
+  {
+    // The spurt's first frame goes out from this event
+    m_voipSpurtEnd = Simulator::Now() + Seconds(m_exponential->GetValue(kVoipMeanTalkSpurtS, 0));
+    VoipFrame();
+  }
+  else
+  {
+    ++g_mixEvents[MIX_VOIP];
+    m_event = Simulator::Schedule(Seconds(m_exponential->GetValue(kVoipMeanSilenceS, 0)),
+                                  &TrafficMixSource::VoipToggle, this);
+  }
+}
+
+void
+TrafficMixSource::VoipFrame()
+{
+  ++g_mixEvents[MIX_VOIP];
+  SendPackets(kVoipPacketSize, kVoipPacketSize);
+  Time next = Simulator::Now() + kVoipFrameInterval;
+  if (next < m_voipSpurtEnd)
+  {
+    m_event = Simulator::Schedule(kVoipFrameInterval, &TrafficMixSource::VoipFrame, this);
+  }
+  else
+  {
+    m_event = Simulator::Schedule(m_voipSpurtEnd - Simulator::Now(), &TrafficMixSource::VoipToggle, this);
+  }
+}
+
+// Deliver bytes in chunks of rateBps x kMixChunkInterval, one event per chunk
+void
+TrafficMixSource::StartBurst(uint32_t bytes, double rateBps)
+{
+  m_burstStart = Simulator::Now();
+  m_burstRemaining = std::max<uint32_t>(bytes, 1);
+  m_chunkBytes = std::max<uint32_t>(kMixMaxPacketSize,
+                                    static_cast<uint32_t>(rateBps / 8.0 * kMixChunkInterval.GetSeconds()));
+  SendChunk();
+}
+
+void
+TrafficMixSource::SendChunk()
+{
+  ++g_mixEvents[m_model];
+  uint32_t bytes = std::min(m_burstRemaining, m_chunkBytes);
+  SendPackets(bytes, kMixMaxPacketSize);
+  m_burstRemaining -= bytes;
+  if (m_burstRemaining > 0)
+  {
+    m_event = Simulator::Schedule(kMixChunkInterval, &TrafficMixSource::SendChunk, this);
+  }
+  else
+  {
+    BurstDone();
+  }
+}
+
+// Schedule the next segment or page once the current one has been delivered
+void
+TrafficMixSource::BurstDone()
+{
+  if (m_model == MIX_VIDEO)
+  {
+    // Fetch the next segment one segment duration after the previous one started,
+    // or straight away if the download fell behind playout
+    uint32_t segmentBytes = static_cast<uint32_t>(kVideoBitrateBps / 8.0 * kVideoSegmentDuration.GetSeconds());
+    Time wait = Seconds(0);
+    if (m_burstStart + kVideoSegmentDuration > Simulator::Now() && m_seq > 0)
+    {
+      wait = m_burstStart + kVideoSegmentDuration - Simulator::Now();
+    }
+    m_event = Simulator::Schedule(wait, &TrafficMixSource::StartBurst, this, segmentBytes,
+                                  kVideoBitrateBps * kVideoFetchFactor);
+  }
+  else if (m_model == MIX_WEB)
+  {
+    double pageBytes = std::min(m_logNormal->GetValue(kWebMainObjectMu, kWebMainObjectSigma), kWebMainObjectMax);
+    uint32_t embedded = static_cast<uint32_t>(
+      m_pareto->GetValue(kWebEmbeddedCountScale, kWebEmbeddedCountShape, kWebEmbeddedCountMax)) - 2;
+    for (uint32_t o = 0; o < embedded; ++o)
+    {
+      pageBytes += std::min(m_logNormal->GetValue(kWebEmbeddedMu, kWebEmbeddedSigma), kWebEmbeddedMax);
+    }
+    // The first page is requested right away, later ones after a reading time
+    Time wait = m_seq > 0 ? Seconds(m_exponential->GetValue(kWebMeanReadingS, 0)) : Seconds(0);
+    m_event = Simulator::Schedule(wait, &TrafficMixSource::StartBurst, this,
+                                  static_cast<uint32_t>(pageBytes), kWebRateBps);
+  }
+}
+
+void
+TrafficMixSource::SendPackets(uint32_t bytes, uint32_t packetSize)
+{
+  while (bytes > 0)
+  {
+    uint32_t size = std::max<uint32_t>(std::min(bytes, packetSize), 12);
+    SeqTsHeader seqTs;
+    seqTs.SetSeq(m_seq++);
+    Ptr<Packet> p = Create<Packet>(size - seqTs.GetSerializedSize());
+    p->AddHeader(seqTs);
+    m_socket->SendTo(p, 0, InetSocketAddress(m_peer, m_port));
+    ++g_mixPackets[m_model];
+    g_mixBytes[m_model] += size;
+    bytes -= std::min(bytes, size);
+  }
+}
+
+static const uint32_t kMaxTrafficMixWeight = 1000;
+
+// Expand "voip:2,video:1,web:1" into the per-UE model pattern
+static std::vector<TrafficModel> ParseTrafficMix(const std::string& spec)
+{
+  std::vector<TrafficModel> pattern;
+  std::stringstream ss(spec);
+  std::string item;
+  while (std::getline(ss, item, ','))
+  {
+    std::string::size_type colon = item.find(':');
+    std::string name = item.substr(0, colon);
+    uint32_t weight = 1;
+    if (colon != std::string::npos)
+    {
+      std::string text = item.substr(colon + 1);
+      if (text.empty() || text.size() > 4 || text.find_first_not_of("0123456789") != std::string::npos
+          || (weight = std::stoul(text)) == 0 || weight > kMaxTrafficMixWeight)
+      {
+        NS_FATAL_ERROR("Traffic mix weight in '" << item << "' must be 1.." << kMaxTrafficMixWeight);
+      }
+    }
+    int model = -1;
+    for (int m = 0; m < MIX_MODELS; ++m)
+    {
+      if (name == kTrafficModelNames[m])
+      {
+        model = m;
+      }
+    }
+    if (model < 0)
+    {
+      NS_FATAL_ERROR("Unknown traffic mix entry '" << item << "' (expected voip, video or web)");
+    }
+    pattern.insert(pattern.end(), weight, static_cast<TrafficModel>(model));
+  }
+  return pattern;
+}
+
+// ---------------------------------------------------------------------------
+// Mobility state estimation (MSE) and speed-dependent scaling
+//
+// As in 36.304 / 36.331, the UE's mobility state comes from its number of
+// handovers within t-Evaluation (mseWindow). Moving back to the previous cell
+// is not counted. Reaching n-CellChangeMedium or n-CellChangeHigh enters the
+// MEDIUM or HIGH state. The UE returns to NORMAL once neither threshold has
+// been met for t-HystNormal, which is taken equal to the window here.
+// A criterion holds until its oldest counted handover leaves the window, so
+// its end time is known at the last handover and every drop back is credited
+// at the time it happens, however late the next evaluation comes.
+// A MEDIUM or HIGH UE scales TimeToTrigger by sf-Medium / sf-High and, like
+// the idle-mode q-HystSF, offsets the hysteresis. ns-3 cannot scale these at
+// the UE, so MobilityStateA3HandoverAlgorithm configures one A3 report per
+// state. The serving eNB acts only on the report that matches the UE's
+// current state.
+// The estimate runs in every run, so the per-speed KPIs of plain A3 and of
+// the scaled algorithm can be compared.
+// ---------------------------------------------------------------------------
+
+enum MobilityState : uint8_t
+{
+  MOBILITY_NORMAL = 0,
+  MOBILITY_MEDIUM = 1,
+  MOBILITY_HIGH = 2,
+  MOBILITY_STATES = 3
+};
+
+static const char* const kMobilityStateNames[MOBILITY_STATES] = {"normal", "medium", "high"};
+static const uint16_t kTimeToTriggerValuesMs[] = {0, 40, 64, 80, 100, 128, 160, 256, 320, 480, 512, 640, 1024, 1280,
+                                                  2560, 5120};  // 36.331 TimeToTrigger
+
+// Speed classes of the KPI breakdown, by the UE's true speed
+enum SpeedClass : uint8_t
+{
+  SPEED_LOW = 0,     // < 10 m/s
+  SPEED_MEDIUM = 1,  // 10 - 20 m/s
+  SPEED_HIGH = 2,    // >= 20 m/s
+  SPEED_CLASSES = 3
+};
+
+static const char* const kSpeedClassNames[SPEED_CLASSES] = {"low (<10 m/s)", "medium (10-20 m/s)", "high (>=20 m/s)"};
+
+struct UeMobilityState
+{
+  std::deque<Time> cellChanges;      // Counted handovers within the evaluation window
+  uint16_t cellId = 0;
+  uint16_t previousCellId = 0;
+  MobilityState state = MOBILITY_NORMAL;
+  Time stateSince;
+  Time mediumCriterionEnd;           // Time the MEDIUM / HIGH criterion stops being met
+  Time highCriterionEnd;
+  Time timeInState[MOBILITY_STATES];
+};
+
+struct UeHandoverKpi
+{
+  double speed = 0.0;                // m/s, from the mobility model at setup
+  uint32_t failures = 0;
+  uint32_t pingPongs = 0;
+  double hoStartRsrpSum = 0.0;       // Serving RSRP at handover start, summed
+  uint32_t hoStartRsrpCount = 0;
+  Time lastHoEnd;                    // Completion of the last handover, if it completed
+  bool lastHoCompleted = false;
+  uint16_t lastHoSource = 0;
+  uint16_t lastHoTarget = 0;
+};
+
+static Time g_mseWindow = Seconds(30.0);
+static uint32_t g_mseMediumHandovers = 2;
+static uint32_t g_mseHighHandovers = 3;
+static Time g_pingPongWindow = Seconds(5.0);  // Back to the source within this after completion is a ping-pong
+static std::map<uint64_t, UeMobilityState> g_mobilityState;  // IMSI -> estimate
+static std::map<uint64_t, UeHandoverKpi> g_ueHoKpi;          // IMSI -> per-UE handover KPIs
+static std::map<uint64_t, double> g_lastServingRsrpDbm;      // IMSI -> last reported serving RSRP
+static std::map<uint32_t, uint64_t> g_rntiToImsi;            // (cellId << 16 | rnti) -> IMSI
+static uint64_t g_mseDecisions[MOBILITY_STATES] = {0, 0, 0};
+
+static void MobilityStateEnter(UeMobilityState& ms, MobilityState state, Time at)
+{
+  ms.timeInState[ms.state] += at - ms.stateSince;
+  ms.state = state;
+  ms.stateSince = at;
+}
+
+// Current state of the UE: apply the drops back that are due by now
+static MobilityState MobilityStateOf(uint64_t imsi)
+{
+  auto it = g_mobilityState.find(imsi);
+  if (it == g_mobilityState.end())
+  {
+    return MOBILITY_NORMAL;
+  }
+  UeMobilityState& ms = it->second;
+  Time now = Simulator::Now();
+  if (ms.state == MOBILITY_HIGH && now >= ms.highCriterionEnd + g_mseWindow)
+  {
+    MobilityStateEnter(ms, MOBILITY_MEDIUM, ms.highCriterionEnd + g_mseWindow);
+  }
+  if (ms.state == MOBILITY_MEDIUM && now >= ms.mediumCriterionEnd + g_mseWindow)
+  {
+    MobilityStateEnter(ms, MOBILITY_NORMAL, ms.mediumCriterionEnd + g_mseWindow);
+  }
+  return ms.state;
+}
+
+static void MobilityStateCellChange(uint64_t imsi, uint16_t cellId)
+{
+  UeMobilityState& ms = g_mobilityState[imsi];
+  MobilityStateOf(imsi);
+  Time now = Simulator::Now();
+  if (ms.cellId != 0 && cellId != ms.cellId && cellId != ms.previousCellId)
+  {
+    while (!ms.cellChanges.empty() && now - ms.cellChanges.front() > g_mseWindow)
+    {
+      ms.cellChanges.pop_front();
+    }
+    ms.cellChanges.push_back(now);
+
+    // A criterion met now lasts until the handover that completes its count leaves the window
+    size_t n = ms.cellChanges.size();
+    MobilityState state = ms.state;
+    if (n >= g_mseHighHandovers)
+    {
+      ms.highCriterionEnd = ms.cellChanges[n - g_mseHighHandovers] + g_mseWindow;
+      state = MOBILITY_HIGH;
+    }
+    if (n >= g_mseMediumHandovers)
+    {
+      ms.mediumCriterionEnd = ms.cellChanges[n - g_mseMediumHandovers] + g_mseWindow;
+      state = std::max(state, MOBILITY_MEDIUM);
+    }
+    if (state != ms.state)
+    {
+      MobilityStateEnter(ms, state, now);
+    }
+  }
+  if (cellId != ms.cellId)
+  {
+    ms.previousCellId = ms.cellId;
+    ms.cellId = cellId;
+  }
+}
+
+static SpeedClass SpeedClassOf(double speed)
+{
+  return speed < 10.0 ? SPEED_LOW : (speed < 20.0 ? SPEED_MEDIUM : SPEED_HIGH);
+}
+
+// Per-UE handover KPIs at the eNB handover start: serving RSRP and ping-pongs
+// (a handover back to the source cell within the window after completion)
+static void HandoverKpiStart(uint64_t imsi, uint16_t sourceCellId, uint16_t targetCellId)
+{
+  UeHandoverKpi& kpi = g_ueHoKpi[imsi];
+  Time now = Simulator::Now();
+  if (kpi.lastHoCompleted && kpi.lastHoTarget == sourceCellId && kpi.lastHoSource == targetCellId
+      && now - kpi.lastHoEnd <= g_pingPongWindow)
+  {
+    kpi.pingPongs++;
+  }
+  kpi.lastHoCompleted = false;
+  kpi.lastHoSource = sourceCellId;
+  kpi.lastHoTarget = targetCellId;
+
+  auto rsrp = g_lastServingRsrpDbm.find(imsi);
+  if (rsrp != g_lastServingRsrpDbm.end())
+  {
+    kpi.hoStartRsrpSum += rsrp->second;
+    kpi.hoStartRsrpCount++;
+  }
+}
+
+static void HandoverKpiEnd(uint64_t imsi)
+{
+  UeHandoverKpi& kpi = g_ueHoKpi[imsi];
+  kpi.lastHoEnd = Simulator::Now();
+  kpi.lastHoCompleted = true;
+}
+
+class MobilityStateA3HandoverAlgorithm : public LteHandoverAlgorithm
+{
+public:
+  MobilityStateA3HandoverAlgorithm();
+  ~MobilityStateA3HandoverAlgorithm() override;
+
+  static TypeId GetTypeId();
+
+  void SetCellId(uint16_t cellId);
+
+  void SetLteHandoverManagementSapUser(LteHandoverManagementSapUser* s) override;
+  LteHandoverManagementSapProvider* GetLteHandoverManagementSapProvider() override;
+
+  friend class MemberLteHandoverManagementSapProvider<MobilityStateA3HandoverAlgorithm>;
+
+protected:
+  void DoInitialize() override;
+  void DoDispose() override;
+  void DoReportUeMeas(uint16_t rnti, LteRrcSap::MeasResults measResults) override;
+
+private:
+  double m_hysteresisDb;
+  Time m_timeToTrigger;
+  double m_tttSfMedium;
+  double m_tttSfHigh;
+  double m_hysteresisSfMediumDb;
+  double m_hysteresisSfHighDb;
+  uint16_t m_cellId;
+  std::vector<uint8_t> m_measIds[MOBILITY_STATES];
+
+  LteHandoverManagementSapUser* m_handoverManagementSapUser;
+  LteHandoverManagementSapProvider* m_handoverManagementSapProvider;
+};
+
+NS_OBJECT_ENSURE_REGISTERED(MobilityStateA3HandoverAlgorithm);
+
+MobilityStateA3HandoverAlgorithm::MobilityStateA3HandoverAlgorithm()
+  : m_cellId(0),
+    m_handoverManagementSapUser(nullptr)
+{
+  m_handoverManagementSapProvider =
+    new MemberLteHandoverManagementSapProvider<MobilityStateA3HandoverAlgorithm>(this);
+}
+
+MobilityStateA3HandoverAlgorithm::~MobilityStateA3HandoverAlgorithm()
+{
+}
+
+TypeId
+MobilityStateA3HandoverAlgorithm::GetTypeId()
+{
+  static TypeId tid =
+    TypeId("ns3::MobilityStateA3HandoverAlgorithm")
+      .SetParent<LteHandoverAlgorithm>()
+      .SetGroupName("Lte")
+      .AddConstructor<MobilityStateA3HandoverAlgorithm>()
+      .AddAttribute("Hysteresis",
+                    "A3 hysteresis in the NORMAL mobility state in dB",
+                    DoubleValue(3.0),
+                    MakeDoubleAccessor(&MobilityStateA3HandoverAlgorithm::m_hysteresisDb),
+                    MakeDoubleChecker<uint8_t>(0.0, 15.0))
+      .AddAttribute("TimeToTrigger",
+                    "A3 time to trigger in the NORMAL mobility state",
+                    TimeValue(MilliSeconds(256)),
+                    MakeTimeAccessor(&MobilityStateA3HandoverAlgorithm::m_timeToTrigger),
+                    MakeTimeChecker())
+      .AddAttribute("TimeToTriggerSfMedium",
+                    "sf-Medium: TimeToTrigger scaling in the MEDIUM state",
+                    DoubleValue(0.75),
+                    MakeDoubleAccessor(&MobilityStateA3HandoverAlgorithm::m_tttSfMedium),
+                    MakeDoubleChecker<double>(0.0, 1.0))
+      .AddAttribute("TimeToTriggerSfHigh",
+                    "sf-High: TimeToTrigger scaling in the HIGH state",
+                    DoubleValue(0.5),
+                    MakeDoubleAccessor(&MobilityStateA3HandoverAlgorithm::m_tttSfHigh),
+                    MakeDoubleChecker<double>(0.0, 1.0))
+      .AddAttribute("HysteresisSfMedium",
+                    "Hysteresis offset in the MEDIUM state in dB",
+                    DoubleValue(-0.5),
+                    MakeDoubleAccessor(&MobilityStateA3HandoverAlgorithm::m_hysteresisSfMediumDb),
+                    MakeDoubleChecker<double>(-6.0, 0.0))
+      .AddAttribute("HysteresisSfHigh",
+                    "Hysteresis offset in the HIGH state in dB",
+                    DoubleValue(-1.0),
+                    MakeDoubleAccessor(&MobilityStateA3HandoverAlgorithm::m_hysteresisSfHighDb),
+                    MakeDoubleChecker<double>(-6.0, 0.0));
+  return tid;
+}
+
+void
+MobilityStateA3HandoverAlgorithm::SetCellId(uint16_t cellId)
+{
+  m_cellId = cellId;
+}
+
+void
+MobilityStateA3HandoverAlgorithm::SetLteHandoverManagementSapUser(LteHandoverManagementSapUser* s)
+{
+  m_handoverManagementSapUser = s;
+}
+
+LteHandoverManagementSapProvider*
+MobilityStateA3HandoverAlgorithm::GetLteHandoverManagementSapProvider()
+{
+  return m_handoverManagementSapProvider;
+}
+
+// One A3 report per mobility state; scaled TimeToTrigger snaps to the nearest 36.331 value
+void
+MobilityStateA3HandoverAlgorithm::DoInitialize()
+{
+  const double tttScale[MOBILITY_STATES] = {1.0, m_tttSfMedium, m_tttSfHigh};
+  const double hysteresisOffsetDb[MOBILITY_STATES] = {0.0, m_hysteresisSfMediumDb, m_hysteresisSfHighDb};
+  for (int s = 0; s < MOBILITY_STATES; ++s)
+  {
+    double tttMs = m_timeToTrigger.GetMilliSeconds() * tttScale[s];
+    uint16_t ttt = kTimeToTriggerValuesMs[0];
+    for (uint16_t value : kTimeToTriggerValuesMs)
+    {
+      if (std::abs(value - tttMs) < std::abs(ttt - tttMs))
+      {
+        ttt = value;
+      }
+    }
+
+    LteRrcSap::ReportConfigEutra reportConfig;
+    reportConfig.eventId = LteRrcSap::ReportConfigEutra::EVENT_A3;
+    reportConfig.a3Offset = 0;
+    reportConfig.hysteresis =
+      EutranMeasurementMapping::ActualHysteresis2IeValue(std::max(0.0, m_hysteresisDb + hysteresisOffsetDb[s]));
+    reportConfig.timeToTrigger = ttt;
+    reportConfig.reportOnLeave = false;
+    reportConfig.triggerQuantity = LteRrcSap::ReportConfigEutra::RSRP;
+    reportConfig.reportInterval = LteRrcSap::ReportConfigEutra::MS1024;
+    m_measIds[s] = m_handoverManagementSapUser->AddUeMeasReportConfigForHandover(reportConfig);
+  }
+
+  LteHandoverAlgorithm::DoInitialize();
+}
+
+void
+MobilityStateA3HandoverAlgorithm::DoDispose()
+{
+  delete m_handoverManagementSapProvider;
+}
+
+void
+MobilityStateA3HandoverAlgorithm::DoReportUeMeas(uint16_t rnti, LteRrcSap::MeasResults measResults)
+{
+  if (!measResults.haveMeasResultNeighCells || measResults.measResultListEutra.empty())
+  {
+    return;
+  }
+  auto imsi = g_rntiToImsi.find(uint32_t(m_cellId) << 16 | rnti);
+  MobilityState state = (imsi != g_rntiToImsi.end()) ? MobilityStateOf(imsi->second) : MOBILITY_NORMAL;
+  const std::vector<uint8_t>& measIds = m_measIds[state];
+  if (std::find(measIds.begin(), measIds.end(), measResults.measId) == measIds.end())
+  {
+    return;
+  }
+
+  uint16_t target = 0;
+  uint8_t targetRsrp = 0;
+  for (const auto& neigh : measResults.measResultListEutra)
+  {
+    if (neigh.haveRsrpResult && (target == 0 || neigh.rsrpResult > targetRsrp))
+    {
+      target = neigh.physCellId;
+      targetRsrp = neigh.rsrpResult;
+    }
+  }
+  if (target != 0)
+  {
+    g_mseDecisions[state]++;
+    HoTimingDecision(m_cellId, rnti, false);
+    m_handoverManagementSapUser->TriggerHandover(rnti, target);
+  }
+}
+
+// At the end of the run, while the simulator clock still reads the end time:
+// apply the due drops back and credit every UE's current state up to now
+static void CloseMobilityStates()
+{
+  for (auto& entry : g_mobilityState)
+  {
+    MobilityStateEnter(entry.second, MobilityStateOf(entry.first), Simulator::Now());
+  }
+}
+
+// Handovers, failures, ping-pongs and serving RSRP at handover start per
+// speed class, with the time the estimator spent in each mobility state
+// (closed by CloseMobilityStates before the simulator is destroyed)
+static void PrintMobilityStateKpis()
+{
+  struct ClassKpi
+  {
+    uint32_t ues = 0;
+    uint64_t handovers = 0;
+    uint64_t failures = 0;
+    uint64_t pingPongs = 0;
+    double rsrpSum = 0.0;
+    uint64_t rsrpCount = 0;
+    Time timeInState[MOBILITY_STATES];
+  };
+  ClassKpi classes[SPEED_CLASSES];
+  for (auto& entry : g_ueHoKpi)
+  {
+    ClassKpi& c = classes[SpeedClassOf(entry.second.speed)];
+    c.ues++;
+    c.handovers += g_ueHandoverCount[entry.first];
+    c.failures += entry.second.failures;
+    c.pingPongs += entry.second.pingPongs;
+    c.rsrpSum += entry.second.hoStartRsrpSum;
+    c.rsrpCount += entry.second.hoStartRsrpCount;
+    auto ms = g_mobilityState.find(entry.first);
+    if (ms != g_mobilityState.end())
+    {
+      for (int s = 0; s < MOBILITY_STATES; ++s)
+      {
+        c.timeInState[s] += ms->second.timeInState[s];
+      }
+    }
+  }
+
+  std::cout << "\nMobility State KPIs (window " << g_mseWindow.GetSeconds() << " s, medium >= " << g_mseMediumHandovers
+            << ", high >= " << g_mseHighHandovers << " handovers):\n";
+  for (int k = 0; k < SPEED_CLASSES; ++k)
+  {
+    const ClassKpi& c = classes[k];
+    if (c.ues == 0)
+    {
+      continue;
+    }
+    Time total = c.timeInState[MOBILITY_NORMAL] + c.timeInState[MOBILITY_MEDIUM] + c.timeInState[MOBILITY_HIGH];
+    std::cout << kSpeedClassNames[k] << ": " << c.ues << " UEs, " << c.handovers << " handovers, " << c.failures
+              << " failures, " << c.pingPongs << " ping-pongs, serving RSRP at handover start "
+              << std::fixed << std::setprecision(1) << (c.rsrpCount > 0 ? c.rsrpSum / c.rsrpCount : 0.0) << " dBm\n";
+    std::cout << "  estimated state:";
+    for (int s = 0; s < MOBILITY_STATES; ++s)
+    {
+      std::cout << " " << kMobilityStateNames[s] << " "
+                << (total.IsPositive() ? c.timeInState[s].GetSeconds() / total.GetSeconds() * 100.0 : 0.0) << "%";
+    }
+    std::cout << "\n";
+  }
+  if (g_mseDecisions[MOBILITY_NORMAL] + g_mseDecisions[MOBILITY_MEDIUM] + g_mseDecisions[MOBILITY_HIGH] > 0)
+  {
+    std::cout << "Scaled A3 decisions: " << g_mseDecisions[MOBILITY_NORMAL] << " normal, "
+              << g_mseDecisions[MOBILITY_MEDIUM] << " medium, " << g_mseDecisions[MOBILITY_HIGH] << " high\n";
+  }
+}
+
+// ---------------------------------------------------------------------------
+// Handover interruption and failures
+// ---------------------------------------------------------------------------
+
+static std::map<uint64_t, Time> g_ueHoStartTime;  // IMSI -> UE HandoverStart (command received)
+static Time g_hoInterruptionTotal = Seconds(0);
+static uint64_t g_hoInterruptionCount = 0;
+static uint64_t g_hoFailures = 0;
+
+// Handover failures (preamble, RACH, leaving and joining timeouts)
+static void EnbHoFailure(std::string context, uint64_t imsi, uint16_t rnti, uint16_t cellId)
+{
+  g_hoFailures++;
+  g_ueHoKpi[imsi].failures++;
+}
+
 // Callback functions for comprehensive data collection
 static void
 MeasReportSink(std::string context, uint64_t imsi, uint16_t cellId, uint16_t rnti, LteRrcSap::MeasurementReport report)
@@ -47,10 +965,26 @@ MeasReportSink(std::string context, uint64_t imsi, uint16_t cellId, uint16_t rnt
   // Convert quantized values to actual dBm/dB values for analysis
   double rsrpDbm = -140.0 + srp;  // RSRP in dBm
   double rsrqDb = -19.5 + 0.5 * srq;  // RSRQ in dB
+  g_lastServingRsrpDbm[imsi] = rsrpDbm;
+  HoTimingReport(cellId, rnti, mr);
   
   bool hasNeigh = mr.haveMeasResultNeighCells;
   std::string event = hasNeigh ? "A3" : "PERIODIC";
   
+  // Quantized report for the golden digest
+  std::string digestLine = "MR," + std::to_string(Simulator::Now().GetNanoSeconds()) + "," + std::to_string(imsi) + ","
+                           + std::to_string(cellId) + "," + std::to_string(rnti) + "," + std::to_string(measId) + ","
+                           + std::to_string(srp) + "," + std::to_string(srq) + ",";
+  if (hasNeigh)
+  {
+    for (const auto& neigh : mr.measResultListEutra)
+    {
+      digestLine += std::to_string(neigh.physCellId) + ":" + std::to_string(neigh.haveRsrpResult ? neigh.rsrpResult : -1)
+                    + ":" + std::to_string(neigh.haveRsrqResult ? neigh.rsrqResult : -1) + ";";
+    }
+  }
+  DigestEvent(digestLine);
+  
   g_measCsv << std::fixed << std::setprecision(6) << Simulator::Now().GetSeconds() << ","
             << imsi << ","
             << cellId << ","
@@ -91,8 +1025,9 @@ MeasReportSink(std::string context, uint64_t imsi, uint16_t cellId, uint16_t rnt
 
 static void EnbConnEstablished(std::string context, uint64_t imsi, uint16_t cellId, uint16_t rnti)
 {
-  g_enbRrcCsv << "CONN_EST," << std::fixed << std::setprecision(6) << Simulator::Now().GetSeconds() << ","
-              << imsi << "," << cellId << "," << rnti << std::endl;
+  RecordRrcEvent(RRC_CONN_EST, kRrcSideEnb, imsi, cellId, rnti);
+  g_rntiToImsi[uint32_t(cellId) << 16 | rnti] = imsi;
+  MobilityStateCellChange(imsi, cellId);
 }
 
 static void EnbHoStart(std::string context, uint64_t imsi, uint16_t cellId, uint16_t rnti, uint16_t targetCid)
@@ -100,40 +1035,49 @@ static void EnbHoStart(std::string context, uint64_t imsi, uint16_t cellId, uint
   g_totalHandovers++;
   g_ueHandoverCount[imsi]++;
   
-  g_enbRrcCsv << "HO_START," << std::fixed << std::setprecision(6) << Simulator::Now().GetSeconds() << ","
-              << imsi << "," << cellId << "," << rnti << ",to:" << targetCid << std::endl;
-  
-  g_handoverStatsFile << "HO_START," << std::fixed << std::setprecision(6) << Simulator::Now().GetSeconds() << ","
-                      << imsi << "," << cellId << "," << targetCid << std::endl;
+  RecordRrcEvent(RRC_HO_START, kRrcSideEnb, imsi, cellId, rnti, targetCid);
+  X2uHandoverStart(imsi, cellId, targetCid);
+  HoTimingPrepared(imsi, cellId, rnti);
+  HandoverKpiStart(imsi, cellId, targetCid);
 }
 
 static void EnbHoEndOk(std::string context, uint64_t imsi, uint16_t cellId, uint16_t rnti)
 {
   g_successfulHandovers++;
   
-  g_enbRrcCsv << "HO_END_OK," << std::fixed << std::setprecision(6) << Simulator::Now().GetSeconds() << ","
-              << imsi << "," << cellId << "," << rnti << std::endl;
-  
-  g_handoverStatsFile << "HO_END_OK," << std::fixed << std::setprecision(6) << Simulator::Now().GetSeconds() << ","
-                      << imsi << "," << cellId << std::endl;
+  RecordRrcEvent(RRC_HO_END_OK, kRrcSideEnb, imsi, cellId, rnti);
+  X2uHandoverEnd(imsi);
+  g_rntiToImsi[uint32_t(cellId) << 16 | rnti] = imsi;
+  MobilityStateCellChange(imsi, cellId);
+  HandoverKpiEnd(imsi);
 }
 
 static void UeConnEstablished(std::string context, uint64_t imsi, uint16_t cellId, uint16_t rnti)
 {
-  g_ueRrcCsv << "UE_CONN_EST," << std::fixed << std::setprecision(6) << Simulator::Now().GetSeconds() << ","
-             << imsi << "," << cellId << "," << rnti << std::endl;
+  RecordRrcEvent(RRC_CONN_EST, kRrcSideUe, imsi, cellId, rnti);
 }
 
 static void UeHoStart(std::string context, uint64_t imsi, uint16_t cellId, uint16_t rnti, uint16_t targetCid)
 {
-  g_ueRrcCsv << "UE_HO_START," << std::fixed << std::setprecision(6) << Simulator::Now().GetSeconds() << ","
-             << imsi << "," << cellId << "," << rnti << ",to:" << targetCid << std::endl;
+  RecordRrcEvent(RRC_HO_START, kRrcSideUe, imsi, cellId, rnti, targetCid);
+  g_ueHoStartTime[imsi] = Simulator::Now();
+  HoTimingCommand(imsi);
 }
 
 static void UeHoEndOk(std::string context, uint64_t imsi, uint16_t cellId, uint16_t rnti)
 {
-  g_ueRrcCsv << "UE_HO_END_OK," << std::fixed << std::setprecision(6) << Simulator::Now().GetSeconds() << ","
-             << imsi << "," << cellId << "," << rnti << std::endl;
+  RecordRrcEvent(RRC_HO_END_OK, kRrcSideUe, imsi, cellId, rnti);
+  
+  // Interruption as seen by the UE, from the handover command to completion
+  auto it = g_ueHoStartTime.find(imsi);
+  if (it != g_ueHoStartTime.end())
+  {
+    Time interruption = Simulator::Now() - it->second;
+    g_hoInterruptionTotal += interruption;
+    g_hoInterruptionCount++;
+    HoTimingComplete(imsi, interruption);
+    g_ueHoStartTime.erase(it);
+  }
 }
 
 // Mobility tracing function
@@ -191,6 +1135,8 @@ void PrintFinalStatistics()
   std::cout << "Total Handovers Attempted: " << g_totalHandovers << std::endl;
   std::cout << "Successful Handovers: " << g_successfulHandovers << std::endl;
   std::cout << "Failed Handovers: " << g_failedHandovers << std::endl;
+  std::cout << "RRC Event Records: " << g_rrcEventsWritten << " (" << g_rrcEventsMerged
+            << " mirrored reports merged)" << std::endl;
   
   if (g_totalHandovers > 0)
   {
@@ -198,50 +1144,152 @@ void PrintFinalStatistics()
     std::cout << "Handover Success Rate: " << std::fixed << std::setprecision(2) << successRate << "%" << std::endl;
   }
   
+  std::cout << "\nX2-U Data Forwarding:\n";
+  std::cout << "Handovers with forwarding: " << g_x2uHandoversWithForwarding << " of " << g_x2uHandovers << std::endl;
+  std::cout << "Forwarded bytes: " << g_x2uTotalBytes << " total, " << g_x2uMaxBytes << " max per handover" << std::endl;
+  std::cout << "Longest forwarding: " << std::setprecision(1) << g_x2uMaxDurationMs << " ms" << std::endl;
+  
+  std::cout << "\nHandover Timing:\n";
+  std::cout << "Mean measured interruption: " << std::fixed << std::setprecision(1)
+            << (g_hoInterruptionCount > 0 ? g_hoInterruptionTotal.GetSeconds() / g_hoInterruptionCount * 1000.0 : 0.0)
+            << " ms over " << g_hoInterruptionCount << " handovers\n";
+  std::cout << "Handover failures: " << g_hoFailures << "\n";
+  PrintChoStatistics(g_totalHandovers);
+  PrintMobilityStateKpis();
+  
   std::cout << "\nPer-UE Handover Count:\n";
   for (auto& pair : g_ueHandoverCount)
   {
     std::cout << "UE IMSI " << pair.first << ": " << pair.second << " handovers" << std::endl;
   }
   
+  if (g_mixUes[MIX_VOIP] + g_mixUes[MIX_VIDEO] + g_mixUes[MIX_WEB] > 0)
+  {
+    std::cout << "\nTraffic Mix (downlink):\n";
+    for (int m = 0; m < MIX_MODELS; ++m)
+    {
+      std::cout << kTrafficModelNames[m] << ": " << g_mixUes[m] << " UEs, " << g_mixPackets[m] << " packets, "
+                << g_mixBytes[m] << " bytes in " << g_mixEvents[m] << " events" << std::endl;
+    }
+  }
+  
+  if (g_trafficBatches > 0)
+  {
+    std::cout << "\nBatched Traffic Sources:\n";
+    std::cout << "Packets sent: " << g_trafficPackets << " in " << g_trafficBatches << " send events (" << std::fixed
+              << std::setprecision(1) << (double)g_trafficPackets / g_trafficBatches << " per event)" << std::endl;
+  }
+  
   std::cout << "\nGenerated Files:\n";
   std::cout << "- handover_meas_reports.csv (measurement reports)\n";
-  std::cout << "- handover_enb_rrc_events.csv (eNB RRC events)\n";
-  std::cout << "- handover_ue_rrc_events.csv (UE RRC events)\n";
+  std::cout << "- handover_rrc_events.csv (unified eNB/UE RRC event stream; legacy views via rrc_stream_convert.py)\n";
   std::cout << "- ue_mobility_trace.csv (UE positions and velocities)\n";
   std::cout << "- throughput_analysis.csv (throughput and QoS metrics)\n";
-  std::cout << "- handover_statistics.csv (handover timing analysis)\n";
   std::cout << "- rsrp_measurements.csv (detailed RSRP/RSRQ data)\n";
+  std::cout << "- handover_x2u_forwarding.csv (X2-U forwarded bytes/packets and duration per handover)\n";
+  std::cout << "- handover_digest_trace.txt (canonical golden-digest events, with --digestTrace)\n";
+  std::cout << "- handover_object_census.csv (objects per TypeId, appended per run, with --enableCensus)\n";
+  std::cout << "- handover_log.bin (binary NS_LOG records, with --enableLogs --logFormat=binary; decode with binary_log_decode.py)\n";
   std::cout << "- PCAP files (*.pcap for packet capture analysis)\n";
   std::cout << "===================================================\n";
 }
 
 int main(int argc, char* argv[])
 {
+  auto wallStart = std::chrono::steady_clock::now();
   // Enhanced simulation parameters
   Time simTime = Seconds(60.0);  // 1 minute simulation
   uint32_t numUes = 4;           // Multiple UEs for better analysis
   uint32_t numEnbs = 5;          // 5 eNBs for more handover opportunities
   bool enableLogs = false;
+  std::string logFormat = "text"; // NS_LOG backend: text (stderr) or binary
   bool enablePcap = true;
   double ueSpeed = 15.0;         // 15 m/s (54 km/h) realistic vehicle speed
+  std::string hoAlgorithm = "a3"; // Handover algorithm: a3, cho (conditional handover) or mse (speed-scaled A3)
+  double choPrepareOffset = 3.0;  // CHO: prepare a neighbour this many dB before the execution condition
+  uint32_t choMaxCandidates = 3;  // CHO: prepared targets per UE
+  double mseTttSfMedium = 0.75;   // MSE: TimeToTrigger scaling in the MEDIUM / HIGH state
+  double mseTttSfHigh = 0.5;
+  double mseHystSfMedium = -0.5;  // MSE: hysteresis offset (dB) in the MEDIUM / HIGH state
+  double mseHystSfHigh = -1.0;
+  uint32_t numRemoteHosts = 1;   // Remote hosts sourcing UE traffic, sharded by IMSI
+  uint32_t uesPerRemoteHost = 0; // If > 0, overrides numRemoteHosts to bound UEs per host
+  Time trafficBatch = Seconds(0); // UDP aggregation boundary, 0 = one UdpClient per flow
+  std::string trafficMix = "";    // Downlink model ratio, e.g. voip:2,video:1,web:1; empty = UDP/TCP
+  std::string goldenMode = "";    // Golden digest: record, verify or empty
+  std::string goldenFile = "golden_digests.txt";
+  bool digestTrace = false;       // Write the canonical digest events
+  bool enableCensus = false;      // Object census by TypeId after setup and at the end
+  double maxWallSeconds = 0;      // Run budgets, 0 = unlimited
+  double maxRssMb = 0;
+  uint64_t maxTraceBytes = 0;
   
   CommandLine cmd;
   cmd.AddValue("simTime", "Simulation time (s)", simTime);
   cmd.AddValue("numUes", "Number of UEs", numUes);
   cmd.AddValue("numEnbs", "Number of eNBs", numEnbs);
   cmd.AddValue("enableLogs", "Turn on LTE logging", enableLogs);
+  cmd.AddValue("logFormat", "Log backend with enableLogs: text (stderr) or binary (handover_log.bin)", logFormat);
   cmd.AddValue("enablePcap", "Enable PCAP tracing", enablePcap);
   cmd.AddValue("ueSpeed", "UE speed in m/s", ueSpeed);
+  cmd.AddValue("hoAlgorithm", "Handover algorithm: a3, cho or mse", hoAlgorithm);
+  cmd.AddValue("choPrepareOffset", "CHO: prepare a neighbour this many dB before the execution condition (dB)", choPrepareOffset);
+  cmd.AddValue("choMaxCandidates", "CHO: maximum prepared targets per UE", choMaxCandidates);
+  cmd.AddValue("mseWindow", "Mobility state estimation: handover counting window (t-Evaluation)", g_mseWindow);
+  cmd.AddValue("mseMediumHandovers", "Mobility state estimation: handovers in the window for MEDIUM", g_mseMediumHandovers);
+  cmd.AddValue("mseHighHandovers", "Mobility state estimation: handovers in the window for HIGH", g_mseHighHandovers);
+  cmd.AddValue("pingPongWindow", "A handover back to the source within this time after completion is a ping-pong", g_pingPongWindow);
+  cmd.AddValue("mseTttSfMedium", "MSE: TimeToTrigger scaling in the MEDIUM state (sf-Medium)", mseTttSfMedium);
+  cmd.AddValue("mseTttSfHigh", "MSE: TimeToTrigger scaling in the HIGH state (sf-High)", mseTttSfHigh);
+  cmd.AddValue("mseHystSfMedium", "MSE: hysteresis offset in the MEDIUM state (dB)", mseHystSfMedium);
+  cmd.AddValue("mseHystSfHigh", "MSE: hysteresis offset in the HIGH state (dB)", mseHystSfHigh);
+  cmd.AddValue("numRemoteHosts", "Number of remote hosts behind the PGW (UEs sharded by IMSI)", numRemoteHosts);
+  cmd.AddValue("uesPerRemoteHost", "UEs per remote host; if > 0, sets numRemoteHosts from numUes", uesPerRemoteHost);
+  cmd.AddValue("trafficMix", "Downlink traffic model ratio, e.g. voip:2,video:1,web:1 (empty = constant UDP / bulk TCP)", trafficMix);
+  cmd.AddValue("trafficBatch", "Send UDP traffic in bursts per UE group at this boundary (e.g. 1ms), 0 = per packet", trafficBatch);
+  cmd.AddValue("goldenMode", "Golden digest mode: record or verify (empty = only print the digest)", goldenMode);
+  cmd.AddValue("goldenFile", "File of golden digests per scenario and seed", goldenFile);
+  cmd.AddValue("digestTrace", "Write the canonical digest events for trace_diff.py", digestTrace);
+  cmd.AddValue("enableCensus", "Count simulation objects per TypeId after setup and at the end of the run", enableCensus);
+  cmd.AddValue("maxWallSeconds", "Stop the run cleanly after this much wall-clock time (0 = unlimited)", maxWallSeconds);
+  cmd.AddValue("maxRssMb", "Stop the run cleanly once peak RSS exceeds this (MB, 0 = unlimited)", maxRssMb);
+  cmd.AddValue("maxTraceBytes", "Stop the run cleanly once the trace files exceed this size (0 = unlimited)", maxTraceBytes);
   cmd.Parse(argc, argv);
 
+  if (g_mseMediumHandovers == 0 || g_mseHighHandovers < g_mseMediumHandovers)
+  {
+    NS_FATAL_ERROR("Need 0 < mseMediumHandovers <= mseHighHandovers");
+  }
+
+  if (digestTrace)
+  {
+    g_digestTraceFile.open("handover_digest_trace.txt");
+  }
+
+  if (uesPerRemoteHost > 0)
+  {
+    numRemoteHosts = (numUes + uesPerRemoteHost - 1) / uesPerRemoteHost;
+  }
+
   // Enable logging if requested
   if (enableLogs)
   {
-    LogComponentEnable("LteHelper", LOG_LEVEL_INFO);
-    LogComponentEnable("LteEnbRrc", LOG_LEVEL_INFO);
-    LogComponentEnable("LteUeRrc", LOG_LEVEL_INFO);
-    LogComponentEnable("A3RsrpHandoverAlgorithm", LOG_LEVEL_INFO);
+    LogLevel logLevel = LOG_LEVEL_INFO;
+    if (logFormat == "binary")
+    {
+      // Component and level prefixes let the backend split each line; no time prefix
+      g_binaryLog = new BinaryLogBuf("handover_log.bin");
+      g_textLog = std::clog.rdbuf(g_binaryLog);
+      logLevel = static_cast<LogLevel>(LOG_LEVEL_INFO | LOG_PREFIX_FUNC | LOG_PREFIX_LEVEL);
+    }
+    else if (logFormat != "text")
+    {
+      NS_FATAL_ERROR("Unknown logFormat '" << logFormat << "' (expected text or binary)");
+    }
+    LogComponentEnable("LteHelper", logLevel);
+    LogComponentEnable("LteEnbRrc", logLevel);
+    LogComponentEnable("LteUeRrc", logLevel);
+    LogComponentEnable("A3RsrpHandoverAlgorithm", logLevel);
   }
 
   // Configure global random variables
@@ -257,28 +1305,18 @@ int main(int argc, char* argv[])
   lteHelper->SetEnbAntennaModelType("ns3::IsotropicAntennaModel");
   lteHelper->SetUeAntennaModelType("ns3::IsotropicAntennaModel");
 
-  // Create remote host for traffic generation
+  // Create remote hosts for traffic generation, each on its own
+  // point-to-point link to the PGW
   Ptr<Node> pgw = epcHelper->GetPgwNode();
-  NodeContainer remoteHostContainer;
-  remoteHostContainer.Create(1);
-  Ptr<Node> remoteHost = remoteHostContainer.Get(0);
   InternetStackHelper internet;
-  internet.Install(remoteHostContainer);
-
-  // Create point-to-point link between PGW and remote host
   PointToPointHelper p2ph;
   p2ph.SetDeviceAttribute("DataRate", DataRateValue(DataRate("100Gbps")));
   p2ph.SetChannelAttribute("Delay", TimeValue(MilliSeconds(1)));
-  NetDeviceContainer internetDevices = p2ph.Install(pgw, remoteHost);
-  
-  Ipv4AddressHelper ipv4h;
-  ipv4h.SetBase("1.0.0.0", "255.0.0.0");
-  Ipv4InterfaceContainer internetIpIfaces = ipv4h.Assign(internetDevices);
+  SetupRemoteHosts(pgw, numRemoteHosts, internet, p2ph);
+  std::cout << "Remote hosts: " << g_remoteHosts.GetN() << " (up to "
+            << (numUes + g_remoteHosts.GetN() - 1) / g_remoteHosts.GetN() << " UEs each)" << std::endl;
   
-  // Set up routing
   Ipv4StaticRoutingHelper ipv4RoutingHelper;
-  Ptr<Ipv4StaticRouting> remoteHostStaticRouting = ipv4RoutingHelper.GetStaticRouting(remoteHost->GetObject<Ipv4>());
-  remoteHostStaticRouting->AddNetworkRouteTo(Ipv4Address("7.0.0.0"), Ipv4Mask("255.0.0.0"), 1);
 
   // Create nodes
   NodeContainer enbNodes;
@@ -336,7 +1374,40 @@ int main(int argc, char* argv[])
       double angle = (double)(rand() % 360) * M_PI / 180.0;
       cvMobility->SetVelocity(Vector(speed * cos(angle), speed * sin(angle), 0.0));
     }
+    
+    // True speed for the per-speed-class KPIs
+    Vector velocity = ueNodes.Get(i)->GetObject<MobilityModel>()->GetVelocity();
+    g_ueHoKpi[i + 1].speed = std::sqrt(velocity.x * velocity.x + velocity.y * velocity.y);
+  }
+
+  // Configure handover algorithm with optimized parameters (applied at device installation).
+  // CHO executes on the same A3 condition, so both runs see the same trigger points.
+  if (hoAlgorithm == "cho")
+  {
+    g_choHo = true;
+    lteHelper->SetHandoverAlgorithmType("ns3::ChoHandoverAlgorithm");
+    lteHelper->SetHandoverAlgorithmAttribute("PrepareOffset", DoubleValue(choPrepareOffset));
+    lteHelper->SetHandoverAlgorithmAttribute("MaxCandidates", UintegerValue(choMaxCandidates));
+  }
+  else if (hoAlgorithm == "mse")
+  {
+    lteHelper->SetHandoverAlgorithmType("ns3::MobilityStateA3HandoverAlgorithm");
+    lteHelper->SetHandoverAlgorithmAttribute("TimeToTriggerSfMedium", DoubleValue(mseTttSfMedium));
+    lteHelper->SetHandoverAlgorithmAttribute("TimeToTriggerSfHigh", DoubleValue(mseTttSfHigh));
+    lteHelper->SetHandoverAlgorithmAttribute("HysteresisSfMedium", DoubleValue(mseHystSfMedium));
+    lteHelper->SetHandoverAlgorithmAttribute("HysteresisSfHigh", DoubleValue(mseHystSfHigh));
+  }
+  else if (hoAlgorithm == "a3")
+  {
+    g_hoTimingFromReports = true;
+    lteHelper->SetHandoverAlgorithmType("ns3::A3RsrpHandoverAlgorithm");
+  }
+  else
+  {
+    NS_FATAL_ERROR("Unknown hoAlgorithm '" << hoAlgorithm << "' (expected a3, cho or mse)");
   }
+  lteHelper->SetHandoverAlgorithmAttribute("Hysteresis", DoubleValue(1.5));  // dB
+  lteHelper->SetHandoverAlgorithmAttribute("TimeToTrigger", TimeValue(MilliSeconds(100)));
 
   // Install LTE devices
   NetDeviceContainer enbLteDevs = lteHelper->InstallEnbDevice(enbNodes);
@@ -359,13 +1430,27 @@ int main(int argc, char* argv[])
     for (uint32_t j = i + 1; j < numEnbs; ++j)
     {
       lteHelper->AddX2Interface(enbNodes.Get(i), enbNodes.Get(j));
+      g_x2Links.insert(std::make_pair(uint16_t(i + 1), uint16_t(j + 1)));
     }
   }
 
-  // Configure handover algorithm with optimized parameters
-  lteHelper->SetHandoverAlgorithmType("ns3::A3RsrpHandoverAlgorithm");
-  lteHelper->SetHandoverAlgorithmAttribute("Hysteresis", DoubleValue(1.5));  // dB
-  lteHelper->SetHandoverAlgorithmAttribute("TimeToTrigger", TimeValue(MilliSeconds(100)));
+  // The CHO and MSE algorithms do not know their own cell; hand it over after installation
+  for (uint32_t i = 0; i < numEnbs; ++i)
+  {
+    PointerValue algorithm;
+    enbLteDevs.Get(i)->GetAttribute("LteHandoverAlgorithm", algorithm);
+    Ptr<ChoHandoverAlgorithm> cho = algorithm.Get<ChoHandoverAlgorithm>();
+    if (cho)
+    {
+      cho->SetCellId(i + 1);
+    }
+    Ptr<MobilityStateA3HandoverAlgorithm> mse = algorithm.Get<MobilityStateA3HandoverAlgorithm>();
+    if (mse)
+    {
+      mse->SetCellId(i + 1);
+    }
+  }
+  SetupX2uAccounting(enbNodes);
 
   // Attach UEs to the first eNB initially
   for (uint32_t i = 0; i < numUes; ++i)
@@ -376,9 +1461,31 @@ int main(int argc, char* argv[])
   // Set up traffic applications
   ApplicationContainer serverApps, clientApps;
   
-  // Downlink traffic: UDP and TCP mixed
+  std::vector<TrafficModel> mixPattern = ParseTrafficMix(trafficMix);
+
+  // With trafficBatch, one batched source per remote host carries the UDP
+  // downlink flows of all UEs in its shard; created with its first flow
+  std::vector<Ptr<BatchedUdpSource>> dlBatchSources(g_remoteHosts.GetN());
+
+  // Downlink traffic: UDP and TCP mixed, each UE served by its IMSI shard
   for (uint32_t i = 0; i < numUes; ++i)
   {
+    Ptr<Node> remoteHost = g_remoteHosts.Get(RemoteHostShard(i + 1));
+    if (!mixPattern.empty())
+    {
+      // Traffic mix model from the declared ratio instead
+      uint16_t dlPort = 1234 + i;
+      UdpServerHelper dlPacketSinkHelper(dlPort);
+      serverApps.Add(dlPacketSinkHelper.Install(ueNodes.Get(i)));
+
+      TrafficModel model = mixPattern[i % mixPattern.size()];
+      Ptr<TrafficMixSource> source = CreateObject<TrafficMixSource>();
+      source->Setup(model, ueIpIfaces.GetAddress(i), dlPort);
+      remoteHost->AddApplication(source);
+      clientApps.Add(source);
+      ++g_mixUes[model];
+      continue;
+    }
     if (i % 2 == 0)
     {
       // UDP traffic for even UEs
@@ -386,6 +1493,19 @@ int main(int argc, char* argv[])
       UdpServerHelper dlPacketSinkHelper(dlPort);
       serverApps.Add(dlPacketSinkHelper.Install(ueNodes.Get(i)));
       
+      if (trafficBatch > Seconds(0))
+      {
+        Ptr<BatchedUdpSource>& source = dlBatchSources[RemoteHostShard(i + 1)];
+        if (!source)
+        {
+          source = CreateObject<BatchedUdpSource>();
+          source->SetAttribute("BatchInterval", TimeValue(trafficBatch));
+          remoteHost->AddApplication(source);
+          clientApps.Add(source);
+        }
+        source->AddFlow(ueIpIfaces.GetAddress(i), dlPort, MilliSeconds(10), 1024, 100000);
+        continue;
+      }
       UdpClientHelper dlClient(ueIpIfaces.GetAddress(i), dlPort);
       dlClient.SetAttribute("Interval", TimeValue(MilliSeconds(10)));  // High frequency
       dlClient.SetAttribute("MaxPackets", UintegerValue(100000));
@@ -410,10 +1530,20 @@ int main(int argc, char* argv[])
   for (uint32_t i = 0; i < numUes/2; ++i)
   {
     uint16_t ulPort = 2000 + i;
+    uint32_t shard = RemoteHostShard(i + 1);
     UdpServerHelper ulPacketSinkHelper(ulPort);
-    serverApps.Add(ulPacketSinkHelper.Install(remoteHost));
+    serverApps.Add(ulPacketSinkHelper.Install(g_remoteHosts.Get(shard)));
     
-    UdpClientHelper ulClient(internetIpIfaces.GetAddress(1), ulPort);
+    if (trafficBatch > Seconds(0))
+    {
+      Ptr<BatchedUdpSource> source = CreateObject<BatchedUdpSource>();
+      source->SetAttribute("BatchInterval", TimeValue(trafficBatch));
+      source->AddFlow(g_remoteHostAddresses[shard], ulPort, MilliSeconds(50), 512, 50000);
+      ueNodes.Get(i)->AddApplication(source);
+      clientApps.Add(source);
+      continue;
+    }
+    UdpClientHelper ulClient(g_remoteHostAddresses[shard], ulPort);
     ulClient.SetAttribute("Interval", TimeValue(MilliSeconds(50)));
     ulClient.SetAttribute("MaxPackets", UintegerValue(50000));
     ulClient.SetAttribute("PacketSize", UintegerValue(512));
@@ -457,17 +1587,23 @@ int main(int argc, char* argv[])
   Config::Connect("/NodeList/*/DeviceList/*/LteUeRrc/HandoverEndOk",
                   MakeCallback(&UeHoEndOk));
 
+  // Handover failure traces exist from ns-3.37 on
+  for (const char* failure : {"HandoverFailureNoPreamble", "HandoverFailureMaxRach", "HandoverFailureLeaving",
+                              "HandoverFailureJoining"})
+  {
+    Config::ConnectFailSafe(std::string("/NodeList/*/DeviceList/*/LteEnbRrc/") + failure, MakeCallback(&EnbHoFailure));
+  }
+
   // Connect mobility tracing
   Config::Connect("/NodeList/*/$ns3::MobilityModel/CourseChange",
                   MakeCallback(&CourseChange));
 
   // Initialize CSV file headers
   g_measCsv << "time,imsi,enbCellId,rnti,measId,event,servingRsrpQ,servingRsrqQ,servingRsrpDbm,servingRsrqDb,neighborCells\n";
-  g_enbRrcCsv << "event,time,imsi,cellId,rnti,info\n";
-  g_ueRrcCsv << "event,time,imsi,cellId,rnti,info\n";
+  OpenRrcEventStream("handover_rrc_events.csv");
+  g_x2uForwardingFile << "imsi,sourceCellId,targetCellId,hoStart,hoEnd,packets,bytes,firstForward,lastForward,durationMs,drainAfterHoEndMs\n";
   g_mobilityTraceFile << "time,nodeId,posX,posY,posZ,velX,velY,velZ\n";
   g_throughputFile << "time,flowId,throughputMbps,delayMs,jitterMs,packetLossPercent,rxPackets,txPackets\n";
-  g_handoverStatsFile << "event,time,imsi,sourceCellId,targetCellId\n";
   g_rsrpFile << "time,imsi,cellId,rsrpDbm,rsrqDb\n";
 
   std::cout << "Starting handover mobility analysis simulation...\n";
@@ -478,27 +1614,84 @@ int main(int argc, char* argv[])
   std::cout << "- UE Speed: " << ueSpeed << " m/s\n";
   std::cout << "- PCAP Tracing: " << (enablePcap ? "Enabled" : "Disabled") << "\n";
 
+  if (enableCensus)
+  {
+    WriteObjectCensus("handover_object_census.csv", "setup", numUes, numEnbs);
+  }
+
   // Run simulation
   Simulator::Stop(simTime);
+  StartRunBudget(wallStart, maxWallSeconds, maxRssMb, maxTraceBytes,
+                 {"handover_", "handover-analysis", "ue_mobility_trace", "throughput_analysis", "rsrp_measurements",
+                  "DlPdcpStats", "UlPdcpStats", "DlRlcStats", "UlRlcStats"});
+  double setupSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - wallStart).count();
   Simulator::Run();
+  StopRunBudget();
+  double runSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - wallStart).count() - setupSeconds;
+  uint64_t events = Simulator::GetEventCount();
+  double simSeconds = g_budgetExceeded.empty() ? simTime.GetSeconds() : g_budgetStopTime.GetSeconds();
 
   // Final flow monitor check
   monitor->CheckForLostPackets();
+  CloseMobilityStates();
+  if (enableCensus)
+  {
+    WriteObjectCensus("handover_object_census.csv", "end", numUes, numEnbs);
+  }
   
   // Clean up
+  if (g_binaryLog)
+  {
+    g_binaryLog->FreezeClock();
+  }
   Simulator::Destroy();
+  if (g_binaryLog)
+  {
+    std::clog.rdbuf(g_textLog);
+    std::cout << "Binary log: " << g_binaryLog->GetRecords() << " records, " << g_binaryLog->GetBytes()
+              << " bytes in handover_log.bin\n";
+    delete g_binaryLog;
+  }
 
   // Close all files
   g_measCsv.close();
-  g_enbRrcCsv.close();
-  g_ueRrcCsv.close();
+  CloseRrcEventStream();
   g_mobilityTraceFile.close();
   g_throughputFile.close();
-  g_handoverStatsFile.close();
   g_rsrpFile.close();
+  for (const auto& pending : g_x2uForwarding)
+  {
+    FlushX2uForwarding(pending.first, pending.second);
+  }
+  g_x2uForwardingFile.close();
+
+  // KPI summary closes the golden digest
+  DigestEvent("KPI,handovers," + std::to_string(g_totalHandovers));
+  DigestEvent("KPI,successfulHandovers," + std::to_string(g_successfulHandovers));
+  DigestEvent("KPI,hoFailures," + std::to_string(g_hoFailures));
+  for (const auto& pair : g_ueHandoverCount)
+  {
+    DigestEvent("KPI,ueHandovers," + std::to_string(pair.first) + "," + std::to_string(pair.second));
+  }
 
   // Print final statistics
   PrintFinalStatistics();
 
-  return 0;
+  if (!g_budgetExceeded.empty())
+  {
+    std::cout << "\nRESULT TRUNCATED: " << g_budgetExceeded << " budget exceeded, simulated " << simSeconds << " of "
+              << simTime.GetSeconds() << " s; all outputs cover [0, " << simSeconds << "] s only\n";
+    if (goldenMode == "record")
+    {
+      std::cout << "Not recording the golden digest of a truncated run\n";
+      goldenMode = "";
+    }
+  }
+
+  bool digestOk = FinishDigest(goldenMode, goldenFile, DigestScenarioKey("handover-mobility-analysis", argc, argv));
+  g_digestTraceFile.close();
+
+  PrintBenchLine("handover-mobility-analysis", setupSeconds, runSeconds, events, simSeconds, g_budgetExceeded);
+
+  return digestOk ? 0 : 1;
 }
@@ -0,0 +1,522 @@
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/mobility-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/lte-module.h"
+#include "ns3/point-to-point-module.h"
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <cmath>
+#include <algorithm>
+#include <chrono>
+
+#include "common/bench-line.h"
+#include "common/run-budget.h"
+#include "common/x2-links.h"
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE("HandoverStormBenchmark");
+
+// Handover storm stress scenario: groups of UEs cross the same cell border
+// within a short spread (train platforms, stadium exits) to load the eNB RRC
+// and X2 handover path. Reports handovers per simulated second, X2 queueing
+// delay, handover latency percentiles and simulator wall time per handover.
+
+// Global file streams
+static std::ofstream g_latencyFile("storm_handover_latency.csv");
+static std::ofstream g_rateFile("storm_ho_rate.csv");
+
+// Per-UE handover in progress
+struct StormHandover
+{
+  Time enbStart;        // Source eNB sends the X2 Handover Request
+  Time ueStart;         // UE receives the handover command
+  uint16_t sourceCellId = 0;
+  uint16_t targetCellId = 0;
+  bool ueDone = false;
+  Time ueEnd;
+};
+
+static uint32_t g_groupSize = 1;
+static std::map<uint64_t, StormHandover> g_pendingHo;  // IMSI -> handover in progress
+static std::map<uint64_t, Time> g_x2RequestSent;       // IMSI -> X2 Handover Request of the preparation
+static std::vector<double> g_commandLatencyMs;         // Preparation start -> UE handover command
+static std::vector<double> g_interruptionMs;           // UE handover command -> UE handover complete
+static std::vector<double> g_totalLatencyMs;           // Preparation start -> target eNB completion
+static uint32_t g_handoversStarted = 0;
+static uint32_t g_handoversCompleted = 0;
+static uint32_t g_handoverFailures = 0;
+
+// Per simulated second: completed handovers, failures and X2 queue samples
+struct StormSecond
+{
+  uint32_t handovers = 0;
+  uint32_t failures = 0;
+  uint32_t x2Packets = 0;
+  double x2QueueSumUs = 0.0;
+  double x2QueueMaxUs = 0.0;
+};
+
+static std::vector<StormSecond> g_seconds;
+static std::map<uint64_t, Time> g_x2Enqueued;  // Packet UID -> enqueue time
+static std::vector<double> g_x2QueueUs;
+static uint32_t g_x2Drops = 0;
+
+static StormSecond& CurrentSecond()
+{
+  size_t s = static_cast<size_t>(Simulator::Now().GetSeconds());
+  if (s >= g_seconds.size())
+  {
+    g_seconds.resize(s + 1);
+  }
+  return g_seconds[s];
+}
+
+// Nearest-rank percentile
+static double Percentile(std::vector<double> values, double p)
+{
+  if (values.empty())
+  {
+    return 0.0;
+  }
+  std::sort(values.begin(), values.end());
+  size_t rank = static_cast<size_t>(std::ceil(p / 100.0 * values.size()));
+  return values[std::min(values.size() - 1, rank > 0 ? rank - 1 : 0)];
+}
+
+static double Mean(const std::vector<double>& values)
+{
+  double sum = 0.0;
+  for (double v : values)
+  {
+    sum += v;
+  }
+  return values.empty() ? 0.0 : sum / values.size();
+}
+
+// The eNB HandoverStart trace fires once the target has acknowledged the
+// preparation; the preparation itself started with the X2 Handover Request
+static void EnbHoStart(std::string context, uint64_t imsi, uint16_t cellId, uint16_t rnti, uint16_t targetCid)
+{
+  g_handoversStarted++;
+  StormHandover& ho = g_pendingHo[imsi];
+  ho = StormHandover();
+  auto request = g_x2RequestSent.find(imsi);
+  if (request != g_x2RequestSent.end())
+  {
+    ho.enbStart = request->second;
+    g_x2RequestSent.erase(request);
+  }
+  else
+  {
+    ho.enbStart = Simulator::Now();
+  }
+  ho.sourceCellId = cellId;
+  ho.targetCellId = targetCid;
+}
+
+static void UeHoStart(std::string context, uint64_t imsi, uint16_t cellId, uint16_t rnti, uint16_t targetCid)
+{
+  auto it = g_pendingHo.find(imsi);
+  if (it != g_pendingHo.end())
+  {
+    it->second.ueStart = Simulator::Now();
+  }
+}
+
+static void UeHoEndOk(std::string context, uint64_t imsi, uint16_t cellId, uint16_t rnti)
+{
+  auto it = g_pendingHo.find(imsi);
+  if (it != g_pendingHo.end())
+  {
+    it->second.ueDone = true;
+    it->second.ueEnd = Simulator::Now();
+  }
+}
+
+static void EnbHoEndOk(std::string context, uint64_t imsi, uint16_t cellId, uint16_t rnti)
+{
+  auto it = g_pendingHo.find(imsi);
+  if (it == g_pendingHo.end())
+  {
+    return;
+  }
+  const StormHandover& ho = it->second;
+  g_handoversCompleted++;
+  CurrentSecond().handovers++;
+
+  double commandMs = (ho.ueStart - ho.enbStart).GetSeconds() * 1000.0;
+  double interruptionMs = ho.ueDone ? (ho.ueEnd - ho.ueStart).GetSeconds() * 1000.0 : -1.0;
+  double totalMs = (Simulator::Now() - ho.enbStart).GetSeconds() * 1000.0;
+  g_commandLatencyMs.push_back(commandMs);
+  if (ho.ueDone)
+  {
+    g_interruptionMs.push_back(interruptionMs);
+  }
+  g_totalLatencyMs.push_back(totalMs);
+
+  g_latencyFile << imsi << "," << (imsi - 1) / g_groupSize << "," << ho.sourceCellId << "," << ho.targetCellId << ","
+                << std::fixed << std::setprecision(6) << ho.enbStart.GetSeconds() << ","
+                << ho.ueStart.GetSeconds() << "," << Simulator::Now().GetSeconds() << ","
+                << std::setprecision(3) << commandMs << "," << interruptionMs << "," << totalMs << "\n";
+  g_pendingHo.erase(it);
+}
+
+static void EnbHoFailure(std::string context, uint64_t imsi, uint16_t rnti, uint16_t cellId)
+{
+  g_handoverFailures++;
+  CurrentSecond().failures++;
+  g_pendingHo.erase(imsi);
+}
+
+// MacTx of an X2 device, before the PPP header: record when the source sends
+// the X2AP Handover Request (its MME UE S1AP id is the IMSI)
+static void X2Tx(Ptr<const Packet> p)
+{
+  Ptr<Packet> packet = p->Copy();
+  Ipv4Header ipHeader;
+  packet->RemoveHeader(ipHeader);
+  UdpHeader udpHeader;
+  packet->RemoveHeader(udpHeader);
+  if (udpHeader.GetDestinationPort() == kX2uUdpPort)
+  {
+    return;
+  }
+  EpcX2Header x2Header;
+  packet->RemoveHeader(x2Header);
+  if (x2Header.GetProcedureCode() == EpcX2Header::HandoverPreparation
+      && x2Header.GetMessageType() == EpcX2Header::InitiatingMessage)
+  {
+    EpcX2HandoverRequestHeader request;
+    packet->RemoveHeader(request);
+    g_x2RequestSent[request.GetMmeUeS1apId()] = Simulator::Now();
+  }
+}
+
+// X2 device queue sojourn, matched by packet UID
+static void X2Enqueue(Ptr<const Packet> packet)
+{
+  g_x2Enqueued[packet->GetUid()] = Simulator::Now();
+}
+
+static void X2Dequeue(Ptr<const Packet> packet)
+{
+  auto it = g_x2Enqueued.find(packet->GetUid());
+  if (it == g_x2Enqueued.end())
+  {
+    return;
+  }
+  double queueUs = (Simulator::Now() - it->second).GetSeconds() * 1e6;
+  g_x2Enqueued.erase(it);
+  g_x2QueueUs.push_back(queueUs);
+  StormSecond& sec = CurrentSecond();
+  sec.x2Packets++;
+  sec.x2QueueSumUs += queueUs;
+  sec.x2QueueMaxUs = std::max(sec.x2QueueMaxUs, queueUs);
+}
+
+static void X2Drop(Ptr<const Packet> packet)
+{
+  g_x2Drops++;
+  g_x2Enqueued.erase(packet->GetUid());
+}
+
+// Hook the transmit queues and MacTx of the eNB-to-eNB point-to-point devices
+static uint32_t ConnectX2Queues(NodeContainer enbNodes)
+{
+  uint32_t hooked = 0;
+  ForEachX2Device(enbNodes, [&hooked](Ptr<PointToPointNetDevice> p2p, uint32_t, uint32_t) {
+    Ptr<Queue<Packet>> queue = p2p->GetQueue();
+    queue->TraceConnectWithoutContext("Enqueue", MakeCallback(&X2Enqueue));
+    queue->TraceConnectWithoutContext("Dequeue", MakeCallback(&X2Dequeue));
+    queue->TraceConnectWithoutContext("Drop", MakeCallback(&X2Drop));
+    p2p->TraceConnectWithoutContext("MacTx", MakeCallback(&X2Tx));
+    hooked++;
+  });
+  return hooked;
+}
+
+// Parse "0,2" into border indices; empty selects every border
+static std::vector<uint32_t> ParseBorders(const std::string& spec, uint32_t numBorders)
+{
+  std::vector<uint32_t> borders;
+  std::stringstream ss(spec);
+  std::string item;
+  while (std::getline(ss, item, ','))
+  {
+    if (item.empty())
+    {
+      continue;
+    }
+    uint32_t b = std::stoul(item);
+    if (b >= numBorders)
+    {
+      NS_FATAL_ERROR("Border " << b << " does not exist (" << numBorders << " borders)");
+    }
+    borders.push_back(b);
+  }
+  if (borders.empty())
+  {
+    for (uint32_t b = 0; b < numBorders; ++b)
+    {
+      borders.push_back(b);
+    }
+  }
+  return borders;
+}
+
+int main(int argc, char* argv[])
+{
+  auto setupStart = std::chrono::steady_clock::now();
+  uint32_t numEnbs = 3;            // Cells on a line; border b lies between cells b and b+1
+  std::string borders = "";        // Borders loaded by the storm, empty = all
+  uint32_t numGroups = 4;          // UE groups, assigned round-robin to the borders
+  uint32_t groupSize = 50;         // UEs per group
+  double enbSpacing = 500.0;       // Distance between neighbouring eNBs (m)
+  double crossingLength = 200.0;   // Path length across the border (m)
+  double ueSpeed = 10.0;           // Crossing speed (m/s)
+  double laneWidth = 40.0;         // Lateral spread of a group (m)
+  Time stormStart = Seconds(5.0);  // First wave, after the initial attach has settled
+  Time groupInterval = Seconds(0.0); // Offset between the start of consecutive groups
+  Time groupSpread = Seconds(1.0); // Start spread of the UEs within a group
+  uint32_t numWaves = 2;           // Crossings per UE, alternating direction
+  Time wavePeriod = Seconds(30.0); // Time between waves
+  std::string x2DataRate = "10Gb/s";
+  Time x2Delay = Seconds(0.0);
+  double maxWallSeconds = 0;       // Run budgets, 0 = unlimited
+  double maxRssMb = 0;
+  uint64_t maxTraceBytes = 0;
+
+  CommandLine cmd;
+  cmd.AddValue("numEnbs", "Number of eNBs on the line", numEnbs);
+  cmd.AddValue("borders", "Comma-separated border indices to load, empty = all", borders);
+  cmd.AddValue("numGroups", "Number of synchronized UE groups", numGroups);
+  cmd.AddValue("groupSize", "UEs per group", groupSize);
+  cmd.AddValue("enbSpacing", "Distance between neighbouring eNBs (m)", enbSpacing);
+  cmd.AddValue("crossingLength", "Path length across the border (m)", crossingLength);
+  cmd.AddValue("ueSpeed", "UE crossing speed in m/s", ueSpeed);
+  cmd.AddValue("laneWidth", "Lateral spread of a group (m)", laneWidth);
+  cmd.AddValue("stormStart", "Start of the first wave", stormStart);
+  cmd.AddValue("groupInterval", "Offset between consecutive groups", groupInterval);
+  cmd.AddValue("groupSpread", "Start spread of the UEs within a group", groupSpread);
+  cmd.AddValue("numWaves", "Border crossings per UE (alternating direction)", numWaves);
+  cmd.AddValue("wavePeriod", "Time between waves", wavePeriod);
+  cmd.AddValue("x2DataRate", "X2 link data rate", x2DataRate);
+  cmd.AddValue("x2Delay", "X2 link propagation delay", x2Delay);
+  cmd.AddValue("maxWallSeconds", "Stop the run cleanly after this much wall-clock time (0 = unlimited)", maxWallSeconds);
+  cmd.AddValue("maxRssMb", "Stop the run cleanly once peak RSS exceeds this (MB, 0 = unlimited)", maxRssMb);
+  cmd.AddValue("maxTraceBytes", "Stop the run cleanly once the trace files exceed this size (0 = unlimited)", maxTraceBytes);
+  cmd.Parse(argc, argv);
+
+  if (numEnbs < 2 || numGroups == 0 || groupSize == 0 || numWaves == 0)
+  {
+    NS_FATAL_ERROR("Need at least 2 eNBs, 1 group, 1 UE per group and 1 wave");
+  }
+  if (ueSpeed <= 0 || crossingLength <= 0 || stormStart.IsStrictlyNegative())
+  {
+    NS_FATAL_ERROR("ueSpeed and crossingLength must be positive and stormStart not negative");
+  }
+  std::vector<uint32_t> borderSet = ParseBorders(borders, numEnbs - 1);
+  uint32_t numUes = numGroups * groupSize;
+  g_groupSize = groupSize;
+
+  Time crossingTime = Seconds(crossingLength / ueSpeed);
+  Time waveLength = Seconds(groupInterval.GetSeconds() * (numGroups - 1)) + groupSpread + crossingTime;
+  if (numWaves > 1 && waveLength > wavePeriod)
+  {
+    NS_FATAL_ERROR("A wave lasts " << waveLength.GetSeconds() << " s, longer than wavePeriod");
+  }
+  Time lastWave = stormStart + Seconds(wavePeriod.GetSeconds() * (numWaves - 1) + groupInterval.GetSeconds() * (numGroups - 1));
+  Time simTime = lastWave + groupSpread + crossingTime + Seconds(2.0);
+
+  // Create EPC and LTE helpers
+  Ptr<PointToPointEpcHelper> epcHelper = CreateObject<PointToPointEpcHelper>();
+  epcHelper->SetAttribute("X2LinkDataRate", DataRateValue(DataRate(x2DataRate)));
+  epcHelper->SetAttribute("X2LinkDelay", TimeValue(x2Delay));
+  Ptr<LteHelper> lteHelper = CreateObject<LteHelper>();
+  lteHelper->SetEpcHelper(epcHelper);
+  lteHelper->SetEnbAntennaModelType("ns3::IsotropicAntennaModel");
+  lteHelper->SetUeAntennaModelType("ns3::IsotropicAntennaModel");
+  lteHelper->SetHandoverAlgorithmType("ns3::A3RsrpHandoverAlgorithm");
+  lteHelper->SetHandoverAlgorithmAttribute("Hysteresis", DoubleValue(1.5));
+  lteHelper->SetHandoverAlgorithmAttribute("TimeToTrigger", TimeValue(MilliSeconds(100)));
+
+  NodeContainer enbNodes;
+  enbNodes.Create(numEnbs);
+  NodeContainer ueNodes;
+  ueNodes.Create(numUes);
+
+  MobilityHelper enbMobility;
+  Ptr<ListPositionAllocator> enbPositionAlloc = CreateObject<ListPositionAllocator>();
+  for (uint32_t i = 0; i < numEnbs; ++i)
+  {
+    enbPositionAlloc->Add(Vector(i * enbSpacing, 0.0, 30.0));
+  }
+  enbMobility.SetPositionAllocator(enbPositionAlloc);
+  enbMobility.SetMobilityModel("ns3::ConstantPositionMobilityModel");
+  enbMobility.Install(enbNodes);
+
+  // Group g crosses border borderSet[g % size]. Each UE waits at its start point
+  // until its wave begins (plus a random offset within the group spread), then
+  // walks straight across; odd waves walk back.
+  MobilityHelper ueMobility;
+  ueMobility.SetMobilityModel("ns3::WaypointMobilityModel");
+  ueMobility.Install(ueNodes);
+  Ptr<UniformRandomVariable> jitter = CreateObject<UniformRandomVariable>();
+  std::vector<uint32_t> initialEnb(numUes);
+  for (uint32_t u = 0; u < numUes; ++u)
+  {
+    uint32_t group = u / groupSize;
+    uint32_t border = borderSet[group % borderSet.size()];
+    double borderX = (border + 0.5) * enbSpacing;
+    double y = jitter->GetValue(-laneWidth / 2, laneWidth / 2);
+    Vector sides[2] = {Vector(borderX - crossingLength / 2, y, 1.5), Vector(borderX + crossingLength / 2, y, 1.5)};
+    Time offset = Seconds(jitter->GetValue(0.0, groupSpread.GetSeconds()));
+
+    // Waypoint times must increase. A waypoint at the time of the previous
+    // one is at the same place (the start at t=0 when the wave starts at once,
+    // back-to-back waves) and is skipped.
+    Ptr<WaypointMobilityModel> waypoints = ueNodes.Get(u)->GetObject<WaypointMobilityModel>();
+    Time lastWaypoint = Seconds(0.0);
+    waypoints->AddWaypoint(Waypoint(lastWaypoint, sides[0]));
+    for (uint32_t w = 0; w < numWaves; ++w)
+    {
+      Time start = stormStart + Seconds(wavePeriod.GetSeconds() * w + groupInterval.GetSeconds() * group) + offset;
+      if (start > lastWaypoint)
+      {
+        waypoints->AddWaypoint(Waypoint(start, sides[w % 2]));
+      }
+      lastWaypoint = start + crossingTime;
+      waypoints->AddWaypoint(Waypoint(lastWaypoint, sides[(w + 1) % 2]));
+    }
+    initialEnb[u] = border;
+  }
+
+  NetDeviceContainer enbLteDevs = lteHelper->InstallEnbDevice(enbNodes);
+  NetDeviceContainer ueLteDevs = lteHelper->InstallUeDevice(ueNodes);
+
+  InternetStackHelper internet;
+  internet.Install(ueNodes);
+  epcHelper->AssignUeIpv4Address(NetDeviceContainer(ueLteDevs));
+
+  for (uint32_t i = 0; i < numEnbs; ++i)
+  {
+    for (uint32_t j = i + 1; j < numEnbs; ++j)
+    {
+      lteHelper->AddX2Interface(enbNodes.Get(i), enbNodes.Get(j));
+    }
+  }
+  uint32_t x2Queues = ConnectX2Queues(enbNodes);
+
+  for (uint32_t u = 0; u < numUes; ++u)
+  {
+    lteHelper->Attach(ueLteDevs.Get(u), enbLteDevs.Get(initialEnb[u]));
+  }
+
+  // Handover traces
+  Config::Connect("/NodeList/*/DeviceList/*/LteEnbRrc/HandoverStart", MakeCallback(&EnbHoStart));
+  Config::Connect("/NodeList/*/DeviceList/*/LteEnbRrc/HandoverEndOk", MakeCallback(&EnbHoEndOk));
+  Config::Connect("/NodeList/*/DeviceList/*/LteUeRrc/HandoverStart", MakeCallback(&UeHoStart));
+  Config::Connect("/NodeList/*/DeviceList/*/LteUeRrc/HandoverEndOk", MakeCallback(&UeHoEndOk));
+  // Handover failure traces exist from ns-3.37 on
+  for (const char* failure : {"HandoverFailureNoPreamble", "HandoverFailureMaxRach", "HandoverFailureLeaving",
+                              "HandoverFailureJoining"})
+  {
+    Config::ConnectFailSafe(std::string("/NodeList/*/DeviceList/*/LteEnbRrc/") + failure, MakeCallback(&EnbHoFailure));
+  }
+
+  g_latencyFile << "imsi,group,sourceCellId,targetCellId,prepStart,ueHoStart,enbHoEnd,commandMs,interruptionMs,totalMs\n";
+
+  std::cout << "Starting handover storm benchmark...\n";
+  std::cout << "- UEs: " << numUes << " (" << numGroups << " groups of " << groupSize << ")\n";
+  std::cout << "- Borders loaded: " << borderSet.size() << " of " << numEnbs - 1 << "\n";
+  std::cout << "- Waves: " << numWaves << " every " << wavePeriod.GetSeconds() << " s, group spread "
+            << groupSpread.GetSeconds() << " s\n";
+  std::cout << "- X2 queues traced: " << x2Queues << "\n";
+  std::cout << "- Duration: " << simTime.GetSeconds() << " seconds\n";
+
+  Simulator::Stop(simTime);
+  StartRunBudget(setupStart, maxWallSeconds, maxRssMb, maxTraceBytes, {"storm_"});
+  auto wallStart = std::chrono::steady_clock::now();
+  double setupSeconds = std::chrono::duration<double>(wallStart - setupStart).count();
+  Simulator::Run();
+  StopRunBudget();
+  double wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - wallStart).count();
+  uint64_t events = Simulator::GetEventCount();
+  double simSeconds = g_budgetExceeded.empty() ? simTime.GetSeconds() : g_budgetStopTime.GetSeconds();
+  Simulator::Destroy();
+
+  // Per-second time series
+  g_rateFile << "second,handovers,failures,x2Packets,x2MeanQueueUs,x2MaxQueueUs\n";
+  uint32_t peakRate = 0;
+  uint32_t activeSeconds = 0;
+  for (size_t s = 0; s < g_seconds.size(); ++s)
+  {
+    const StormSecond& sec = g_seconds[s];
+    g_rateFile << s << "," << sec.handovers << "," << sec.failures << "," << sec.x2Packets << ","
+               << std::fixed << std::setprecision(3)
+               << (sec.x2Packets > 0 ? sec.x2QueueSumUs / sec.x2Packets : 0.0) << "," << sec.x2QueueMaxUs << "\n";
+    peakRate = std::max(peakRate, sec.handovers);
+    activeSeconds += sec.handovers > 0 ? 1 : 0;
+  }
+
+  double wallMsPerHo = g_handoversCompleted > 0 ? wallSeconds * 1000.0 / g_handoversCompleted : 0.0;
+  double meanRate = activeSeconds > 0 ? double(g_handoversCompleted) / activeSeconds : 0.0;
+
+  // One row per run so that sweeps accumulate in a single file
+  std::ifstream existing("storm_benchmark.csv");
+  bool writeHeader = !existing.good() || existing.peek() == std::ifstream::traits_type::eof();
+  existing.close();
+  std::ofstream benchFile("storm_benchmark.csv", std::ios::app);
+  if (writeHeader)
+  {
+    benchFile << "numUes,groupSize,borders,waves,groupSpreadS,hoStarted,hoCompleted,hoFailures,"
+              << "peakHoPerS,meanHoPerActiveS,totalP50Ms,totalP90Ms,totalP99Ms,totalMaxMs,"
+              << "interruptionP50Ms,interruptionP99Ms,x2Packets,x2MeanQueueUs,x2P99QueueUs,x2Drops,"
+              << "wallS,wallMsPerHo,events\n";
+  }
+  benchFile << numUes << "," << groupSize << "," << borderSet.size() << "," << numWaves << ","
+            << groupSpread.GetSeconds() << "," << g_handoversStarted << "," << g_handoversCompleted << ","
+            << g_handoverFailures << "," << peakRate << "," << std::fixed << std::setprecision(3) << meanRate << ","
+            << Percentile(g_totalLatencyMs, 50) << "," << Percentile(g_totalLatencyMs, 90) << ","
+            << Percentile(g_totalLatencyMs, 99) << "," << Percentile(g_totalLatencyMs, 100) << ","
+            << Percentile(g_interruptionMs, 50) << "," << Percentile(g_interruptionMs, 99) << ","
+            << g_x2QueueUs.size() << "," << Mean(g_x2QueueUs) << "," << Percentile(g_x2QueueUs, 99) << ","
+            << g_x2Drops << "," << wallSeconds << "," << wallMsPerHo << "," << events << "\n";
+  benchFile.close();
+  g_latencyFile.close();
+  g_rateFile.close();
+
+  std::cout << "\n========== HANDOVER STORM BENCHMARK ==========\n";
+  std::cout << "Handovers started/completed/failed: " << g_handoversStarted << "/" << g_handoversCompleted << "/"
+            << g_handoverFailures << "\n";
+  std::cout << "Handovers per simulated second: peak " << peakRate << ", mean " << std::setprecision(1) << meanRate
+            << " over " << activeSeconds << " active seconds\n";
+  std::cout << "Handover latency (prep start -> target complete) p50/p90/p99/max: " << std::setprecision(2)
+            << Percentile(g_totalLatencyMs, 50) << "/" << Percentile(g_totalLatencyMs, 90) << "/"
+            << Percentile(g_totalLatencyMs, 99) << "/" << Percentile(g_totalLatencyMs, 100) << " ms\n";
+  std::cout << "Handover command latency p50/p99: " << Percentile(g_commandLatencyMs, 50) << "/"
+            << Percentile(g_commandLatencyMs, 99) << " ms\n";
+  std::cout << "UE interruption p50/p99: " << Percentile(g_interruptionMs, 50) << "/"
+            << Percentile(g_interruptionMs, 99) << " ms\n";
+  std::cout << "X2 queueing delay mean/p99/max: " << Mean(g_x2QueueUs) << "/" << Percentile(g_x2QueueUs, 99) << "/"
+            << Percentile(g_x2QueueUs, 100) << " us over " << g_x2QueueUs.size() << " packets, "
+            << g_x2Drops << " drops\n";
+  std::cout << "Wall time: " << std::setprecision(3) << wallSeconds << " s, " << wallMsPerHo
+            << " ms per handover, " << events << " events\n";
+  std::cout << "\nGenerated Files:\n";
+  std::cout << "- storm_handover_latency.csv (per-handover stage timestamps and latencies)\n";
+  std::cout << "- storm_ho_rate.csv (handovers, failures and X2 queueing per simulated second)\n";
+  std::cout << "- storm_benchmark.csv (one summary row appended per run)\n";
+  std::cout << "==============================================\n";
+  if (!g_budgetExceeded.empty())
+  {
+    std::cout << "\nRESULT TRUNCATED: " << g_budgetExceeded << " budget exceeded, simulated " << simSeconds << " of "
+              << simTime.GetSeconds() << " s; all outputs cover [0, " << simSeconds << "] s only\n";
+  }
+  PrintBenchLine("handover-storm-benchmark", setupSeconds, wallSeconds, events, simSeconds, g_budgetExceeded);
+
+  return 0;
+}
@@ -6,8 +6,16 @@
 #include "ns3/point-to-point-helper.h"
 #include <fstream>
 #include <sstream>
+#include <vector>
+#include <algorithm>
+#include <iomanip>
+#include <chrono>
 #include "ns3/applications-module.h"
 
+#include "common/remote-hosts.h"
+#include "common/bench-line.h"
+#include "common/run-budget.h"
+
 using namespace ns3;
 
 static std::ofstream g_measCsv("meas_reports.csv");
@@ -77,11 +85,20 @@ static void UeHoEndOk(std::string context, uint64_t imsi, uint16_t cellId, uint1
 
 int main(int argc, char* argv[])
 {
+  auto wallStart = std::chrono::steady_clock::now();
   Time simTime = Seconds(20.0);
   bool enableLogs = false;
+  uint32_t numRemoteHosts = 1;
+  double maxWallSeconds = 0;  // Run budgets, 0 = unlimited
+  double maxRssMb = 0;
+  uint64_t maxTraceBytes = 0;
   CommandLine cmd;
   cmd.AddValue("simTime", "Simulation time (s)", simTime);
   cmd.AddValue("enableLogs", "Turn on LTE logging", enableLogs);
+  cmd.AddValue("numRemoteHosts", "Number of remote hosts behind the PGW (UEs sharded by IMSI)", numRemoteHosts);
+  cmd.AddValue("maxWallSeconds", "Stop the run cleanly after this much wall-clock time (0 = unlimited)", maxWallSeconds);
+  cmd.AddValue("maxRssMb", "Stop the run cleanly once peak RSS exceeds this (MB, 0 = unlimited)", maxRssMb);
+  cmd.AddValue("maxTraceBytes", "Stop the run cleanly once the trace files exceed this size (0 = unlimited)", maxTraceBytes);
   cmd.Parse(argc, argv);
 
   if (enableLogs)
@@ -89,26 +106,18 @@ int main(int argc, char* argv[])
     LogComponentEnable("LteHelper", LOG_LEVEL_INFO);
   }
 
-  // 0) EPC core and a remote host for traffic
+  // 0) EPC core and remote hosts for traffic
   Ptr<PointToPointEpcHelper> epcHelper = CreateObject<PointToPointEpcHelper>();
   Ptr<LteHelper> lteHelper = CreateObject<LteHelper>();
   lteHelper->SetEpcHelper(epcHelper);
 
   Ptr<Node> pgw = epcHelper->GetPgwNode();
-  NodeContainer remoteHostContainer;
-  remoteHostContainer.Create(1);
   InternetStackHelper internet;
-  internet.Install(remoteHostContainer);
   PointToPointHelper p2ph;
   p2ph.SetDeviceAttribute("DataRate", StringValue("10Gbps"));
   p2ph.SetChannelAttribute("Delay", StringValue("2ms"));
-  NetDeviceContainer internetDevs = p2ph.Install(pgw, remoteHostContainer.Get(0));
-  Ipv4AddressHelper ipv4h;
-  ipv4h.SetBase("1.0.0.0", "255.0.0.0");
-  Ipv4InterfaceContainer iic = ipv4h.Assign(internetDevs);
+  SetupRemoteHosts(pgw, numRemoteHosts, internet, p2ph);
   Ipv4StaticRoutingHelper ipv4RoutingHelper;
-  Ptr<Ipv4StaticRouting> remoteHostStaticRouting = ipv4RoutingHelper.GetStaticRouting(remoteHostContainer.Get(0)->GetObject<Ipv4>());
-  remoteHostStaticRouting->AddNetworkRouteTo(Ipv4Address("7.0.0.0"), Ipv4Mask("255.0.0.0"), 1);
 
   // 1) Nodes: 3 eNBs (0=legit, 1=faulty legit, 2=fake/CSG) and 1 UE
   NodeContainer enbNodes;
@@ -165,7 +174,7 @@ int main(int argc, char* argv[])
   UdpClientHelper dlClient(ueIpIfaces.GetAddress(0), dlPort);
   dlClient.SetAttribute("Interval", TimeValue(MilliSeconds(20)));
   dlClient.SetAttribute("MaxPackets", UintegerValue(1000000));
-  clientApps.Add(dlClient.Install(remoteHostContainer.Get(0)));
+  clientApps.Add(dlClient.Install(g_remoteHosts.Get(RemoteHostShard(1))));
   serverApps.Start(Seconds(0.5));
   clientApps.Start(Seconds(0.6));
 
@@ -222,7 +231,13 @@ int main(int argc, char* argv[])
   g_ueRrcCsv  << "event,time,imsi,cellId,rnti,info\n";
 
   Simulator::Stop(simTime);
+  StartRunBudget(wallStart, maxWallSeconds, maxRssMb, maxTraceBytes, {"meas_reports", "enb_rrc_events", "ue_rrc_events"});
+  double setupSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - wallStart).count();
   Simulator::Run();
+  StopRunBudget();
+  double runSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - wallStart).count() - setupSeconds;
+  uint64_t events = Simulator::GetEventCount();
+  double simSeconds = g_budgetExceeded.empty() ? simTime.GetSeconds() : g_budgetStopTime.GetSeconds();
   Simulator::Destroy();
 
   g_measCsv.close();
@@ -230,5 +245,11 @@ int main(int argc, char* argv[])
   g_ueRrcCsv.close();
 
   std::cout << "Wrote meas_reports.csv, enb_rrc_events.csv, ue_rrc_events.csv\n";
+  if (!g_budgetExceeded.empty())
+  {
+    std::cout << "RESULT TRUNCATED: " << g_budgetExceeded << " budget exceeded, simulated " << simSeconds << " of "
+              << simTime.GetSeconds() << " s\n";
+  }
+  PrintBenchLine("rogue-enb", setupSeconds, runSeconds, events, simSeconds, g_budgetExceeded);
   return 0;
 }
@@ -0,0 +1,121 @@
+#!/usr/bin/env python3
+"""
+RRC event stream converter
+Rebuilds the legacy per-file RRC views (eNB events, UE events and handover
+statistics) from the unified stream written by handover-mobility-analysis
+(handover_rrc_events.csv) and comprehensive-handover-analysis
+(comprehensive_rrc_events.csv). Each stream record carries a side column
+(ENB, UE or BOTH); BOTH records expand into one row per side.
+"""
+
+import argparse
+import csv
+import sys
+from pathlib import Path
+
+# Stream file -> (eNB view, UE view, handover statistics view)
+LEGACY_VIEWS = {
+    'handover_rrc_events.csv': ('handover_enb_rrc_events.csv',
+                                'handover_ue_rrc_events.csv',
+                                'handover_statistics.csv'),
+    'comprehensive_rrc_events.csv': ('comprehensive_enb_rrc_events.csv',
+                                     'comprehensive_ue_rrc_events.csv',
+                                     'comprehensive_handover_statistics.csv'),
+}
+
+
+def rrc_rows(row, typed):
+    """Legacy eNB/UE RRC row body (without the event name) for a stream record."""
+    fields = [row['time'], row['imsi'], row['cellId']]
+    if typed:
+        fields.append(row['cellType'])
+    fields.append(row['rnti'])
+    if row['event'] == 'HO_START':
+        fields.append('to:' + row['targetCellId'])
+        if typed:
+            fields.append(row['targetCellType'])
+    return fields
+
+
+def stats_row(row, typed):
+    """Legacy handover statistics row, or None for connection events."""
+    if row['event'] == 'HO_START':
+        fields = ['HO_START', row['time'], row['imsi'], row['cellId']]
+        if typed:
+            fields.append(row['cellType'])
+        fields.append(row['targetCellId'])
+        if typed:
+            fields.append(row['targetCellType'])
+        return fields
+    if row['event'] == 'HO_END_OK':
+        fields = ['HO_END_OK', row['time'], row['imsi'], row['cellId']]
+        if typed:
+            fields.append(row['cellType'])
+        return fields
+    return None
+
+
+def convert(stream_path, output_dir):
+    stream_path = Path(stream_path)
+    views = LEGACY_VIEWS.get(stream_path.name)
+    if views is None:
+        prefix = stream_path.name.replace('rrc_events.csv', '')
+        views = (prefix + 'enb_rrc_events.csv', prefix + 'ue_rrc_events.csv',
+                 prefix + 'handover_statistics.csv')
+    output_dir = Path(output_dir) if output_dir else stream_path.parent
+
+    with open(stream_path, newline='') as f:
+        reader = csv.DictReader(f)
+        typed = 'cellType' in reader.fieldnames
+        records = list(reader)
+
+    if typed:
+        rrc_header = 'event,time,imsi,cellId,cellType,rnti,info\n'
+        stats_header = 'event,time,imsi,sourceCellId,sourceCellType,targetCellId,targetCellType\n'
+    else:
+        rrc_header = 'event,time,imsi,cellId,rnti,info\n'
+        stats_header = 'event,time,imsi,sourceCellId,targetCellId\n'
+
+    counts = [0, 0, 0]
+    with open(output_dir / views[0], 'w') as enb, \
+         open(output_dir / views[1], 'w') as ue, \
+         open(output_dir / views[2], 'w') as stats:
+        enb.write(rrc_header)
+        ue.write(rrc_header)
+        stats.write(stats_header)
+        for row in records:
+            body = ','.join(rrc_rows(row, typed))
+            if row['side'] in ('ENB', 'BOTH'):
+                enb.write(row['event'] + ',' + body + '\n')
+                counts[0] += 1
+                fields = stats_row(row, typed)
+                if fields:
+                    stats.write(','.join(fields) + '\n')
+                    counts[2] += 1
+            if row['side'] in ('UE', 'BOTH'):
+                ue.write('UE_' + row['event'] + ',' + body + '\n')
+                counts[1] += 1
+
+    print(f"{stream_path.name}: {len(records)} stream records")
+    for name, count in zip(views, counts):
+        print(f"  {output_dir / name}: {count} rows")
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Rebuild legacy RRC CSV views from the unified RRC event stream')
+    parser.add_argument('streams', nargs='*',
+                        help='RRC stream files (default: every known stream in the current directory)')
+    parser.add_argument('--output-dir', default=None,
+                        help='Directory for the legacy files (default: next to each stream)')
+    args = parser.parse_args()
+
+    streams = args.streams or [name for name in LEGACY_VIEWS if Path(name).exists()]
+    if not streams:
+        print("No RRC event stream found (handover_rrc_events.csv or comprehensive_rrc_events.csv)")
+        sys.exit(1)
+    for stream in streams:
+        convert(stream, args.output_dir)
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,200 @@
+#!/usr/bin/env python3
+"""
+Scaling study driver
+Runs each scenario program over a geometric ladder of sizes per dimension
+(UEs, eNBs, fake cells, ...), collects the BENCH line every program prints at
+the end (setup/run/wall time, simulator events, peak RSS) and fits a power law
+y = a * x^b per metric and dimension. Reports the exponents, the fit quality,
+the knee of each curve and the predicted cost at target scales, and flags
+dimensions that grow worse than linearly.
+"""
+
+import argparse
+import csv
+import math
+import re
+import subprocess
+import sys
+
+# Scaling dimensions of each program: option -> ladder base (the program default)
+DIMENSIONS = {
+    'handover-mobility-analysis': {
+        'numUes': 4,
+        'numEnbs': 5,
+    },
+    'comprehensive-handover-analysis': {
+        'numUes': 3,
+        'numLegitEnbs': 2,
+        'numFakeEnbs': 1,
+    },
+    'handover-storm-benchmark': {
+        'groupSize': 50,
+        'numEnbs': 3,
+    },
+}
+
+# Options that keep the runs lean and comparable
+FIXED_OPTIONS = {
+    'handover-mobility-analysis': ['--enablePcap=0'],
+    'comprehensive-handover-analysis': ['--enableNetAnim=0'],
+    'handover-storm-benchmark': ['--numWaves=1'],
+}
+
+# Option that sets the simulated duration; the storm benchmark has none, its
+# duration follows from the waves
+DURATION_OPTION = {
+    'handover-mobility-analysis': 'simTime',
+    'comprehensive-handover-analysis': 'simTime',
+    'handover-storm-benchmark': None,
+}
+
+METRICS = ['wallS', 'runS', 'setupS', 'events', 'peakRssMb']
+SUPERLINEAR_EXPONENT = 1.1
+BENCH_RE = re.compile(r'^BENCH (.*)$', re.MULTILINE)
+
+
+def ladder(base, steps, factor):
+    """Geometric ladder starting at the program's default size."""
+    values = []
+    for k in range(steps):
+        value = int(round(base * factor ** k))
+        if not values or value > values[-1]:
+            values.append(value)
+    return values
+
+
+def run_program(ns3_dir, program, options, dry_run):
+    command = ['./ns3', 'run', f"scratch/{program} {' '.join(options)}"]
+    print('  $ ' + ' '.join(command[:2]) + f' "{command[2]}"')
+    if dry_run:
+        return None
+    result = subprocess.run(command, cwd=ns3_dir, capture_output=True, text=True)
+    match = BENCH_RE.search(result.stdout)
+    if result.returncode != 0 or not match:
+        print(f"    run failed (exit {result.returncode}), no BENCH line")
+        return None
+    bench = dict(field.split('=', 1) for field in match.group(1).split())
+    if bench.get('truncated', '0') != '0':
+        print(f"    run truncated by the {bench['truncated']} budget, point skipped")
+        return None
+    return {metric: float(bench[metric]) for metric in METRICS if metric in bench}
+
+
+def least_squares(xs, ys):
+    """Slope, intercept and R^2 of a straight-line fit."""
+    n = len(xs)
+    mx, my = sum(xs) / n, sum(ys) / n
+    sxx = sum((x - mx) ** 2 for x in xs)
+    sxy = sum((x - mx) * (y - my) for x, y in zip(xs, ys))
+    slope = sxy / sxx if sxx > 0 else 0.0
+    intercept = my - slope * mx
+    ss_tot = sum((y - my) ** 2 for y in ys)
+    ss_res = sum((y - (intercept + slope * x)) ** 2 for x, y in zip(xs, ys))
+    r2 = 1.0 - ss_res / ss_tot if ss_tot > 0 else 1.0
+    return slope, intercept, r2
+
+
+def fit_power_law(points):
+    """Fit y = a * x^b in log-log space; None with fewer than two usable points."""
+    usable = [(x, y) for x, y in points if x > 0 and y > 0]
+    if len(usable) < 2:
+        return None
+    b, log_a, r2 = least_squares([math.log(x) for x, _ in usable], [math.log(y) for _, y in usable])
+    return {'a': math.exp(log_a), 'b': b, 'r2': r2}
+
+
+def find_knee(points):
+    """First size where the local exponent exceeds the first segment's by 0.5."""
+    usable = [(x, y) for x, y in points if x > 0 and y > 0]
+    local = []
+    for (x0, y0), (x1, y1) in zip(usable, usable[1:]):
+        local.append((x1, math.log(y1 / y0) / math.log(x1 / x0)))
+    if len(local) < 2:
+        return None
+    for x, exponent in local[1:]:
+        if exponent > local[0][1] + 0.5:
+            return x
+    return None
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Scaling study with power-law complexity fits')
+    parser.add_argument('--ns3-dir', default='.', help='ns-3 root holding the ./ns3 script and scratch/')
+    parser.add_argument('--programs', default=','.join(DIMENSIONS), help='Comma-separated scenario programs')
+    parser.add_argument('--dimensions', default='', help='Restrict to these dimensions (comma-separated)')
+    parser.add_argument('--steps', type=int, default=5, help='Ladder steps per dimension')
+    parser.add_argument('--factor', type=float, default=2.0, help='Ladder growth factor')
+    parser.add_argument('--sim-time', default='20', help='simTime passed to the programs that take one (s)')
+    parser.add_argument('--targets', default='100,1000', help='Sizes to predict the cost at')
+    parser.add_argument('--output', default='scaling_results.csv', help='Raw measurements')
+    parser.add_argument('--fits', default='scaling_fits.csv', help='Fitted models')
+    parser.add_argument('--dry-run', action='store_true', help='Only print the commands')
+    args = parser.parse_args()
+
+    programs = [p for p in args.programs.split(',') if p]
+    only = set(d for d in args.dimensions.split(',') if d)
+    targets = [float(t) for t in args.targets.split(',') if t]
+
+    rows = []
+    for program in programs:
+        if program not in DIMENSIONS:
+            print(f"Unknown program {program}, known: {', '.join(DIMENSIONS)}")
+            sys.exit(1)
+        for dimension, base in DIMENSIONS[program].items():
+            if only and dimension not in only:
+                continue
+            print(f"{program}: scaling {dimension}")
+            for value in ladder(base, args.steps, args.factor):
+                options = list(FIXED_OPTIONS[program])
+                if DURATION_OPTION[program]:
+                    options.append(f'--{DURATION_OPTION[program]}={args.sim_time}')
+                options.append(f'--{dimension}={value}')
+                bench = run_program(args.ns3_dir, program, options, args.dry_run)
+                if bench:
+                    rows.append({'program': program, 'dimension': dimension, 'value': value, **bench})
+                    print('    ' + ' '.join(f'{m}={bench[m]:g}' for m in METRICS if m in bench))
+
+    if args.dry_run or not rows:
+        return
+
+    with open(args.output, 'w', newline='') as f:
+        writer = csv.DictWriter(f, fieldnames=['program', 'dimension', 'value'] + METRICS)
+        writer.writeheader()
+        writer.writerows(rows)
+
+    fits = []
+    print("\nPower-law fits y = a * x^b:")
+    for program in programs:
+        for dimension in DIMENSIONS[program]:
+            series = [r for r in rows if r['program'] == program and r['dimension'] == dimension]
+            if len(series) < 2:
+                continue
+            print(f"{program} / {dimension}:")
+            for metric in METRICS:
+                points = [(r['value'], r[metric]) for r in series if metric in r]
+                fit = fit_power_law(points)
+                if not fit:
+                    continue
+                knee = find_knee(points)
+                flag = 'SUPERLINEAR' if fit['b'] > SUPERLINEAR_EXPONENT else ''
+                predictions = {t: fit['a'] * t ** fit['b'] for t in targets}
+                print(f"  {metric:<10} b={fit['b']:.2f} R2={fit['r2']:.3f}"
+                      + (f" knee at {knee}" if knee else '')
+                      + ''.join(f"  @{t:g}: {v:.4g}" for t, v in predictions.items())
+                      + (f"  <-- {flag}" if flag else ''))
+                fits.append({'program': program, 'dimension': dimension, 'metric': metric,
+                             'a': fit['a'], 'b': fit['b'], 'r2': fit['r2'], 'knee': knee or '',
+                             'superlinear': int(bool(flag)),
+                             **{f'predicted@{t:g}': v for t, v in predictions.items()}})
+
+    with open(args.fits, 'w', newline='') as f:
+        fieldnames = ['program', 'dimension', 'metric', 'a', 'b', 'r2', 'knee', 'superlinear'] \
+            + [f'predicted@{t:g}' for t in targets]
+        writer = csv.DictWriter(f, fieldnames=fieldnames)
+        writer.writeheader()
+        writer.writerows(fits)
+    print(f"\nMeasurements written to {args.output}, fits to {args.fits}")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,353 @@
+#!/usr/bin/env python3
+"""
+Cost-model-driven parameter sweep runner
+Expands a parameter grid into runs, predicts each run's wall time and peak
+memory from a model fitted on the history of previous runs, and schedules them
+longest-processing-time-first across the available cores without exceeding a
+memory budget. Each run gets its own working directory so the CSV outputs of
+concurrent runs do not collide. Measured costs (from the BENCH line) are
+appended to the history, so the model improves with every sweep. Per-run
+budgets (--max-wall-seconds, --max-rss-mb, --max-trace-bytes) are passed to the
+programs, which stop cleanly and mark the result truncated; a truncated run is
+reported but kept out of the history, and the sweep carries on.
+"""
+
+import argparse
+import csv
+import itertools
+import math
+import os
+import re
+import subprocess
+import sys
+import time
+
+BENCH_RE = re.compile(r'^BENCH (.*)$', re.MULTILINE)
+HISTORY_FIELDS = ['program', 'options', 'wallS', 'peakRssMb']
+DEFAULT_MEMORY_MB = 200.0
+# Options that size the scenario; memory is assumed to scale with these only
+SIZE_OPTIONS = {'numUes', 'numEnbs', 'numLegitEnbs', 'numFaultyEnbs', 'numFakeEnbs',
+                'numGroups', 'groupSize', 'numRemoteHosts'}
+
+
+def parse_grid(entries):
+    """['numUes=5,10,50', 'simTime=30,180'] -> list of option dicts (cartesian product)."""
+    names, values = [], []
+    for entry in entries:
+        name, _, spec = entry.partition('=')
+        names.append(name)
+        values.append([v for v in spec.split(',') if v])
+    return [dict(zip(names, combo)) for combo in itertools.product(*values)]
+
+
+def format_options(options):
+    return ' '.join(f'--{k}={v}' for k, v in sorted(options.items()))
+
+
+def positive_number(text):
+    try:
+        value = float(text)
+    except ValueError:
+        return None
+    return value if value > 0 else None
+
+
+class FeatureSpace:
+    """Regression features of the swept options.
+
+    An option whose grid values are all positive numbers contributes its log.
+    Any other option is categorical (e.g. hoAlgorithm=a3,cho) and is one-hot
+    encoded against its first grid value, which is the baseline level.
+    """
+
+    def __init__(self, grid_entries):
+        self.numeric = []
+        self.levels = {}
+        for entry in grid_entries:
+            name, _, spec = entry.partition('=')
+            values = [v for v in spec.split(',') if v]
+            if all(positive_number(v) is not None for v in values):
+                self.numeric.append(name)
+            else:
+                self.levels[name] = values
+        self.numeric.sort()
+        self.categorical = sorted(self.levels)
+        self.names = self.numeric + [f'{n}={v}' for n in self.categorical for v in self.levels[n][1:]]
+
+    def encode(self, options):
+        """Feature vector in the order of self.names; None if the run is outside the grid's domain."""
+        features = []
+        for name in self.numeric:
+            value = positive_number(options.get(name, ''))
+            if value is None:
+                return None
+            features.append(math.log(value))
+        for name in self.categorical:
+            value = options.get(name)
+            if value not in self.levels[name]:
+                return None
+            features.extend(1.0 if value == level else 0.0 for level in self.levels[name][1:])
+        return features
+
+    def scale(self, options, metric):
+        """Log of the options the fallback scales with: all numeric ones for
+        wall time, only the size options for memory."""
+        total = 0.0
+        for name in self.numeric:
+            if metric == 'peakRssMb' and name not in SIZE_OPTIONS:
+                continue
+            value = positive_number(options.get(name, ''))
+            if value is None:
+                return None
+            total += math.log(value)
+        return total
+
+
+def solve(matrix, vector):
+    """Gaussian elimination with partial pivoting; None if singular."""
+    n = len(vector)
+    a = [row[:] + [vector[i]] for i, row in enumerate(matrix)]
+    for col in range(n):
+        pivot = max(range(col, n), key=lambda r: abs(a[r][col]))
+        if abs(a[pivot][col]) < 1e-12:
+            return None
+        a[col], a[pivot] = a[pivot], a[col]
+        for r in range(n):
+            if r != col:
+                factor = a[r][col] / a[col][col]
+                a[r] = [x - factor * y for x, y in zip(a[r], a[col])]
+    return [a[i][n] / a[i][i] for i in range(n)]
+
+
+class CostModel:
+    """log(cost) = c0 + sum_i b_i * feature_i, fitted per program and metric.
+
+    With too little history for the full fit, falls back to the mean observed
+    cost scaled by the product of the numeric options for wall time
+    (cost ~ numUes * simTime) and of the size options for memory.
+    """
+
+    def __init__(self, history, space):
+        self.space = space
+        self.coefficients = {}
+        self.baseline = {}
+        for program in set(h['program'] for h in history):
+            for metric in ('wallS', 'peakRssMb'):
+                self._fit(program, metric, [h for h in history if h['program'] == program])
+
+    def _fit(self, program, metric, runs):
+        xs, ys, scales = [], [], []
+        for run in runs:
+            features = self.space.encode(run['options'])
+            scale = self.space.scale(run['options'], metric)
+            value = run.get(metric, 0.0)
+            if features is not None and value > 0:
+                xs.append([1.0] + features)
+                ys.append(math.log(value))
+                scales.append(scale)
+        if not xs:
+            return
+        self.baseline[(program, metric)] = sum(y - s for y, s in zip(ys, scales)) / len(ys)
+        if len(xs) <= len(self.space.names) + 1:
+            return
+        k = len(xs[0])
+        normal = [[sum(x[i] * x[j] for x in xs) for j in range(k)] for i in range(k)]
+        rhs = [sum(x[i] * y for x, y in zip(xs, ys)) for i in range(k)]
+        coefficients = solve(normal, rhs)
+        if coefficients:
+            self.coefficients[(program, metric)] = coefficients
+
+    def predict(self, program, options, metric, default):
+        features = self.space.encode(options)
+        if features is None:
+            return default
+        coefficients = self.coefficients.get((program, metric))
+        if coefficients:
+            return math.exp(coefficients[0] + sum(b * f for b, f in zip(coefficients[1:], features)))
+        scale = self.space.scale(options, metric)
+        if (program, metric) in self.baseline:
+            return math.exp(self.baseline[(program, metric)] + scale)
+        return default * math.exp(scale) if metric == 'wallS' else default
+
+    def describe(self):
+        for (program, metric), c in sorted(self.coefficients.items()):
+            terms = ' '.join(f'{n}^{b:.2f}' if n in self.space.numeric else f'{math.exp(b):.2f}[{n}]'
+                             for n, b in zip(self.space.names, c[1:]))
+            print(f"  {program} {metric} = {math.exp(c[0]):.3g} * {terms}")
+
+
+def load_history(path):
+    history = []
+    if not os.path.exists(path):
+        return history
+    with open(path) as f:
+        for row in csv.DictReader(f):
+            options = dict(o[2:].split('=', 1) for o in row['options'].split() if o.startswith('--'))
+            history.append({'program': row['program'], 'options': options,
+                            'wallS': float(row['wallS'] or 0), 'peakRssMb': float(row['peakRssMb'] or 0)})
+    return history
+
+
+def append_history(path, records):
+    new_file = not os.path.exists(path)
+    with open(path, 'a', newline='') as f:
+        writer = csv.DictWriter(f, fieldnames=HISTORY_FIELDS)
+        if new_file:
+            writer.writeheader()
+        for record in records:
+            writer.writerow({'program': record['program'], 'options': format_options(record['options']),
+                             'wallS': record['wallS'], 'peakRssMb': record['peakRssMb']})
+
+
+def lpt_makespan(costs, cores):
+    """Makespan of a plain LPT assignment, for the predicted schedule."""
+    loads = [0.0] * cores
+    for cost in sorted(costs, reverse=True):
+        loads[loads.index(min(loads))] += cost
+    return max(loads) if loads else 0.0
+
+
+def schedule(jobs, args):
+    """Run jobs longest-first on args.cores workers within the memory budget."""
+    pending = sorted(jobs, key=lambda j: j['predictedS'], reverse=True)
+    running = []
+    finished = []
+    start = time.time()
+    while pending or running:
+        memory_in_use = sum(j['predictedMb'] for j in running)
+        # Longest pending job that fits; an oversized job runs alone rather than never
+        for job in list(pending):
+            if len(running) >= args.cores:
+                break
+            if memory_in_use + job['predictedMb'] <= args.max_memory_mb or not running:
+                pending.remove(job)
+                launch(job, args)
+                job['startS'] = time.time() - start
+                running.append(job)
+                memory_in_use += job['predictedMb']
+        time.sleep(0.2)
+        for job in list(running):
+            if job['process'].poll() is None:
+                continue
+            running.remove(job)
+            job['endS'] = time.time() - start
+            collect(job)
+            finished.append(job)
+            status = f"wall={job['wallS']:.1f}s rss={job['peakRssMb']:.0f}MB" if job['ok'] else 'FAILED'
+            if job['ok'] and job['truncated'] != '0':
+                status += f" TRUNCATED ({job['truncated']} budget)"
+            print(f"  [{len(finished)}/{len(jobs)}] {job['id']} done at {job['endS']:.1f}s "
+                  f"(predicted {job['predictedS']:.1f}s) {status}")
+    return finished, time.time() - start
+
+
+def launch(job, args):
+    os.makedirs(job['dir'], exist_ok=True)
+    budget = ''.join(f' --{name}={value}' for name, value in args.budget.items() if value)
+    command = ['./ns3', 'run', '--no-build', f"--cwd={os.path.abspath(job['dir'])}",
+               f"scratch/{job['program']} {format_options(job['options'])}{budget}"]
+    job['log'] = open(os.path.join(job['dir'], 'stdout.txt'), 'w')
+    job['process'] = subprocess.Popen(command, cwd=args.ns3_dir, stdout=job['log'],
+                                      stderr=subprocess.STDOUT, text=True)
+    print(f"  start {job['id']}: {format_options(job['options'])} "
+          f"(~{job['predictedS']:.1f}s, ~{job['predictedMb']:.0f}MB)")
+
+
+def collect(job):
+    job['log'].close()
+    with open(os.path.join(job['dir'], 'stdout.txt')) as f:
+        match = BENCH_RE.search(f.read())
+    job['ok'] = job['process'].returncode == 0 and match is not None
+    bench = dict(field.split('=', 1) for field in match.group(1).split()) if match else {}
+    job['wallS'] = float(bench.get('wallS', job['endS'] - job['startS']))
+    job['peakRssMb'] = float(bench.get('peakRssMb', 0))
+    job['truncated'] = bench.get('truncated', '0')
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Parameter sweep with cost-model-driven LPT scheduling')
+    parser.add_argument('--ns3-dir', default='.', help='ns-3 root holding the ./ns3 script and scratch/')
+    parser.add_argument('--program', default='handover-mobility-analysis', help='Scenario program to sweep')
+    parser.add_argument('--grid', action='append', default=[], metavar='NAME=V1,V2,...',
+                        help='Parameter grid (repeatable), e.g. --grid numUes=5,10,50 --grid simTime=30,180')
+    parser.add_argument('--cores', type=int, default=os.cpu_count() or 1, help='Concurrent runs')
+    parser.add_argument('--max-memory-mb', type=float, default=0,
+                        help='Memory budget for concurrent runs (0: 80%% of physical memory)')
+    parser.add_argument('--max-wall-seconds', type=float, default=0, help='Per-run wall-clock budget (0: none)')
+    parser.add_argument('--max-rss-mb', type=float, default=0, help='Per-run peak RSS budget (0: none)')
+    parser.add_argument('--max-trace-bytes', type=int, default=0, help='Per-run trace size budget (0: none)')
+    parser.add_argument('--history', default='sweep_history.csv', help='Cost history used to fit the model')
+    parser.add_argument('--output-dir', default='sweep_runs', help='Per-run working directories')
+    parser.add_argument('--results', default='sweep_results.csv', help='Per-run predicted vs measured cost')
+    parser.add_argument('--dry-run', action='store_true', help='Only print the predicted schedule')
+    args = parser.parse_args()
+    args.budget = {'maxWallSeconds': args.max_wall_seconds, 'maxRssMb': args.max_rss_mb,
+                   'maxTraceBytes': args.max_trace_bytes}
+
+    if not args.grid:
+        print("No --grid given, nothing to sweep")
+        sys.exit(1)
+    if args.max_memory_mb <= 0:
+        try:
+            pages = os.sysconf('SC_PHYS_PAGES') * os.sysconf('SC_PAGE_SIZE')
+            args.max_memory_mb = 0.8 * pages / (1024 * 1024)
+        except (ValueError, OSError):
+            args.max_memory_mb = float('inf')
+
+    grid = parse_grid(args.grid)
+    history = load_history(args.history)
+    model = CostModel(history, FeatureSpace(args.grid))
+    print(f"Cost model from {len(history)} previous runs in {args.history}:")
+    model.describe()
+
+    jobs = []
+    for index, options in enumerate(grid):
+        jobs.append({'id': f'run{index:03d}', 'program': args.program, 'options': options,
+                     'dir': os.path.join(args.output_dir, f'run{index:03d}'),
+                     'predictedS': model.predict(args.program, options, 'wallS', 1.0),
+                     'predictedMb': model.predict(args.program, options, 'peakRssMb', DEFAULT_MEMORY_MB)})
+
+    costs = [j['predictedS'] for j in jobs]
+    lower_bound = max(sum(costs) / args.cores, max(costs))
+    print(f"\n{len(jobs)} runs on {args.cores} cores, memory budget {args.max_memory_mb:.0f}MB")
+    print(f"Predicted total {sum(costs):.1f}s, LPT makespan {lpt_makespan(costs, args.cores):.1f}s, "
+          f"lower bound {lower_bound:.1f}s")
+    if args.dry_run:
+        for job in sorted(jobs, key=lambda j: j['predictedS'], reverse=True):
+            print(f"  {job['id']}: {format_options(job['options'])} "
+                  f"~{job['predictedS']:.1f}s ~{job['predictedMb']:.0f}MB")
+        return
+
+    if subprocess.run(['./ns3', 'build'], cwd=args.ns3_dir).returncode != 0:
+        print("Build failed")
+        sys.exit(1)
+
+    finished, makespan = schedule(jobs, args)
+    measured = [j['wallS'] for j in finished if j['ok']]
+    if measured:
+        bound = max(sum(measured) / args.cores, max(measured))
+        print(f"\nMakespan {makespan:.1f}s, lower bound from measured costs {bound:.1f}s "
+              f"({makespan / bound:.2f}x)")
+        errors = [abs(math.log(j['wallS'] / j['predictedS'])) for j in finished
+                  if j['ok'] and j['wallS'] > 0 and j['predictedS'] > 0]
+        if errors:
+            print(f"Median prediction error factor {math.exp(sorted(errors)[len(errors) // 2]):.2f}x")
+
+    with open(args.results, 'w', newline='') as f:
+        writer = csv.writer(f)
+        writer.writerow(['id', 'options', 'predictedS', 'wallS', 'predictedMb', 'peakRssMb',
+                         'startS', 'endS', 'ok', 'truncated'])
+        for job in sorted(finished, key=lambda j: j['id']):
+            writer.writerow([job['id'], format_options(job['options']), f"{job['predictedS']:.3f}",
+                             job['wallS'], f"{job['predictedMb']:.1f}", job['peakRssMb'],
+                             f"{job['startS']:.2f}", f"{job['endS']:.2f}", int(job['ok']), job['truncated']])
+    truncated = [j['id'] for j in finished if j['ok'] and j['truncated'] != '0']
+    if truncated:
+        print(f"Truncated by a budget: {', '.join(truncated)}")
+    # A truncated run's cost is only a lower bound, so it would bias the model
+    append_history(args.history, [j for j in finished if j['ok'] and j['truncated'] == '0'])
+    print(f"Results written to {args.results}, history updated in {args.history}")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,110 @@
+#!/usr/bin/env python3
+"""
+Semantic digest trace diff
+Compares two canonical event traces written with --digestTrace=1
+(handover_digest_trace.txt / comprehensive_digest_trace.txt) and reports the
+earliest event where they diverge, naming the differing fields. RRC records are
+written in chunks, so each event kind is compared as its own stream and the
+divergence with the earliest simulation time is reported.
+"""
+
+import argparse
+import sys
+from collections import defaultdict
+
+# Field names after the kind tag; times are integer nanoseconds
+FIELDS = {
+    'RRC': ['timeNs', 'side', 'event', 'imsi', 'cellId', 'rnti', 'targetCellId'],
+    'MR': ['timeNs', 'imsi', 'cellId', 'rnti', 'measId', 'rsrp', 'rsrq', 'neighbours'],
+    'KPI': ['name', 'value', 'value2', 'value3'],
+}
+
+
+def load(path):
+    """Events grouped by kind, each as (line number, field list)."""
+    streams = defaultdict(list)
+    with open(path) as f:
+        for number, line in enumerate(f, 1):
+            parts = line.rstrip('\n').split(',')
+            streams[parts[0]].append((number, parts[1:]))
+    return streams
+
+
+def event_time(fields, kind):
+    if kind in ('RRC', 'MR') and fields:
+        return int(fields[0])
+    return float('inf')  # KPIs are computed after the run
+
+
+def describe(kind, fields):
+    names = FIELDS.get(kind, [])
+    return ', '.join(f"{names[i] if i < len(names) else 'field' + str(i)}={value}"
+                     for i, value in enumerate(fields))
+
+
+def first_divergence(kind, a, b):
+    """Index of the first differing event of a kind, or None."""
+    for i in range(min(len(a), len(b))):
+        if a[i][1] != b[i][1]:
+            return i
+    if len(a) != len(b):
+        return min(len(a), len(b))
+    return None
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Report the first divergent event between two digest traces')
+    parser.add_argument('reference', help='Trace of the reference (golden) run')
+    parser.add_argument('candidate', help='Trace of the run under test')
+    parser.add_argument('--context', type=int, default=3, help='Matching events to show before the divergence')
+    args = parser.parse_args()
+
+    ref = load(args.reference)
+    cand = load(args.candidate)
+
+    print("Events per kind (reference / candidate):")
+    for kind in sorted(set(ref) | set(cand)):
+        print(f"  {kind}: {len(ref[kind])} / {len(cand[kind])}")
+
+    divergences = []
+    for kind in sorted(set(ref) | set(cand)):
+        index = first_divergence(kind, ref[kind], cand[kind])
+        if index is None:
+            continue
+        times = [event_time(stream[kind][index][1], kind)
+                 for stream in (ref, cand) if index < len(stream[kind])]
+        divergences.append((min(times), kind, index))
+
+    if not divergences:
+        print("\nTraces are identical")
+        return
+
+    time_ns, kind, index = min(divergences)
+    when = f"t={time_ns * 1e-9:.6f}s" if time_ns != float('inf') else "KPI summary"
+    print(f"\nFirst divergence: {kind} event #{index + 1} ({when})")
+    for i in range(max(0, index - args.context), index):
+        print(f"  same       line {ref[kind][i][0]}: {describe(kind, ref[kind][i][1])}")
+    for label, stream in (('reference', ref), ('candidate', cand)):
+        if index < len(stream[kind]):
+            number, fields = stream[kind][index]
+            print(f"  {label:<10} line {number}: {describe(kind, fields)}")
+        else:
+            print(f"  {label:<10} (stream ends after {len(stream[kind])} {kind} events)")
+
+    if index < len(ref[kind]) and index < len(cand[kind]):
+        a, b = ref[kind][index][1], cand[kind][index][1]
+        names = FIELDS.get(kind, [])
+        changed = [names[i] if i < len(names) else 'field' + str(i)
+                   for i in range(max(len(a), len(b)))
+                   if i >= len(a) or i >= len(b) or a[i] != b[i]]
+        print(f"  differing fields: {', '.join(changed)}")
+
+    others = sorted(d for d in divergences if d[1] != kind)
+    for other_time, other_kind, other_index in others:
+        when = f"t={other_time * 1e-9:.6f}s" if other_time != float('inf') else "KPI summary"
+        print(f"Also diverges: {other_kind} event #{other_index + 1} ({when})")
+    sys.exit(1)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,95 @@
+#!/usr/bin/env python3
+"""
+Rogue-cell detector training script
+Fits a logistic regression on the feature vectors exported by
+comprehensive-handover-analysis (--enableFeatureExport=1) and writes a model
+file that the simulation can score in closed loop (--detectorModel=<file>).
+"""
+
+import argparse
+import json
+import numpy as np
+from pathlib import Path
+
+
+def load_features(schema_path):
+    """Memory-map the feature records described by the JSON schema."""
+    schema_path = Path(schema_path)
+    with open(schema_path) as f:
+        schema = json.load(f)
+    dtype = np.dtype([(field['name'], field['dtype'], tuple(field.get('shape', ())))
+                      for field in schema['fields']])
+    records = np.memmap(schema_path.parent / schema['file'], dtype=dtype, mode='r')
+    return schema, records
+
+
+def train_logistic_regression(X, y, epochs, learning_rate, l2):
+    """Batch gradient descent on standardized features."""
+    mean = X.mean(axis=0)
+    scale = X.std(axis=0)
+    scale[scale == 0] = 1.0
+    Z = (X - mean) / scale
+
+    weights = np.zeros(X.shape[1])
+    bias = 0.0
+    # Weight the rare FAKE class up so it is not ignored
+    pos = max(y.sum(), 1)
+    neg = max(len(y) - y.sum(), 1)
+    sample_weight = np.where(y == 1, len(y) / (2.0 * pos), len(y) / (2.0 * neg))
+
+    for _ in range(epochs):
+        p = 1.0 / (1.0 + np.exp(-(Z @ weights + bias)))
+        err = (p - y) * sample_weight
+        weights -= learning_rate * (Z.T @ err / len(y) + l2 * weights)
+        bias -= learning_rate * err.mean()
+    return mean, scale, weights, bias
+
+
+def write_model(path, mean, scale, weights, bias, threshold, feature_names):
+    fmt = lambda values: ' '.join(f'{v:.8g}' for v in values)
+    with open(path, 'w') as f:
+        f.write('# Logistic regression rogue-cell detector\n')
+        f.write('# features: ' + ' '.join(feature_names) + '\n')
+        f.write('logreg\n')
+        f.write(f'threshold {threshold}\n')
+        f.write(f'mean {fmt(mean)}\n')
+        f.write(f'scale {fmt(scale)}\n')
+        f.write(f'weights {fmt(weights)}\n')
+        f.write(f'bias {bias:.8g}\n')
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Train the in-simulation rogue-cell detector')
+    parser.add_argument('--schema', default='comprehensive_features.schema.json',
+                        help='Feature schema written by the simulation')
+    parser.add_argument('--output', default='detector_model.txt', help='Model file to write')
+    parser.add_argument('--epochs', type=int, default=2000)
+    parser.add_argument('--learning-rate', type=float, default=0.1)
+    parser.add_argument('--l2', type=float, default=1e-3)
+    parser.add_argument('--threshold', type=float, default=0.5)
+    args = parser.parse_args()
+
+    schema, records = load_features(args.schema)
+    X = np.asarray(records['features'], dtype=np.float64)
+    y = (np.asarray(records['label']) == 2).astype(np.float64)  # FAKE candidate
+    print(f"Loaded {len(X)} feature windows, {int(y.sum())} with a FAKE candidate")
+    if len(X) == 0:
+        print("No feature windows to train on")
+        return
+
+    mean, scale, weights, bias = train_logistic_regression(X, y, args.epochs, args.learning_rate, args.l2)
+
+    p = 1.0 / (1.0 + np.exp(-(((X - mean) / scale) @ weights + bias)))
+    pred = p >= args.threshold
+    tp = int(np.sum(pred & (y == 1)))
+    fp = int(np.sum(pred & (y == 0)))
+    fn = int(np.sum(~pred & (y == 1)))
+    print(f"Training set: TP={tp} FP={fp} FN={fn} "
+          f"precision={tp / max(tp + fp, 1):.3f} recall={tp / max(tp + fn, 1):.3f}")
+
+    write_model(args.output, mean, scale, weights, bias, args.threshold, schema['features'])
+    print(f"Model written to {args.output}")
+
+
+if __name__ == "__main__":
+    main()